@@ -0,0 +1,243 @@
+// coding: utf-8
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/communication.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+/*
+ * Counts the heap allocations needed per message in steady state.
+ *
+ * Every round a local component publishes an event, calls an action of a
+ * second local component which answers directly, and calls an action of a
+ * remote component. The acknowledge and response of the remote component
+ * are fed back through the backend.
+ */
+
+static std::size_t allocations = 0;
+
+void *
+operator new(std::size_t size)
+{
+	allocations++;
+	void *ptr = std::malloc(size ? size : 1);
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void *
+operator new[](std::size_t size)
+{
+	return ::operator new(size);
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void
+operator delete[](void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+// ----------------------------------------------------------------------------
+/// Backend with a fixed size receive ring, so it does not allocate itself
+class LoopBackend : public xpcc::BackendInterface
+{
+public:
+	virtual void
+	update() override
+	{
+	}
+
+	virtual void
+	sendPacket(const xpcc::Header &header, xpcc::SmartPointer payload) override
+	{
+		(void) header;
+		(void) payload;
+		sent++;
+	}
+
+	virtual bool
+	isPacketAvailable() const override
+	{
+		return (head != tail);
+	}
+
+	virtual const xpcc::Header&
+	getPacketHeader() const override
+	{
+		return headers[tail];
+	}
+
+	virtual const xpcc::SmartPointer
+	getPacketPayload() const override
+	{
+		return payloads[tail];
+	}
+
+	virtual void
+	dropPacket() override
+	{
+		payloads[tail] = xpcc::SmartPointer();
+		tail = (tail + 1) % size;
+	}
+
+	void
+	receive(const xpcc::Header& header, const xpcc::SmartPointer& payload)
+	{
+		headers[head] = header;
+		payloads[head] = payload;
+		head = (head + 1) % size;
+	}
+
+	static constexpr std::size_t size = 16;
+
+	xpcc::Header headers[size];
+	xpcc::SmartPointer payloads[size];
+	std::size_t head = 0;
+	std::size_t tail = 0;
+	std::size_t sent = 0;
+};
+
+class Receiver : public xpcc::AbstractComponent
+{
+public:
+	Receiver(xpcc::Dispatcher &dispatcher) :
+		xpcc::AbstractComponent(id, dispatcher)
+	{
+	}
+
+	void
+	action(const xpcc::ResponseHandle& handle, const uint32_t *value)
+	{
+		this->sendResponse(handle, *value + 1);
+	}
+
+	static constexpr uint8_t id = 2;
+};
+
+class Sender : public xpcc::AbstractComponent
+{
+public:
+	Sender(xpcc::Dispatcher &dispatcher) :
+		xpcc::AbstractComponent(id, dispatcher),
+		callback(this, &Sender::response)
+	{
+	}
+
+	void
+	run(uint32_t value)
+	{
+		this->publishEvent(0x01, value);
+		this->callAction(Receiver::id, 0x10, value, callback);
+		this->callAction(remoteId, 0x11, value, callback);
+	}
+
+	void
+	response(const xpcc::Header&)
+	{
+		responses++;
+	}
+
+	static constexpr uint8_t id = 1;
+	static constexpr uint8_t remoteId = 10;
+
+	xpcc::ResponseCallback callback;
+	std::size_t responses = 0;
+};
+
+class Postman : public xpcc::Postman
+{
+public:
+	virtual DeliverInfo
+	deliverPacket(const xpcc::Header& header, const xpcc::SmartPointer& payload) override
+	{
+		if (header.type == xpcc::Header::Type::REQUEST &&
+				header.destination == Receiver::id)
+		{
+			xpcc::ResponseHandle handle(header);
+			receiver->action(handle, &payload.get<uint32_t>());
+		}
+		return OK;
+	}
+
+	virtual bool
+	isComponentAvailable(uint8_t component) const override
+	{
+		return (component == Sender::id || component == Receiver::id);
+	}
+
+	Receiver *receiver = nullptr;
+};
+
+// ----------------------------------------------------------------------------
+static void
+round(LoopBackend& backend, xpcc::Dispatcher& dispatcher, Sender& sender, uint32_t value)
+{
+	sender.run(value);
+	dispatcher.update();
+
+	uint32_t answer = value;
+	backend.receive(xpcc::Header(xpcc::Header::Type::REQUEST, true,
+			Sender::id, Sender::remoteId, 0x11), xpcc::SmartPointer());
+	backend.receive(xpcc::Header(xpcc::Header::Type::RESPONSE, false,
+			Sender::id, Sender::remoteId, 0x11), xpcc::SmartPointer(&answer));
+	dispatcher.update();
+}
+
+int
+main()
+{
+	LoopBackend backend;
+	Postman postman;
+	xpcc::Dispatcher dispatcher(&backend, &postman);
+	Sender sender(dispatcher);
+	Receiver receiver(dispatcher);
+	postman.receiver = &receiver;
+
+	constexpr uint32_t warmUpRounds = 100;
+	constexpr uint32_t rounds = 100000;
+
+	for (uint32_t i = 0; i < warmUpRounds; ++i) {
+		round(backend, dispatcher, sender, i);
+	}
+
+	const std::size_t sentBefore = backend.sent;
+	allocations = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < rounds; ++i) {
+		round(backend, dispatcher, sender, i);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	const std::size_t measuredAllocations = allocations;
+	const std::size_t messages = backend.sent - sentBefore;
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+	XPCC_LOG_INFO << "Messages sent:           " << messages << xpcc::endl;
+	XPCC_LOG_INFO << "Responses received:      " << sender.responses << xpcc::endl;
+	XPCC_LOG_INFO << "Heap allocations:        " << measuredAllocations << xpcc::endl;
+	XPCC_LOG_INFO << "Allocations per 1000 messages: "
+			<< uint32_t(measuredAllocations * 1000 / messages) << xpcc::endl;
+	XPCC_LOG_INFO << "Time per message:        "
+			<< uint32_t(ns / messages) << " ns" << xpcc::endl;
+
+	return 0;
+}
@@ -0,0 +1,177 @@
+// coding: utf-8
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/communication.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#include <chrono>
+#include <deque>
+
+/*
+ * Measures how fast the dispatcher matches incoming acknowledges and
+ * responses while a growing number of requests is outstanding.
+ *
+ * A local component sends requests to a remote component. The remote side
+ * acknowledges them in reverse order and then answers them, so every
+ * incoming packet refers to a different outstanding request.
+ */
+
+class LoopBackend : public xpcc::BackendInterface
+{
+public:
+	struct Packet
+	{
+		Packet(const xpcc::Header& header, const xpcc::SmartPointer& payload) :
+			header(header), payload(payload)
+		{
+		}
+
+		xpcc::Header header;
+		xpcc::SmartPointer payload;
+	};
+
+	virtual void
+	update() override
+	{
+	}
+
+	virtual void
+	sendPacket(const xpcc::Header &header, xpcc::SmartPointer payload) override
+	{
+		(void) header;
+		(void) payload;
+		sent++;
+	}
+
+	virtual bool
+	isPacketAvailable() const override
+	{
+		return !received.empty();
+	}
+
+	virtual const xpcc::Header&
+	getPacketHeader() const override
+	{
+		return received.front().header;
+	}
+
+	virtual const xpcc::SmartPointer
+	getPacketPayload() const override
+	{
+		return received.front().payload;
+	}
+
+	virtual void
+	dropPacket() override
+	{
+		received.pop_front();
+	}
+
+	std::deque<Packet> received;
+	std::size_t sent = 0;
+};
+
+class NullPostman : public xpcc::Postman
+{
+public:
+	virtual DeliverInfo
+	deliverPacket(const xpcc::Header&, const xpcc::SmartPointer&) override
+	{
+		return OK;
+	}
+
+	virtual bool
+	isComponentAvailable(uint8_t component) const override
+	{
+		return (component == localId);
+	}
+
+	static constexpr uint8_t localId = 1;
+};
+
+class Component : public xpcc::AbstractComponent
+{
+public:
+	Component(xpcc::Dispatcher &dispatcher) :
+		xpcc::AbstractComponent(NullPostman::localId, dispatcher),
+		callback(this, &Component::response)
+	{
+	}
+
+	void
+	request(uint8_t destination, uint8_t identifier)
+	{
+		this->callAction(destination, identifier, callback);
+	}
+
+	void
+	response(const xpcc::Header&)
+	{
+		responses++;
+	}
+
+	xpcc::ResponseCallback callback;
+	std::size_t responses = 0;
+};
+
+static void
+benchmark(std::size_t outstanding)
+{
+	LoopBackend backend;
+	NullPostman postman;
+	xpcc::Dispatcher dispatcher(&backend, &postman);
+	// keep every request, evicted ones would count as responses
+	dispatcher.setMaximumPendingMessages(outstanding);
+	Component component(dispatcher);
+
+	// distribute the requests over all remote components and identifiers
+	for (std::size_t i = 0; i < outstanding; ++i) {
+		component.request(2 + (i / 256) % 250, i % 256);
+	}
+	dispatcher.update();
+
+	for (std::size_t i = outstanding; i > 0; --i)
+	{
+		xpcc::Header header(xpcc::Header::Type::REQUEST, true,
+				NullPostman::localId, 2 + ((i - 1) / 256) % 250, (i - 1) % 256);
+		backend.received.emplace_back(header, xpcc::SmartPointer());
+	}
+	for (std::size_t i = outstanding; i > 0; --i)
+	{
+		xpcc::Header header(xpcc::Header::Type::RESPONSE, false,
+				NullPostman::localId, 2 + ((i - 1) / 256) % 250, (i - 1) % 256);
+		backend.received.emplace_back(header, xpcc::SmartPointer());
+	}
+	const std::size_t packets = backend.received.size();
+
+	auto start = std::chrono::steady_clock::now();
+	dispatcher.update();
+	auto end = std::chrono::steady_clock::now();
+
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+	XPCC_LOG_INFO << outstanding << " outstanding: "
+			<< uint32_t(ns / packets) << " ns/packet, "
+			<< uint32_t(packets * 1000000000ULL / ns) << " packets/s, "
+			<< component.responses << " responses, "
+			<< dispatcher.getStatistics().evictedMessages << " evicted" << xpcc::endl;
+}
+
+int
+main()
+{
+	XPCC_LOG_INFO << "Dispatcher throughput vs. outstanding requests" << xpcc::endl;
+
+	for (std::size_t outstanding : {1, 10, 100, 1000, 10000, 50000}) {
+		benchmark(outstanding);
+	}
+
+	return 0;
+}
@@ -0,0 +1,228 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/container.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+/*
+ * Compares the node based lists with the intrusive lists.
+ *
+ * Queue: a FIFO of messages is filled and drained again, like the send
+ * and receive lists of the CanConnector. The node based lists allocate a
+ * node and copy the message for every append.
+ *
+ * Unlink: messages are removed from the middle of a list of outstanding
+ * messages, like the Dispatcher does for acknowledged messages. The
+ * DoublyLinkedList has to search the message first.
+ */
+
+static std::size_t allocations = 0;
+
+void *
+operator new(std::size_t size)
+{
+	allocations++;
+	void *ptr = std::malloc(size ? size : 1);
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void *
+operator new[](std::size_t size)
+{
+	return ::operator new(size);
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void
+operator delete[](void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+// ----------------------------------------------------------------------------
+struct Message :
+	public xpcc::IntrusiveLinkedListHook<>,
+	public xpcc::IntrusiveDoublyLinkedListHook<>
+{
+	Message(uint32_t identifier = 0) :
+		identifier(identifier)
+	{
+	}
+
+	uint32_t identifier;
+	uint8_t data[16];
+};
+
+static constexpr uint32_t queueLength = 32;
+static constexpr uint32_t queueRounds = 100000;
+
+static constexpr uint32_t pendingMessages = 64;
+static constexpr uint32_t unlinkRounds = 20000;
+
+static Message messages[pendingMessages];
+
+static void
+report(const char *name, std::chrono::steady_clock::time_point start,
+		uint64_t operations, std::size_t allocated)
+{
+	auto end = std::chrono::steady_clock::now();
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+	XPCC_LOG_INFO << name << ": " << uint32_t(ns * 1000 / operations)
+			<< " ns per 1000 operations, " << allocated << " allocations" << xpcc::endl;
+}
+
+// ----------------------------------------------------------------------------
+template <typename List>
+static uint32_t
+queueNodeBased(const char *name)
+{
+	List list;
+	uint32_t checksum = 0;
+
+	allocations = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t round = 0; round < queueRounds; ++round)
+	{
+		for (uint32_t i = 0; i < queueLength; ++i) {
+			list.append(messages[i]);
+		}
+		while (!list.isEmpty()) {
+			checksum += list.getFront().identifier;
+			list.removeFront();
+		}
+	}
+	report(name, start, uint64_t(queueRounds) * queueLength, allocations);
+	return checksum;
+}
+
+static uint32_t
+queueIntrusive(const char *name)
+{
+	xpcc::IntrusiveLinkedList<Message> list;
+	uint32_t checksum = 0;
+
+	allocations = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t round = 0; round < queueRounds; ++round)
+	{
+		for (uint32_t i = 0; i < queueLength; ++i) {
+			list.append(messages[i]);
+		}
+		while (Message *message = list.removeFront()) {
+			checksum += message->identifier;
+		}
+	}
+	report(name, start, uint64_t(queueRounds) * queueLength, allocations);
+	return checksum;
+}
+
+// ----------------------------------------------------------------------------
+// Removes every message once, in an order which hits all positions
+static uint32_t
+getUnlinkIndex(uint32_t i)
+{
+	return (i * 37) % pendingMessages;
+}
+
+static uint32_t
+unlinkNodeBased(const char *name)
+{
+	xpcc::DoublyLinkedList<Message *> list;
+	uint32_t checksum = 0;
+
+	allocations = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t round = 0; round < unlinkRounds; ++round)
+	{
+		for (Message& message : messages) {
+			list.append(&message);
+		}
+		for (uint32_t i = 0; i < pendingMessages; ++i)
+		{
+			Message *message = &messages[getUnlinkIndex(i)];
+			for (auto it = list.begin(); it != list.end(); ++it)
+			{
+				if (*it == message) {
+					checksum += message->identifier;
+					list.erase(it);
+					break;
+				}
+			}
+		}
+	}
+	report(name, start, uint64_t(unlinkRounds) * pendingMessages, allocations);
+	return checksum;
+}
+
+static uint32_t
+unlinkIntrusive(const char *name)
+{
+	xpcc::IntrusiveDoublyLinkedList<Message> list;
+	uint32_t checksum = 0;
+
+	allocations = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t round = 0; round < unlinkRounds; ++round)
+	{
+		for (Message& message : messages) {
+			list.append(message);
+		}
+		for (uint32_t i = 0; i < pendingMessages; ++i)
+		{
+			Message& message = messages[getUnlinkIndex(i)];
+			checksum += message.identifier;
+			list.remove(message);
+		}
+	}
+	report(name, start, uint64_t(unlinkRounds) * pendingMessages, allocations);
+	return checksum;
+}
+
+// ----------------------------------------------------------------------------
+int
+main()
+{
+	for (uint32_t i = 0; i < pendingMessages; ++i) {
+		messages[i].identifier = i;
+	}
+
+	uint32_t checksum = 0;
+
+	XPCC_LOG_INFO << "Queue of " << queueLength << " messages:" << xpcc::endl;
+	checksum += queueNodeBased< xpcc::LinkedList<Message> >(
+			"LinkedList");
+	checksum += queueNodeBased< xpcc::LinkedList<Message,
+			xpcc::allocator::Block<Message, 32> > >(
+			"LinkedList with Block allocator");
+	checksum += queueIntrusive("IntrusiveLinkedList");
+
+	XPCC_LOG_INFO << xpcc::endl << "Unlink from " << pendingMessages
+			<< " pending messages:" << xpcc::endl;
+	checksum += unlinkNodeBased("DoublyLinkedList (search + erase)");
+	checksum += unlinkIntrusive("IntrusiveDoublyLinkedList");
+
+	// keeps the compiler from removing the loops
+	XPCC_LOG_INFO << xpcc::endl << "Checksum: " << checksum << xpcc::endl;
+
+	return 0;
+}
@@ -0,0 +1,167 @@
+// coding: utf-8
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/communication.hpp>
+#include <xpcc/communication/xpcc/postman/dynamic_postman.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <vector>
+
+/*
+ * Compares the time needed to deliver packets with the table based
+ * DynamicPostman against a postman looking up std::function handlers in
+ * nested std::map and std::multimap containers.
+ */
+
+/// Postman with the lookup structure formerly used by the DynamicPostman
+class MapPostman : public xpcc::Postman
+{
+public:
+	virtual DeliverInfo
+	deliverPacket(const xpcc::Header& header, const xpcc::SmartPointer& payload) override
+	{
+		if (header.destination == 0)
+		{
+			auto range = events.equal_range(header.packetIdentifier);
+			if (range.first == range.second) {
+				return NO_EVENT;
+			}
+			for (auto it = range.first; it != range.second; ++it) {
+				it->second(header, *payload.getPointer());
+			}
+			return OK;
+		}
+
+		auto component = actions.find(header.destination);
+		if (component == actions.end()) {
+			return NO_COMPONENT;
+		}
+		auto action = component->second.find(header.packetIdentifier);
+		if (action == component->second.end()) {
+			return NO_ACTION;
+		}
+		xpcc::ResponseHandle response(header);
+		action->second(response, *payload.getPointer());
+		return OK;
+	}
+
+	virtual bool
+	isComponentAvailable(uint8_t component) const override
+	{
+		return (actions.find(component) != actions.end());
+	}
+
+	typedef std::function<void (const xpcc::Header&, const uint8_t&)> EventCallback;
+	typedef std::function<void (const xpcc::ResponseHandle&, const uint8_t&)> ActionCallback;
+
+	std::multimap<uint8_t, EventCallback> events;
+	std::map<uint8_t, std::map<uint8_t, ActionCallback> > actions;
+};
+
+class Component : public xpcc::Communicatable
+{
+public:
+	void
+	action(const xpcc::ResponseHandle&, const uint32_t& value)
+	{
+		sum += value;
+	}
+
+	void
+	event(const xpcc::Header&, const uint32_t& value)
+	{
+		sum += value;
+	}
+
+	uint32_t sum = 0;
+};
+
+static constexpr uint8_t components = 20;
+static constexpr uint8_t identifiers = 50;
+
+static std::vector<xpcc::Header>
+createPackets()
+{
+	std::vector<xpcc::Header> headers;
+	for (uint32_t i = 0; i < 100000; ++i)
+	{
+		// mostly actions, every fourth packet is an event
+		uint8_t destination = (i % 4 == 0) ? 0 : 1 + (i * 7) % components;
+		headers.emplace_back(xpcc::Header::Type::REQUEST, false,
+				destination, 200, (i * 13) % identifiers);
+	}
+	return headers;
+}
+
+template< typename P >
+static void
+benchmark(const char *name, P& postman, Component& component)
+{
+	const std::vector<xpcc::Header> headers = createPackets();
+	uint32_t value = 1;
+	xpcc::SmartPointer payload(&value);
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint8_t round = 0; round < 10; ++round)
+	{
+		for (const xpcc::Header& header : headers) {
+			postman.deliverPacket(header, payload);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	const uint32_t packets = headers.size() * 10;
+	XPCC_LOG_INFO << name << ": "
+			<< uint32_t(ns / packets) << "." << uint32_t(ns * 10 / packets % 10)
+			<< " ns/packet (" << component.sum << " calls)" << xpcc::endl;
+}
+
+int
+main()
+{
+	using namespace std::placeholders;
+
+	Component mapComponent;
+	MapPostman mapPostman;
+	for (uint8_t id = 0; id < identifiers; ++id)
+	{
+		mapPostman.events.emplace(id, std::bind(
+				reinterpret_cast<void (Component::*)(const xpcc::Header&, const uint8_t&)>(&Component::event),
+				&mapComponent, _1, _2));
+		for (uint8_t component = 1; component <= components; ++component)
+		{
+			mapPostman.actions[component][id] = std::bind(
+					reinterpret_cast<void (Component::*)(const xpcc::ResponseHandle&, const uint8_t&)>(&Component::action),
+					&mapComponent, _1, _2);
+		}
+	}
+
+	Component tableComponent;
+	xpcc::DynamicPostman tablePostman;
+	for (uint8_t id = 0; id < identifiers; ++id)
+	{
+		tablePostman.registerEventListener(id, &tableComponent, &Component::event);
+		for (uint8_t component = 1; component <= components; ++component) {
+			tablePostman.registerActionHandler(component, id, &tableComponent, &Component::action);
+		}
+	}
+
+	XPCC_LOG_INFO << "Postman delivery time, " << components << " components with "
+			<< identifiers << " actions and " << identifiers << " events" << xpcc::endl;
+
+	benchmark("std::map + std::function", mapPostman, mapComponent);
+	benchmark("DynamicPostman          ", tablePostman, tableComponent);
+
+	return 0;
+}
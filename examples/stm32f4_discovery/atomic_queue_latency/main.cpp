@@ -0,0 +1,169 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/architecture/platform.hpp>
+#include <xpcc/architecture/driver/atomic.hpp>
+#include <xpcc/debug/logger.hpp>
+
+/*
+ * Measures the interrupt latency caused by a queue with two producers.
+ *
+ * Timer2 triggers an interrupt with 10 kHz, which pushes a sample into
+ * the queue. The main loop pushes samples into the same queue, too, and
+ * drains it again.
+ *
+ * - Locked: xpcc::atomic::Queue, the main loop has to wrap every push in
+ *   an atomic::Lock, so the interrupt is delayed until the copy finished.
+ * - Lock-free: xpcc::atomic::ConcurrentQueue, the main loop pushes a
+ *   batch of samples without disabling interrupts.
+ *
+ * The latency is the value of the timer counter at the start of the
+ * interrupt, i.e. the time since the update event in timer ticks
+ * (84 MHz). The results are printed with 115200 baud on PA2.
+ */
+
+xpcc::IODeviceWrapper< Usart2, xpcc::IOBuffer::BlockIfFull > loggerDevice;
+xpcc::log::Logger xpcc::log::info(loggerDevice);
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+// ----------------------------------------------------------------------------
+struct Sample
+{
+	uint32_t timestamp;
+	uint8_t data[28];
+};
+
+static constexpr uint32_t batchSize = 8;
+static constexpr uint32_t interruptsPerRun = 20000;
+
+static xpcc::atomic::Queue<Sample, 63> lockedQueue;
+static xpcc::atomic::ConcurrentQueue<Sample, 64> concurrentQueue;
+
+static volatile bool useLockedQueue = true;
+static volatile uint32_t interrupts = 0;
+static volatile uint32_t maximumLatency = 0;
+static volatile uint32_t latencySum = 0;
+static volatile uint32_t samplesDropped = 0;
+
+XPCC_ISR(TIM2)
+{
+	const uint32_t latency = Timer2::getValue();
+	Timer2::acknowledgeInterruptFlags(Timer2::InterruptFlag::Update);
+
+	if (latency > maximumLatency) {
+		maximumLatency = latency;
+	}
+	latencySum += latency;
+	interrupts++;
+
+	Sample sample;
+	sample.timestamp = latency;
+
+	// the interrupt is the only producer which can't be interrupted by
+	// the other one, so it doesn't need a lock for the locked queue
+	bool pushed = useLockedQueue ?
+			lockedQueue.push(sample) : concurrentQueue.push(sample);
+	if (not pushed) {
+		samplesDropped++;
+	}
+}
+
+// ----------------------------------------------------------------------------
+static uint32_t
+runLocked()
+{
+	uint32_t samples = 0;
+	Sample sample = Sample();
+	while (interrupts < interruptsPerRun)
+	{
+		for (uint32_t i = 0; i < batchSize; ++i)
+		{
+			xpcc::atomic::Lock lock;
+			lockedQueue.push(sample);
+		}
+		while (lockedQueue.isNotEmpty())
+		{
+			sample = lockedQueue.get();
+			lockedQueue.pop();
+			samples++;
+		}
+	}
+	return samples;
+}
+
+static uint32_t
+runLockFree()
+{
+	uint32_t samples = 0;
+	Sample batch[batchSize] = {};
+	while (interrupts < interruptsPerRun)
+	{
+		concurrentQueue.push(batch, batchSize);
+
+		uint32_t count;
+		while ((count = concurrentQueue.pop(batch, batchSize)) > 0) {
+			samples += count;
+		}
+	}
+	return samples;
+}
+
+static void
+run(const char *name, bool locked)
+{
+	Timer2::pause();
+	useLockedQueue = locked;
+	interrupts = 0;
+	maximumLatency = 0;
+	latencySum = 0;
+	samplesDropped = 0;
+	Timer2::start();
+
+	const uint32_t samples = locked ? runLocked() : runLockFree();
+
+	Timer2::pause();
+	XPCC_LOG_INFO << name << ": maximum latency " << maximumLatency
+			<< " ticks, average " << (latencySum / interrupts)
+			<< " ticks, " << samples << " samples, "
+			<< samplesDropped << " dropped" << xpcc::endl;
+}
+
+// ----------------------------------------------------------------------------
+int
+main()
+{
+	Board::initialize();
+
+	GpioOutputA2::connect(Usart2::Tx);
+	GpioInputA3::connect(Usart2::Rx, Gpio::InputType::PullUp);
+	Usart2::initialize<Board::systemClock, 115200>(10);
+
+	// 84 MHz / 8400 = 10 kHz
+	Timer2::enable();
+	Timer2::setMode(Timer2::Mode::UpCounter);
+	Timer2::setPrescaler(1);
+	Timer2::setOverflow(8400 - 1);
+	Timer2::enableInterruptVector(true, 5);
+	Timer2::enableInterrupt(Timer2::Interrupt::Update);
+	Timer2::applyAndReset();
+
+	XPCC_LOG_INFO << "Interrupt latency with two producers, "
+			<< sizeof(Sample) << " byte samples" << xpcc::endl;
+
+	while (1)
+	{
+		run("atomic::Queue with Lock", true);
+		run("atomic::ConcurrentQueue", false);
+		Board::LedGreen::toggle();
+	}
+
+	return 0;
+}
@@ -63,6 +63,13 @@ main()
 
 	xpcc::ZeroMQConnector zmqConnector(endpointIn, endpointOut, xpcc::ZeroMQConnector::Mode::PubPull);
 
+	// All subscribers of this example understand the compact format
+	zmqConnector.setFraming(xpcc::ZeroMQConnector::Framing::Compact);
+
+	// Publish all packets reassembled in one iteration as a single
+	// multipart message
+	zmqConnector.setCoalescing(true);
+
 	XPCC_LOG_DEBUG << "Entering main loop" << xpcc::endl;
 
 	while(true)
@@ -81,6 +88,7 @@ main()
 
 			canConnector.dropPacket();
 		}
+		zmqConnector.flush();
 
 		while (zmqConnector.isPacketAvailable())
 		{
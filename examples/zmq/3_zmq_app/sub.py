@@ -10,8 +10,9 @@ def subscriber():
 	zmq_socket.setsockopt(zmq.SUBSCRIBE, '')
 
 	while True:
-		string = zmq_socket.recv()
-		print('Subscriber received: >>%s<<' % string.encode("hex"))
+		# several packets may be published as one multipart message
+		for string in zmq_socket.recv_multipart():
+			print('Subscriber received: >>%s<<' % string.encode("hex"))
 
 if __name__ == "__main__":
 	subscriber()
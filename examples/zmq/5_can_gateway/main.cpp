@@ -0,0 +1,73 @@
+
+#include <cstdlib>
+
+#include <xpcc/debug/logger.hpp>
+#include <xpcc/architecture.hpp>
+
+#include <xpcc/architecture/platform/driver/can/socketcan/socketcan.hpp>
+
+#include <xpcc/communication.hpp>
+#include <xpcc/communication/xpcc/backend/can/connector.hpp>
+#include <xpcc/communication/xpcc/backend/zeromq/connector.hpp>
+#include <xpcc/communication/xpcc/backend/gateway/gateway.hpp>
+
+/**
+ * Bridges two SocketCAN interfaces and a ZeroMQ link on one epoll loop.
+ *
+ * How to use:
+ * - Set the bitrate and bring up the interfaces
+ *   $ ip link set can0 type can bitrate 125000
+ *   $ ip link set can0 up
+ *   (same for can1)
+ * - Do
+ *   scons run
+ * - All xpcc messages from both busses will be published on port 8211 by
+ *   zeromq, messages pushed to port 8212 are sent to both busses.
+ *   Messages are forwarded between the busses as well.
+ */
+
+static xpcc::hosted::SocketCan can0;
+static xpcc::hosted::SocketCan can1;
+
+static xpcc::CanConnector< xpcc::hosted::SocketCan > canConnector0(&can0);
+static xpcc::CanConnector< xpcc::hosted::SocketCan > canConnector1(&can1);
+
+#undef XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::DEBUG
+
+int
+main()
+{
+	XPCC_LOG_DEBUG << "SocketCAN ZeroMQ XPCC gateway" << xpcc::endl;
+
+	if (not can0.open("can0") or not can1.open("can1")) {
+		XPCC_LOG_ERROR << "Could not open interfaces" << xpcc::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	const std::string endpointOut = "tcp://*:8211";
+	const std::string endpointIn  = "tcp://*:8212";
+
+	xpcc::ZeroMQConnector zmqConnector(endpointIn, endpointOut, xpcc::ZeroMQConnector::Mode::PubPull);
+	zmqConnector.setCoalescing(true);
+
+	xpcc::Gateway gateway;
+	gateway.addInterface(canConnector0, can0.getFileDescriptor());
+	uint8_t bus1 = gateway.addInterface(canConnector1, can1.getFileDescriptor());
+	uint8_t zmq = gateway.addInterface(zmqConnector, zmqConnector.getFileDescriptor());
+
+	// Component 0x10 is only connected to can1, don't bother can0 with it.
+	// Remote PCs may still listen via ZeroMQ.
+	gateway.addRoute(0x10, bus1);
+	gateway.addRoute(0x10, zmq);
+
+	XPCC_LOG_DEBUG << "Entering main loop" << xpcc::endl;
+
+	while (true)
+	{
+		gateway.run(100);
+	}
+
+	can0.close();
+	can1.close();
+}
@@ -47,3 +47,4 @@ namespace xpcc
 #include "atomic/flag.hpp"
 #include "atomic/container.hpp"
 #include "atomic/queue.hpp"
+#include "atomic/concurrent_queue.hpp"
@@ -0,0 +1,206 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC_ATOMIC__CONCURRENT_QUEUE_HPP
+#define	XPCC_ATOMIC__CONCURRENT_QUEUE_HPP
+
+#include <cstddef>
+#include <stdint.h>
+#include <xpcc/architecture/detect.hpp>
+#include <xpcc/architecture/utils.hpp>
+
+#include "lock.hpp"
+
+#if defined(XPCC__OS_HOSTED)
+#	include <atomic>
+#endif
+
+namespace xpcc
+{
+	namespace atomic
+	{
+		/**
+		 * \ingroup	atomic
+		 * \brief	Lock-free queue for several producers and consumers
+		 *
+		 * xpcc::atomic::Queue is only safe for a single producer and a
+		 * single consumer. When several interrupts push into the same
+		 * queue, every push has to be wrapped in an atomic::Lock, which
+		 * delays all other interrupts for the duration of the copy.
+		 *
+		 * This queue can be used from any number of interrupts and the
+		 * main loop (or threads on hosted targets) at the same time,
+		 * without disabling interrupts. Every slot carries a sequence
+		 * number, producers and consumers reserve slots by advancing the
+		 * write or read position with a compare-and-swap:
+		 *
+		 * - Cortex-M3/M4/M7: LDREX/STREX
+		 * - Hosted: std::atomic
+		 * - Other targets (Cortex-M0, AVR): the compare-and-swap itself
+		 *   runs in a short atomic::Lock, the copy of the element does not.
+		 *
+		 * Several elements can be pushed or popped with a single
+		 * compare-and-swap:
+		 *
+		 * \code
+		 * xpcc::atomic::ConcurrentQueue<uint8_t, 64> queue;
+		 *
+		 * XPCC_ISR(USART1) {
+		 *     queue.push(USART1->DR);
+		 * }
+		 *
+		 * XPCC_ISR(DMA2_Stream2) {
+		 *     queue.push(dmaBuffer, dmaLength);
+		 * }
+		 *
+		 * void
+		 * process() {
+		 *     uint8_t data[16];
+		 *     std::size_t length = queue.pop(data, sizeof(data));
+		 *     ...
+		 * }
+		 * \endcode
+		 *
+		 * A slot only becomes visible to the consumers after its producer
+		 * finished copying. If a producer is interrupted in between, the
+		 * consumers see the queue as empty at this slot until the producer
+		 * continues, even if later slots are already filled. Elements are
+		 * never reordered.
+		 *
+		 * \tparam	T	Type of the elements, must be default constructible
+		 * 				and copy assignable
+		 * \tparam	N	Number of elements, must be a power of two
+		 */
+		template<typename T,
+				 std::size_t N>
+		class ConcurrentQueue
+		{
+		public:
+#if defined(XPCC__CPU_AVR)
+			typedef uint16_t Index;
+			typedef int16_t SignedIndex;
+#else
+			typedef uint32_t Index;
+			typedef int32_t SignedIndex;
+#endif
+			typedef std::size_t Size;
+
+		public:
+			ConcurrentQueue();
+
+			ConcurrentQueue(const ConcurrentQueue&) = delete;
+
+			ConcurrentQueue&
+			operator = (const ConcurrentQueue&) = delete;
+
+			/**
+			 * \brief	Append an element
+			 *
+			 * Safe to call from several interrupts and threads.
+			 *
+			 * \return	\c false if the queue was full
+			 */
+			bool
+			push(const T& value);
+
+			/**
+			 * \brief	Append up to \p count elements at once
+			 *
+			 * The elements are stored in consecutive slots, elements of
+			 * other producers are not interleaved.
+			 *
+			 * \return	Number of appended elements, less than \p count
+			 * 			if the queue was full
+			 */
+			Size
+			push(const T* values, Size count);
+
+			/**
+			 * \brief	Remove the oldest element
+			 *
+			 * Safe to call from several interrupts and threads.
+			 *
+			 * \return	\c false if the queue was empty
+			 */
+			bool
+			pop(T& value);
+
+			/**
+			 * \brief	Remove up to \p count of the oldest elements at once
+			 *
+			 * \return	Number of removed elements
+			 */
+			Size
+			pop(T* values, Size count);
+
+			/**
+			 * \brief	Check if no element is stored
+			 *
+			 * Only a snapshot if other producers or consumers are active.
+			 */
+			bool
+			isEmpty() const;
+
+			/// Only a snapshot if other producers or consumers are active
+			bool
+			isFull() const;
+
+			/// Number of elements, only a snapshot
+			Size
+			getSize() const;
+
+			static constexpr Size
+			getMaxSize()
+			{
+				return N;
+			}
+
+		private:
+			static constexpr Index mask = N - 1;
+
+#if defined(XPCC__OS_HOSTED)
+			typedef std::atomic<Index> AtomicIndex;
+#else
+			typedef Index AtomicIndex;
+#endif
+
+			static xpcc_always_inline Index
+			load(const AtomicIndex& index);
+
+			static xpcc_always_inline void
+			store(AtomicIndex& index, Index value);
+
+			/**
+			 * Set \p index to \p desired if it still contains
+			 * \p expected. Otherwise \p expected is updated to the
+			 * current value.
+			 */
+			static xpcc_always_inline bool
+			compareAndSwap(AtomicIndex& index, Index& expected, Index desired);
+
+			struct Cell
+			{
+				AtomicIndex sequence;
+				T data;
+			};
+
+			// Producers and consumers are reserving slots by advancing
+			// these positions. They are never reduced modulo N, the cell
+			// of a position is (position & mask).
+			AtomicIndex writePosition;
+			AtomicIndex readPosition;
+
+			Cell cells[N];
+		};
+	}
+}
+
+#include "concurrent_queue_impl.hpp"
+
+#endif	// XPCC_ATOMIC__CONCURRENT_QUEUE_HPP
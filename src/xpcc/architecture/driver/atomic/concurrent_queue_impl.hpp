@@ -0,0 +1,295 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC_ATOMIC__CONCURRENT_QUEUE_HPP
+	#error	"Don't include this file directly, use 'concurrent_queue.hpp' instead"
+#endif
+
+// ----------------------------------------------------------------------------
+template<typename T, std::size_t N>
+xpcc::atomic::ConcurrentQueue<T, N>::ConcurrentQueue() :
+	writePosition(0), readPosition(0)
+{
+	static_assert(N > 0 and (N & (N - 1)) == 0, "N must be a power of two!");
+	static_assert(N <= (Index(-1) >> 2), "N is too big for the index type!");
+
+	// A cell is free for the producer of position p if its sequence is p
+	for (Index i = 0; i < N; ++i) {
+		store(this->cells[i].sequence, i);
+	}
+}
+
+// ----------------------------------------------------------------------------
+template<typename T, std::size_t N>
+bool
+xpcc::atomic::ConcurrentQueue<T, N>::push(const T& value)
+{
+	return (this->push(&value, 1) == 1);
+}
+
+template<typename T, std::size_t N>
+typename xpcc::atomic::ConcurrentQueue<T, N>::Size
+xpcc::atomic::ConcurrentQueue<T, N>::push(const T* values, Size count)
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	Index position = load(this->writePosition);
+	Size available;
+	while (true)
+	{
+		// Count the free cells behind the write position. They can only
+		// be taken by other producers, which have to advance the write
+		// position first, so the compare-and-swap below fails if any of
+		// them was taken in the meantime.
+		available = 0;
+		SignedIndex difference = 0;
+		while (available < count)
+		{
+			const Index current = position + available;
+			difference = SignedIndex(Index(
+					load(this->cells[current & mask].sequence) - current));
+			if (difference != 0) {
+				break;
+			}
+			available++;
+		}
+
+		if (available == 0)
+		{
+			if (difference < 0) {
+				// the oldest element was not popped yet
+				return 0;
+			}
+			// another producer was faster
+			position = load(this->writePosition);
+		}
+		else if (compareAndSwap(this->writePosition, position, position + available)) {
+			break;
+		}
+	}
+
+	for (Size i = 0; i < available; ++i)
+	{
+		const Index current = position + i;
+		Cell& cell = this->cells[current & mask];
+		cell.data = values[i];
+		// publish the element to the consumers
+		store(cell.sequence, current + 1);
+	}
+	return available;
+}
+
+// ----------------------------------------------------------------------------
+template<typename T, std::size_t N>
+bool
+xpcc::atomic::ConcurrentQueue<T, N>::pop(T& value)
+{
+	return (this->pop(&value, 1) == 1);
+}
+
+template<typename T, std::size_t N>
+typename xpcc::atomic::ConcurrentQueue<T, N>::Size
+xpcc::atomic::ConcurrentQueue<T, N>::pop(T* values, Size count)
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	Index position = load(this->readPosition);
+	Size available;
+	while (true)
+	{
+		// A cell contains an element for the consumer of position p
+		// if its sequence is p + 1
+		available = 0;
+		SignedIndex difference = 0;
+		while (available < count)
+		{
+			const Index current = position + available;
+			difference = SignedIndex(Index(
+					load(this->cells[current & mask].sequence) - (current + 1)));
+			if (difference != 0) {
+				break;
+			}
+			available++;
+		}
+
+		if (available == 0)
+		{
+			if (difference < 0) {
+				// empty, or the producer of the oldest element is
+				// still copying it
+				return 0;
+			}
+			// another consumer was faster
+			position = load(this->readPosition);
+		}
+		else if (compareAndSwap(this->readPosition, position, position + available)) {
+			break;
+		}
+	}
+
+	for (Size i = 0; i < available; ++i)
+	{
+		const Index current = position + i;
+		Cell& cell = this->cells[current & mask];
+		values[i] = cell.data;
+		// free the cell for the producer one round later
+		store(cell.sequence, Index(current + N));
+	}
+	return available;
+}
+
+// ----------------------------------------------------------------------------
+template<typename T, std::size_t N>
+bool
+xpcc::atomic::ConcurrentQueue<T, N>::isEmpty() const
+{
+	const Index position = load(this->readPosition);
+	return (load(this->cells[position & mask].sequence) != Index(position + 1));
+}
+
+template<typename T, std::size_t N>
+bool
+xpcc::atomic::ConcurrentQueue<T, N>::isFull() const
+{
+	const Index position = load(this->writePosition);
+	return (load(this->cells[position & mask].sequence) != position);
+}
+
+template<typename T, std::size_t N>
+typename xpcc::atomic::ConcurrentQueue<T, N>::Size
+xpcc::atomic::ConcurrentQueue<T, N>::getSize() const
+{
+	const Index read = load(this->readPosition);
+	const Index write = load(this->writePosition);
+	const SignedIndex size = SignedIndex(Index(write - read));
+	if (size < 0) {
+		// the read position was loaded before a consumer advanced it
+		return 0;
+	}
+	return (Size(size) > N) ? N : Size(size);
+}
+
+// ----------------------------------------------------------------------------
+#if defined(XPCC__OS_HOSTED)
+
+template<typename T, std::size_t N>
+typename xpcc::atomic::ConcurrentQueue<T, N>::Index
+xpcc::atomic::ConcurrentQueue<T, N>::load(const AtomicIndex& index)
+{
+	return index.load(std::memory_order_acquire);
+}
+
+template<typename T, std::size_t N>
+void
+xpcc::atomic::ConcurrentQueue<T, N>::store(AtomicIndex& index, Index value)
+{
+	index.store(value, std::memory_order_release);
+}
+
+template<typename T, std::size_t N>
+bool
+xpcc::atomic::ConcurrentQueue<T, N>::compareAndSwap(
+		AtomicIndex& index, Index& expected, Index desired)
+{
+	return index.compare_exchange_weak(expected, desired,
+			std::memory_order_acq_rel, std::memory_order_acquire);
+}
+
+#elif defined(XPCC__CPU_CORTEX_M3) || defined(XPCC__CPU_CORTEX_M4) || defined(XPCC__CPU_CORTEX_M7)
+
+// Interrupts run on the same core, aligned word accesses are atomic and
+// seen in program order. Only the compiler has to be kept from moving the
+// accesses to the elements across the accesses to the indices.
+template<typename T, std::size_t N>
+typename xpcc::atomic::ConcurrentQueue<T, N>::Index
+xpcc::atomic::ConcurrentQueue<T, N>::load(const AtomicIndex& index)
+{
+	Index value = static_cast<const volatile Index&>(index);
+	asm volatile ("" ::: "memory");
+	return value;
+}
+
+template<typename T, std::size_t N>
+void
+xpcc::atomic::ConcurrentQueue<T, N>::store(AtomicIndex& index, Index value)
+{
+	asm volatile ("" ::: "memory");
+	static_cast<volatile Index&>(index) = value;
+}
+
+template<typename T, std::size_t N>
+bool
+xpcc::atomic::ConcurrentQueue<T, N>::compareAndSwap(
+		AtomicIndex& index, Index& expected, Index desired)
+{
+	Index current;
+	uint32_t failed;
+	do {
+		asm volatile (
+				"ldrex %0, [%1]"
+				: "=&r" (current)
+				: "r" (&index)
+				: "memory");
+		if (current != expected)
+		{
+			asm volatile ("clrex" ::: "memory");
+			expected = current;
+			return false;
+		}
+		// fails if an interrupt occurred since the ldrex
+		asm volatile (
+				"strex %0, %2, [%1]"
+				: "=&r" (failed)
+				: "r" (&index), "r" (desired)
+				: "memory");
+	}
+	while (failed);
+	return true;
+}
+
+#else
+
+// No exclusive access instructions (Cortex-M0, AVR): the indices are
+// accessed with interrupts disabled, which only takes a few cycles.
+template<typename T, std::size_t N>
+typename xpcc::atomic::ConcurrentQueue<T, N>::Index
+xpcc::atomic::ConcurrentQueue<T, N>::load(const AtomicIndex& index)
+{
+	Lock lock;
+	return static_cast<const volatile Index&>(index);
+}
+
+template<typename T, std::size_t N>
+void
+xpcc::atomic::ConcurrentQueue<T, N>::store(AtomicIndex& index, Index value)
+{
+	Lock lock;
+	static_cast<volatile Index&>(index) = value;
+}
+
+template<typename T, std::size_t N>
+bool
+xpcc::atomic::ConcurrentQueue<T, N>::compareAndSwap(
+		AtomicIndex& index, Index& expected, Index desired)
+{
+	Lock lock;
+	const Index current = static_cast<volatile Index&>(index);
+	if (current != expected) {
+		expected = current;
+		return false;
+	}
+	static_cast<volatile Index&>(index) = desired;
+	return true;
+}
+
+#endif
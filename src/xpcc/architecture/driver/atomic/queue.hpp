@@ -32,6 +32,7 @@
 #define	XPCC_ATOMIC__QUEUE_HPP
 
 #include <cstddef>
+#include <algorithm>
 #include <stdint.h>
 #include <xpcc/architecture/utils.hpp>
 #include <xpcc/architecture/driver/accessor.hpp>
@@ -108,6 +109,62 @@ namespace xpcc
 			
 			void
 			pop();
+			
+			/// Number of stored elements
+			Size
+			getSize() const;
+			
+			/**
+			 * \brief	Append up to \p count elements
+			 * 
+			 * Same restrictions as push(), only one producer at a time.
+			 * 
+			 * \return	Number of appended elements, less than \p count
+			 * 			if the queue became full
+			 */
+			std::size_t
+			push(const T* values, std::size_t count);
+			
+			/**
+			 * \brief	Copy up to \p count of the oldest elements to
+			 * 			\p values and remove them
+			 * 
+			 * \return	Number of removed elements
+			 */
+			std::size_t
+			pop(T* values, std::size_t count);
+			
+			/**
+			 * \brief	Consumer: contiguous block of the oldest elements
+			 * 
+			 * The elements can be processed in place and are removed with
+			 * commitRead() afterwards. This allows copying them with
+			 * memcpy() or a DMA transfer instead of calling get() and pop()
+			 * for every element. The span ends at the end of the internal
+			 * buffer, a second call after commitRead() returns the rest.
+			 * 
+			 * \param[out]	length	Number of elements in the span, zero if empty
+			 */
+			const T*
+			getReadSpan(std::size_t& length) const;
+			
+			/// Consumer: remove \p count elements, at most the length of the read span
+			void
+			commitRead(std::size_t count);
+			
+			/**
+			 * \brief	Producer: contiguous block of free elements
+			 * 
+			 * Fill the span and publish the elements with commitWrite().
+			 * 
+			 * \param[out]	length	Number of free elements in the span, zero if full
+			 */
+			T*
+			getWriteSpan(std::size_t& length);
+			
+			/// Producer: append \p count elements written to the write span
+			void
+			commitWrite(std::size_t count);
 	
 		private:
 			Index head;
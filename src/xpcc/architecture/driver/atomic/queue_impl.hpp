@@ -145,4 +145,118 @@ xpcc::atomic::Queue<T, N>::pop()
 	this->tail = tmptail;
 }
 
+template<typename T, std::size_t N>
+typename xpcc::atomic::Queue<T, N>::Size
+xpcc::atomic::Queue<T, N>::getSize() const
+{
+	Index tmphead = xpcc::accessor::asVolatile(this->head);
+	Index tmptail = xpcc::accessor::asVolatile(this->tail);
+	
+	if (tmphead >= tmptail) {
+		return tmphead - tmptail;
+	}
+	else {
+		return (N + 1) - tmptail + tmphead;
+	}
+}
+
+// ----------------------------------------------------------------------------
+template<typename T, std::size_t N>
+std::size_t
+xpcc::atomic::Queue<T, N>::push(const T* values, std::size_t count)
+{
+	std::size_t pushed = 0;
+	std::size_t length;
+	// at most twice: up to the end of the buffer and from its start
+	while (pushed < count)
+	{
+		T *span = this->getWriteSpan(length);
+		if (length == 0) {
+			break;
+		}
+		length = std::min(length, count - pushed);
+		std::copy(values + pushed, values + pushed + length, span);
+		this->commitWrite(length);
+		pushed += length;
+	}
+	return pushed;
+}
+
+template<typename T, std::size_t N>
+std::size_t
+xpcc::atomic::Queue<T, N>::pop(T* values, std::size_t count)
+{
+	std::size_t popped = 0;
+	std::size_t length;
+	while (popped < count)
+	{
+		const T *span = this->getReadSpan(length);
+		if (length == 0) {
+			break;
+		}
+		length = std::min(length, count - popped);
+		std::copy(span, span + length, values + popped);
+		this->commitRead(length);
+		popped += length;
+	}
+	return popped;
+}
+
+// ----------------------------------------------------------------------------
+template<typename T, std::size_t N>
+const T*
+xpcc::atomic::Queue<T, N>::getReadSpan(std::size_t& length) const
+{
+	Index tmphead = xpcc::accessor::asVolatile(this->head);
+	if (tmphead >= this->tail) {
+		length = tmphead - this->tail;
+	}
+	else {
+		length = (N + 1) - this->tail;
+	}
+	return &this->buffer[this->tail];
+}
+
+template<typename T, std::size_t N>
+void
+xpcc::atomic::Queue<T, N>::commitRead(std::size_t count)
+{
+	std::size_t tmptail = this->tail + count;
+	if (tmptail >= (N+1)) {
+		tmptail -= (N+1);
+	}
+	xpcc::accessor::asVolatile(this->tail) = tmptail;
+}
+
+template<typename T, std::size_t N>
+T*
+xpcc::atomic::Queue<T, N>::getWriteSpan(std::size_t& length)
+{
+	// one element always stays free to distinguish a full from an
+	// empty queue
+	Index tmptail = xpcc::accessor::asVolatile(this->tail);
+	if (this->head >= tmptail)
+	{
+		length = (N + 1) - this->head;
+		if (tmptail == 0) {
+			length--;
+		}
+	}
+	else {
+		length = tmptail - this->head - 1;
+	}
+	return &this->buffer[this->head];
+}
+
+template<typename T, std::size_t N>
+void
+xpcc::atomic::Queue<T, N>::commitWrite(std::size_t count)
+{
+	std::size_t tmphead = this->head + count;
+	if (tmphead >= (N+1)) {
+		tmphead -= (N+1);
+	}
+	xpcc::accessor::asVolatile(this->head) = tmphead;
+}
+
 #endif	// XPCC_ATOMIC__QUEUE_IMPL_HPP
@@ -68,3 +68,81 @@ AtomicQueueTest::testQueue()
 	
 	TEST_ASSERT_TRUE(queue.isEmpty());
 }
+
+void
+AtomicQueueTest::testBulk()
+{
+	xpcc::atomic::Queue<uint8_t, 7> queue;
+	const uint8_t input[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	uint8_t output[9] = { 0 };
+	
+	TEST_ASSERT_EQUALS(queue.push(input, 5), 5U);
+	TEST_ASSERT_EQUALS(queue.getSize(), 5U);
+	TEST_ASSERT_EQUALS(queue.pop(output, 3), 3U);
+	TEST_ASSERT_EQUALS_ARRAY(output, input, 3);
+	
+	// wraps around the end of the buffer, stops when full
+	TEST_ASSERT_EQUALS(queue.push(input + 5, 4), 4U);
+	TEST_ASSERT_EQUALS(queue.push(input, 3), 1U);
+	TEST_ASSERT_TRUE(queue.isFull());
+	TEST_ASSERT_EQUALS(queue.getSize(), 7U);
+	
+	TEST_ASSERT_EQUALS(queue.pop(output, 9), 7U);
+	TEST_ASSERT_EQUALS_ARRAY(output, input + 3, 6);
+	TEST_ASSERT_EQUALS(output[6], 1);
+	
+	TEST_ASSERT_TRUE(queue.isEmpty());
+	TEST_ASSERT_EQUALS(queue.pop(output, 9), 0U);
+}
+
+void
+AtomicQueueTest::testSpan()
+{
+	xpcc::atomic::Queue<uint8_t, 4> queue;
+	std::size_t length;
+	
+	queue.getReadSpan(length);
+	TEST_ASSERT_EQUALS(length, 0U);
+	
+	// one element of the buffer always stays free
+	uint8_t *write = queue.getWriteSpan(length);
+	TEST_ASSERT_EQUALS(length, 4U);
+	write[0] = 'a';
+	write[1] = 'b';
+	write[2] = 'c';
+	queue.commitWrite(3);
+	TEST_ASSERT_EQUALS(queue.getSize(), 3U);
+	TEST_ASSERT_EQUALS(queue.get(), 'a');
+	
+	const uint8_t *read = queue.getReadSpan(length);
+	TEST_ASSERT_EQUALS(length, 3U);
+	TEST_ASSERT_EQUALS(read[1], 'b');
+	queue.commitRead(2);
+	
+	// up to the end of the buffer, then from its start
+	write = queue.getWriteSpan(length);
+	TEST_ASSERT_EQUALS(length, 2U);
+	write[0] = 'd';
+	write[1] = 'e';
+	queue.commitWrite(2);
+	
+	write = queue.getWriteSpan(length);
+	TEST_ASSERT_EQUALS(length, 1U);
+	write[0] = 'f';
+	queue.commitWrite(1);
+	TEST_ASSERT_TRUE(queue.isFull());
+	queue.getWriteSpan(length);
+	TEST_ASSERT_EQUALS(length, 0U);
+	
+	read = queue.getReadSpan(length);
+	TEST_ASSERT_EQUALS(length, 3U);
+	TEST_ASSERT_EQUALS(read[0], 'c');
+	TEST_ASSERT_EQUALS(read[2], 'e');
+	queue.commitRead(3);
+	
+	read = queue.getReadSpan(length);
+	TEST_ASSERT_EQUALS(length, 1U);
+	TEST_ASSERT_EQUALS(read[0], 'f');
+	queue.commitRead(1);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+}
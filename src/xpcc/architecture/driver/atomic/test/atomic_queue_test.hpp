@@ -35,4 +35,10 @@ class AtomicQueueTest : public unittest::TestSuite
 public:
 	void
 	testQueue();
+	
+	void
+	testBulk();
+	
+	void
+	testSpan();
 };
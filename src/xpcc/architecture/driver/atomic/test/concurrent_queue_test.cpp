@@ -0,0 +1,186 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/architecture/driver/atomic/concurrent_queue.hpp>
+
+#ifdef XPCC__OS_HOSTED
+#	include <atomic>
+#	include <thread>
+#	include <vector>
+#endif
+
+#include "concurrent_queue_test.hpp"
+
+void
+ConcurrentQueueTest::testQueue()
+{
+	xpcc::atomic::ConcurrentQueue<int16_t, 4> queue;
+	int16_t value = 0;
+
+	TEST_ASSERT_TRUE(queue.isEmpty());
+	TEST_ASSERT_FALSE(queue.isFull());
+	TEST_ASSERT_EQUALS(queue.getMaxSize(), 4U);
+	TEST_ASSERT_FALSE(queue.pop(value));
+
+	TEST_ASSERT_TRUE(queue.push(1));
+	TEST_ASSERT_TRUE(queue.push(2));
+	TEST_ASSERT_TRUE(queue.push(3));
+	TEST_ASSERT_TRUE(queue.push(4));
+	TEST_ASSERT_EQUALS(queue.getSize(), 4U);
+
+	TEST_ASSERT_TRUE(queue.isFull());
+	TEST_ASSERT_FALSE(queue.push(5));
+
+	TEST_ASSERT_TRUE(queue.pop(value));
+	TEST_ASSERT_EQUALS(value, 1);
+	TEST_ASSERT_TRUE(queue.pop(value));
+	TEST_ASSERT_EQUALS(value, 2);
+	TEST_ASSERT_EQUALS(queue.getSize(), 2U);
+
+	TEST_ASSERT_TRUE(queue.push(5));
+	TEST_ASSERT_TRUE(queue.push(6));
+	TEST_ASSERT_FALSE(queue.push(7));
+
+	for (int16_t i = 3; i <= 6; ++i)
+	{
+		TEST_ASSERT_TRUE(queue.pop(value));
+		TEST_ASSERT_EQUALS(value, i);
+	}
+
+	TEST_ASSERT_TRUE(queue.isEmpty());
+	TEST_ASSERT_FALSE(queue.pop(value));
+}
+
+void
+ConcurrentQueueTest::testWrapAround()
+{
+	// the positions run around the buffer many times
+	xpcc::atomic::ConcurrentQueue<uint32_t, 8> queue;
+	uint32_t first = 0;
+	uint32_t second = 0;
+	bool correct = true;
+
+	for (uint32_t i = 0; i < 200000; ++i)
+	{
+		correct &= queue.push(i);
+		correct &= queue.push(i + 1);
+		correct &= queue.pop(first);
+		correct &= queue.pop(second);
+		correct &= (first == i) and (second == i + 1);
+	}
+	TEST_ASSERT_TRUE(correct);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+}
+
+void
+ConcurrentQueueTest::testBatch()
+{
+	xpcc::atomic::ConcurrentQueue<uint8_t, 8> queue;
+	const uint8_t input[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	uint8_t output[10] = { 0 };
+
+	TEST_ASSERT_EQUALS(queue.push(input, 0), 0U);
+	TEST_ASSERT_EQUALS(queue.push(input, 3), 3U);
+
+	// only the free cells are filled
+	TEST_ASSERT_EQUALS(queue.push(input + 3, 7), 5U);
+	TEST_ASSERT_TRUE(queue.isFull());
+	TEST_ASSERT_EQUALS(queue.push(input + 8, 2), 0U);
+
+	TEST_ASSERT_EQUALS(queue.pop(output, 2), 2U);
+	TEST_ASSERT_EQUALS_ARRAY(output, input, 2);
+
+	// wraps around the end of the buffer
+	TEST_ASSERT_EQUALS(queue.push(input + 8, 2), 2U);
+	TEST_ASSERT_EQUALS(queue.getSize(), 8U);
+
+	TEST_ASSERT_EQUALS(queue.pop(output, 10), 8U);
+	TEST_ASSERT_EQUALS_ARRAY(output, input + 2, 8);
+
+	TEST_ASSERT_TRUE(queue.isEmpty());
+	TEST_ASSERT_EQUALS(queue.pop(output, 10), 0U);
+}
+
+void
+ConcurrentQueueTest::testMultipleProducersAndConsumers()
+{
+#ifdef XPCC__OS_HOSTED
+	static constexpr uint32_t producerCount = 3;
+	static constexpr uint32_t consumerCount = 2;
+	static constexpr uint32_t valuesPerProducer = 50000;
+
+	xpcc::atomic::ConcurrentQueue<uint32_t, 64> queue;
+
+	std::vector<std::thread> producers;
+	for (uint32_t producer = 0; producer < producerCount; ++producer)
+	{
+		producers.emplace_back([&queue, producer]()
+		{
+			// the producer is encoded in the upper bits, every value is
+			// pushed in pairs to exercise the batch push
+			uint32_t values[2];
+			for (uint32_t i = 0; i < valuesPerProducer; i += 2)
+			{
+				values[0] = (producer << 24) | i;
+				values[1] = (producer << 24) | (i + 1);
+				std::size_t pushed = 0;
+				while (pushed < 2)
+				{
+					pushed += queue.push(values + pushed, 2 - pushed);
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	std::atomic<uint32_t> received(0);
+	std::atomic<bool> inOrder(true);
+	std::vector<std::thread> consumers;
+	for (uint32_t consumer = 0; consumer < consumerCount; ++consumer)
+	{
+		consumers.emplace_back([&queue, &received, &inOrder]()
+		{
+			// values of one producer have to arrive in ascending order at
+			// every consumer
+			int64_t last[producerCount] = { -1, -1, -1 };
+			uint32_t values[4];
+			while (received.load() < producerCount * valuesPerProducer)
+			{
+				std::size_t count = queue.pop(values, 4);
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					uint32_t producer = values[i] >> 24;
+					int64_t value = values[i] & 0xffffff;
+					if (producer >= producerCount or value <= last[producer]) {
+						inOrder = false;
+					}
+					else {
+						last[producer] = value;
+					}
+				}
+				received += count;
+				if (count == 0) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	for (std::thread& thread : producers) {
+		thread.join();
+	}
+	for (std::thread& thread : consumers) {
+		thread.join();
+	}
+
+	TEST_ASSERT_TRUE(inOrder);
+	TEST_ASSERT_EQUALS(received.load(), producerCount * valuesPerProducer);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+#endif
+}
@@ -95,6 +95,27 @@ namespace xpcc
 		std::size_t
 		getAvailableSize() const;
 		
+		/**
+		 * Largest size which can be allocated at once.
+		 * 
+		 * Usually smaller than getAvailableSize() if the free slots are
+		 * fragmented.
+		 */
+		std::size_t
+		getLargestFreeBlock() const;
+		
+		/**
+		 * Usable size of an allocated block.
+		 * 
+		 * Might be larger than the requested size, because the size is
+		 * rounded up to a multiple of the block size.
+		 * 
+		 * \param	ptr
+		 * 		Must be a pointer previously acquired by allocate().
+		 */
+		std::size_t
+		getBlockSize(const void *ptr) const;
+		
 	private:
 		// Align the pointer to a multiple of XPCC__ALIGNMENT
 		xpcc_always_inline T *
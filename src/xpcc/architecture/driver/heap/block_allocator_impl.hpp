@@ -222,6 +222,52 @@ xpcc::BlockAllocator<T, BLOCK_SIZE>::getAvailableSize() const
 	return size;
 }
 
+// ----------------------------------------------------------------------------
+template <typename T, unsigned int BLOCK_SIZE >
+std::size_t
+xpcc::BlockAllocator<T, BLOCK_SIZE>::getLargestFreeBlock() const
+{
+	T *p = start;
+	std::size_t largest = 0;
+	
+	do {
+		SignedType slots = *p;
+		
+		if (slots < 0)
+		{
+			slots = -slots;
+			
+			T freeSlots = slots;
+			if (freeSlots > largest) {
+				largest = freeSlots;
+			}
+		}
+		
+		p += slots * BLOCK_SIZE;
+	}
+	while (p < end);
+	
+	if (largest == 0) {
+		return 0;
+	}
+	// 4 bytes are needed for the management
+	return largest * BLOCK_SIZE * sizeof(T) - 4;
+}
+
+template <typename T, unsigned int BLOCK_SIZE >
+std::size_t
+xpcc::BlockAllocator<T, BLOCK_SIZE>::getBlockSize(const void *ptr) const
+{
+	if (ptr == 0) {
+		return 0;
+	}
+	
+	const T *p = (const T *) ptr;
+	T slots = *(p - 1);
+	
+	return slots * BLOCK_SIZE * sizeof(T) - 4;
+}
+
 // ----------------------------------------------------------------------------
 template<typename T, unsigned int BLOCK_SIZE >
 xpcc_always_inline T *
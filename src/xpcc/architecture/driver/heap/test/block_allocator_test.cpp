@@ -116,3 +116,55 @@ BlockAllocatorTest::testAlignment()
 
 	delete[] heap;
 }
+
+void
+BlockAllocatorTest::testBlockSize()
+{
+	uint8_t *heap = new uint8_t[512];
+	
+	xpcc::BlockAllocator<uint16_t, 8> allocator;
+	allocator.initialize(heap, heap + 512);
+	
+	// rounded up to a multiple of the block size minus the management data
+	TEST_ASSERT_EQUALS(allocator.getBlockSize(allocator.allocate(1)), 12U);
+	TEST_ASSERT_EQUALS(allocator.getBlockSize(allocator.allocate(12)), 12U);
+	TEST_ASSERT_EQUALS(allocator.getBlockSize(allocator.allocate(13)), 28U);
+	TEST_ASSERT_EQUALS(allocator.getBlockSize(0), 0U);
+	
+	delete[] heap;
+}
+
+void
+BlockAllocatorTest::testLargestFreeBlock()
+{
+	uint8_t *heap = new uint8_t[512];
+	
+	xpcc::BlockAllocator<uint16_t, 8> allocator;
+	allocator.initialize(heap, heap + 512);
+	
+	TEST_ASSERT_EQUALS(allocator.getLargestFreeBlock(), 492U);
+	
+	void* firstBlock = allocator.allocate(12);
+	void* secondBlock = allocator.allocate(12);
+	allocator.allocate(12);
+	
+	TEST_ASSERT_EQUALS(allocator.getLargestFreeBlock(), 444U);
+	
+	allocator.free(secondBlock);
+	allocator.allocate(444);
+	
+	// only the fragment of the second block is left
+	TEST_ASSERT_EQUALS(allocator.getAvailableSize(), 16U);
+	TEST_ASSERT_EQUALS(allocator.getLargestFreeBlock(), 12U);
+	
+	allocator.free(firstBlock);
+	
+	TEST_ASSERT_EQUALS(allocator.getAvailableSize(), 32U);
+	TEST_ASSERT_EQUALS(allocator.getLargestFreeBlock(), 28U);
+	
+	allocator.allocate(28);
+	
+	TEST_ASSERT_EQUALS(allocator.getLargestFreeBlock(), 0U);
+	
+	delete[] heap;
+}
@@ -47,6 +47,12 @@ public:
 
 	void
 	testAlignment();
+
+	void
+	testBlockSize();
+
+	void
+	testLargestFreeBlock();
 };
 
 #endif	// BLOCK_ALLOCATOR_TEST_HPP
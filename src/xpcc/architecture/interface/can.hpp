@@ -72,6 +72,19 @@ public:
 		///< The bus-off state is entered on TEC overflow, greater than 255
 		Off = 3,
 	};
+
+	/**
+	 * Acceptance filter for extended (29-bit) identifiers.
+	 *
+	 * A message is accepted if `(message.identifier & mask) ==
+	 * (identifier & mask)`. Bits which are cleared in the mask are
+	 * don't care.
+	 */
+	struct Filter
+	{
+		uint32_t identifier;
+		uint32_t mask;
+	};
 #ifdef __DOXYGEN__
 public:
 	/// Size of the receive buffer.
@@ -129,6 +142,21 @@ public:
 
 	static BusState
 	getBusState();
+
+	/// Maximum number of filters accepted by @c setFilters
+	static constexpr uint8_t FilterCount = 14;
+
+	/**
+	 * Replace all acceptance filters.
+	 *
+	 * Only extended frames matching at least one of the filters are
+	 * received afterwards. An empty list accepts all messages again.
+	 *
+	 * @param	filters	list of filters
+	 * @param	count	number of filters, at most @c FilterCount
+	 */
+	static void
+	setFilters(const Filter *filters, uint8_t count);
 #endif
 };
 
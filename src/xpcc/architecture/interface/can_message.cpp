@@ -20,14 +20,17 @@ namespace xpcc
 namespace can
 {
 
+constexpr uint8_t Message::capacity;
+
 xpcc::IOStream&
 operator << (xpcc::IOStream& s, const xpcc::can::Message m)
 {
     s.printf("id = %04" PRIx32 ", len = ", m.identifier);
     s << m.length;
-    s.printf(", flags = %c%c, data = ",
+    s.printf(", flags = %c%c%c, data = ",
              m.flags.rtr ? 'R' : 'r',
-             m.flags.extended ? 'E' : 'e');
+             m.flags.extended ? 'E' : 'e',
+             m.flags.fd ? 'F' : 'f');
     for (uint_fast8_t ii = 0; ii < m.length; ++ii) {
         s.printf("%02x ", m.data[ii]);
     }
@@ -40,7 +43,8 @@ xpcc::can::Message::operator == (const xpcc::can::Message& rhs) const
 	if ((this->identifier     == rhs.identifier) and
 		(this->length         == rhs.length)     and
 		(this->flags.rtr      == rhs.flags.rtr)  and
-		(this->flags.extended == rhs.flags.extended))
+		(this->flags.extended == rhs.flags.extended) and
+		(this->flags.fd       == rhs.flags.fd))
 	{
 		bool eq = true;
 		for (uint8_t ii = 0; ii < this->length; ++ii)
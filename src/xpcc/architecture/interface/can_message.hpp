@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <xpcc/io/iostream.hpp>
 #include <xpcc/architecture/utils.hpp>
+#include <xpcc/architecture/detect.hpp>
 
 namespace xpcc
 {
@@ -21,12 +22,31 @@ namespace xpcc
 namespace can
 {
 
-/// Representation of a CAN message
-/// @ingroup	can
+/**
+ * Representation of a CAN message
+ *
+ * On hosted targets a message can hold the up to 64 data bytes of a CAN FD
+ * frame. Device targets only support classic CAN frames, so the data is
+ * limited to 8 bytes there to save memory.
+ *
+ * Hosted drivers may additionally store the time of reception in
+ * `timestamp`.
+ *
+ * @ingroup	can
+ */
 struct Message
 {
+#ifdef XPCC__OS_HOSTED
+	static constexpr uint8_t capacity = 64;
+#else
+	static constexpr uint8_t capacity = 8;
+#endif
+
 	Message(const uint32_t& inIdentifier = 0, uint8_t inLength = 0) :
 		identifier(inIdentifier), flags(), length(inLength)
+#ifdef XPCC__OS_HOSTED
+		, timestamp(0)
+#endif
 	{
 	}
 
@@ -66,6 +86,32 @@ struct Message
 		return (flags.rtr != 0);
 	}
 
+	/// Mark the message as CAN FD frame, which may hold up to 64 bytes
+	inline void
+	setFlexibleData(bool fd = true)
+	{
+		flags.fd = (fd) ? 1 : 0;
+	}
+
+	inline bool
+	isFlexibleData() const
+	{
+		return (flags.fd != 0);
+	}
+
+	/// Transmit the data phase of a CAN FD frame with the higher bitrate
+	inline void
+	setBitRateSwitch(bool brs = true)
+	{
+		flags.brs = (brs) ? 1 : 0;
+	}
+
+	inline bool
+	isBitRateSwitch() const
+	{
+		return (flags.brs != 0);
+	}
+
 	inline uint8_t
 	getLength() const
 	{
@@ -78,20 +124,43 @@ struct Message
 		length = len;
 	}
 
+	/**
+	 * Smallest valid data length of a CAN FD frame which can hold
+	 * \p length bytes.
+	 *
+	 * Above 8 bytes only 12, 16, 20, 24, 32, 48 and 64 bytes can be
+	 * encoded in the data length code.
+	 */
+	static constexpr uint8_t
+	roundUpLength(uint8_t length)
+	{
+		return	(length <=  8) ? length :
+				(length <= 24) ? ((length + 3) & ~3) :
+				(length <= 32) ? 32 :
+				(length <= 48) ? 48 : 64;
+	}
+
 public:
 	uint32_t identifier;
-	uint8_t xpcc_aligned(4) data[8];
+	uint8_t xpcc_aligned(4) data[capacity];
 	struct Flags
 	{
 		Flags() :
-			rtr(0), extended(1)
+			rtr(0), extended(1), fd(0), brs(0)
 		{
 		}
 
 		bool rtr : 1;
 		bool extended : 1;
+		bool fd : 1;
+		bool brs : 1;
 	} flags;
 	uint8_t length;
+#ifdef XPCC__OS_HOSTED
+	/// Time of reception in microseconds since the epoch, 0 if unknown.
+	/// Not part of the comparison of two messages.
+	uint64_t timestamp;
+#endif
 
 public:
 	bool
@@ -10,12 +10,13 @@
 #ifndef XPCC_CAN_USB_HPP
 #define XPCC_CAN_USB_HPP
 
-#include <queue>
-#include <string>
+#include <atomic>
+#include <thread>
 
 #include <xpcc/architecture/interface/can.hpp>
-#include <mutex>
-#include <thread>
+#include <xpcc/processing/timer/timeout.hpp>
+#include <xpcc/container/spsc_queue.hpp>
+#include <xpcc/driver/can/can_lawicel_parser.hpp>
 
 namespace xpcc
 {
@@ -26,6 +27,22 @@ namespace hosted
 /**
  * Driver for a CAN232 or CANUSB adapter
  *
+ * A receiver thread reads the serial port in chunks and feeds them to a
+ * CanLawicelParser. Received frames are handed over through a lock-free
+ * queue, so neither the receiver thread nor the caller of getMessage()
+ * ever waits for the other one.
+ *
+ * The adapter acknowledges every transmit command. At most
+ * `maxPendingFrames` frames are sent without acknowledgement,
+ * isReadyToSend() returns `false` until the adapter caught up. If no
+ * acknowledgement arrives for `acknowledgeTimeout` milliseconds, the
+ * missing ones are assumed to be lost.
+ *
+ * If \p SerialPort provides `std::size_t read(uint8_t*, std::size_t)`, the
+ * port is read in chunks, otherwise character by character. If it provides
+ * `int getFileDescriptor()`, the receiver thread sleeps in poll() while no
+ * data is available.
+ *
  * @see		http://www.canusb.com/
  * @see		http://www.can232.com/
  * @ingroup	hosted
@@ -34,7 +51,14 @@ template <typename SerialPort>
 class CanUsb : public ::xpcc::Can
 {
 public:
-	CanUsb(SerialPort& serialPort);
+	/// Frames sent to the adapter but not yet acknowledged
+	static constexpr uint8_t maxPendingFrames = 8;
+
+	/// Milliseconds after which missing acknowledgements are given up
+	static constexpr uint16_t acknowledgeTimeout = 100;
+
+public:
+	CanUsb(SerialPort& serialPort, std::size_t receiveQueueSize = 1024);
 
 	~CanUsb();
 
@@ -47,18 +71,14 @@ public:
 	inline bool
 	isMessageAvailable()
 	{
-		return (!this->readBuffer.empty());
+		return (!this->readBuffer.isEmpty());
 	}
 
 	bool
 	getMessage(can::Message& message);
 
-	inline bool
-	isReadyToSend()
-	{
-		// TODO
-		return true;
-	}
+	bool
+	isReadyToSend();
 
 	BusState
 	getBusState();
@@ -77,27 +97,44 @@ public:
 		return this->serialPort.isOpen();
 	}
 
+	/// Frames dropped because getMessage() wasn't called often enough
+	inline uint32_t
+	getReceiveOverflows() const
+	{
+		return this->readBuffer.getOverflows();
+	}
+
+	/// Transmit commands rejected by the adapter or never acknowledged
+	inline uint32_t
+	getTransmitErrors() const
+	{
+		return this->rejected + this->lostAcknowledgements;
+	}
+
 private:
-	// updated by boost thread
+	// executed by the receiver thread
 	void
 	update();
 
 private:
-	typedef std::mutex				Mutex;
-	typedef std::lock_guard<Mutex>	MutexGuard;
-
-	Mutex stateLock;
-	Mutex readBufferLock;
-	bool active;
+	std::atomic<bool> active;
 
 	BusState busState;
 
 	SerialPort& serialPort;
 
-	std::string tmpRead;
-	std::queue<can::Message> readBuffer;
+	CanLawicelParser parser;
+	SpscQueue<can::Message> readBuffer;
+
+	// written by the receiver thread
+	std::atomic<uint32_t> acknowledged;
+	std::atomic<uint32_t> rejected;
+
+	uint32_t sent;
+	uint32_t lostAcknowledgements;
+	xpcc::ShortTimeout acknowledgeTimer;
 
-	std::thread* thread;
+	std::thread thread;
 };
 
 }	// namespace hosted
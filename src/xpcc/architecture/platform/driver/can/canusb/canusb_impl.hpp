@@ -11,7 +11,10 @@
 #error "Do not include this file directly. Include canusb.hpp"
 #endif
 
-#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <poll.h>
+
 #include <xpcc/debug/logger.hpp>
 
 #include <xpcc/architecture/driver.hpp>
@@ -23,24 +26,80 @@
 #undef  XPCC_LOG_LEVEL
 #define XPCC_LOG_LEVEL xpcc::log::INFO
 
+namespace xpcc
+{
+
+namespace hosted
+{
+
+/// @cond
+namespace canusb
+{
+	// Use the bulk read of the serial port if available
+	template <typename SerialPort>
+	auto
+	read(SerialPort& port, char *buffer, std::size_t size, int)
+		-> decltype(std::size_t(port.read(static_cast<uint8_t*>(nullptr), size)))
+	{
+		return port.read(reinterpret_cast<uint8_t*>(buffer), size);
+	}
+
+	template <typename SerialPort>
+	std::size_t
+	read(SerialPort& port, char *buffer, std::size_t size, long)
+	{
+		std::size_t count = 0;
+		while (count < size and port.read(buffer[count])) {
+			count++;
+		}
+		return count;
+	}
+
+	// Sleep until data is available if the port has a file descriptor
+	template <typename SerialPort>
+	auto
+	waitForData(SerialPort& port, int timeout, int)
+		-> decltype(int(port.getFileDescriptor()), void())
+	{
+		struct pollfd descriptor = { port.getFileDescriptor(), POLLIN, 0 };
+		::poll(&descriptor, 1, timeout);
+	}
+
+	template <typename SerialPort>
+	void
+	waitForData(SerialPort&, int, long)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+	}
+}
+/// @endcond
+
+}	// namespace hosted
+
+}	// namespace xpcc
+
 template <typename SerialPort>
-xpcc::hosted::CanUsb<SerialPort>::CanUsb(SerialPort& serialPort)
-:	active(false), busState(BusState::Off), serialPort(serialPort)
+constexpr uint8_t xpcc::hosted::CanUsb<SerialPort>::maxPendingFrames;
+
+template <typename SerialPort>
+constexpr uint16_t xpcc::hosted::CanUsb<SerialPort>::acknowledgeTimeout;
+
+template <typename SerialPort>
+xpcc::hosted::CanUsb<SerialPort>::CanUsb(SerialPort& serialPort,
+		std::size_t receiveQueueSize)
+:	active(false), busState(BusState::Off), serialPort(serialPort),
+	readBuffer(receiveQueueSize), acknowledged(0), rejected(0),
+	sent(0), lostAcknowledgements(0)
 {
 }
 
 template <typename SerialPort>
 xpcc::hosted::CanUsb<SerialPort>::~CanUsb()
 {
-	if (this->active)
+	if (this->thread.joinable())
 	{
-		{
-			MutexGuard stateGuard(this->stateLock);
-			this->active = false;
-		}
-		this->thread->join();
-		delete this->thread;
-		this->thread = 0;
+		this->active = false;
+		this->thread.join();
 	}
 }
 
@@ -130,14 +189,13 @@ xpcc::hosted::CanUsb<SerialPort>::open(xpcc::Can::Bitrate canBitrate)
 			return false;
 		}
 
-		{
-			MutexGuard stateGuard(this->stateLock);
-			this->active = true;
-		}
-		this->thread = new std::thread(&xpcc::hosted::CanUsb<SerialPort>::update, this);
+		this->parser.reset();
+		this->sent = this->acknowledged = this->rejected = 0;
+
+		this->active = true;
+		this->thread = std::thread(&xpcc::hosted::CanUsb<SerialPort>::update, this);
 
 		busState = BusState::Connected;
-		this->tmpRead.clear();
 		return true;
 	}
 	else
@@ -153,14 +211,12 @@ void
 xpcc::hosted::CanUsb<SerialPort>::close()
 {
 	this->serialPort.write("C\r");
+
+	if (this->thread.joinable())
 	{
-		MutexGuard stateGuard(this->stateLock);
 		this->active = false;
+		this->thread.join();
 	}
-
-	this->thread->join();
-	delete this->thread;
-	this->thread = 0;
 	busState = BusState::Off;
 }
 
@@ -175,9 +231,9 @@ template <typename SerialPort>
 bool
 xpcc::hosted::CanUsb<SerialPort>::getMessage(can::Message& message)
 {
-	if (not this->readBuffer.empty())
+	if (not this->readBuffer.isEmpty())
 	{
-		message = this->readBuffer.front();
+		message = this->readBuffer.getFront();
 		this->readBuffer.pop();
 		return true;
 	}
@@ -187,20 +243,47 @@ xpcc::hosted::CanUsb<SerialPort>::getMessage(can::Message& message)
 	}
 }
 
+template <typename SerialPort>
+bool
+xpcc::hosted::CanUsb<SerialPort>::isReadyToSend()
+{
+	uint32_t completed = this->acknowledged.load(std::memory_order_acquire);
+	// late acknowledgements may overtake a resynchronisation
+	int32_t pending = static_cast<int32_t>(this->sent - completed);
+	if (pending < maxPendingFrames) {
+		return true;
+	}
+
+	if (this->acknowledgeTimer.isExpired())
+	{
+		// the adapter dropped the acknowledgements or the commands
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Missing acknowledgements for "
+				<< pending << " frames" << xpcc::endl;
+		this->lostAcknowledgements += pending;
+		this->sent = completed;
+		return true;
+	}
+	return false;
+}
+
 template <typename SerialPort>
 bool
 xpcc::hosted::CanUsb<SerialPort>::sendMessage(const can::Message& message)
 {
-	char str[128];
-	xpcc::CanLawicelFormatter::convertToString(message, str);
-	XPCC_LOG_DEBUG.printf("Sending ");
-	char *p = str;
-	while (*p != '\0') {
-		XPCC_LOG_DEBUG.printf("%02x %c, ", *p, *p);
-		++p;
+	if (not this->isReadyToSend()) {
+		return false;
 	}
+
+	// command and line end are written at once
+	char str[CanLawicelParser::maxLineLength + 2];
+	xpcc::CanLawicelFormatter::convertToString(message, str);
+	std::size_t length = std::strlen(str);
+	str[length] = '\r';
+	str[length + 1] = '\0';
 	this->serialPort.write(str);
-	this->serialPort.write("\r");
+
+	this->sent++;
+	this->acknowledgeTimer.restart(acknowledgeTimeout);
 	return true;
 }
 
@@ -208,27 +291,38 @@ template <typename SerialPort>
 void
 xpcc::hosted::CanUsb<SerialPort>::update()
 {
-	while (true)
+	char buffer[256];
+	while (this->active)
 	{
-		char a;
-		if (this->serialPort.read(a))
+		std::size_t count = canusb::read(this->serialPort, buffer, sizeof(buffer), 0);
+		if (count == 0)
 		{
-			XPCC_LOG_DEBUG.printf("Received %02x\n", a);
-			if (a == 'T' || a == 't' || a == 'r' || a == 'R')
-			{
-				this->tmpRead.clear();
-			}
-			this->tmpRead += a;
+			canusb::waitForData(this->serialPort, 10, 0);
+			continue;
+		}
 
-			can::Message message;
-			if (xpcc::CanLawicelFormatter::convertToCanMessage(
-					this->tmpRead.c_str(), message))
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			switch (this->parser.process(buffer[i]))
 			{
-				this->readBuffer.push(message);
+				case CanLawicelParser::Result::Message:
+					// counted by the queue if full
+					this->readBuffer.push(this->parser.getMessage());
+					break;
+
+				case CanLawicelParser::Result::TransmitAck:
+					this->acknowledged.fetch_add(1, std::memory_order_release);
+					break;
+
+				case CanLawicelParser::Result::Error:
+					// a rejected command is completed as well
+					this->rejected.fetch_add(1, std::memory_order_relaxed);
+					this->acknowledged.fetch_add(1, std::memory_order_release);
+					break;
+
+				default:
+					break;
 			}
 		}
-		if (not this->active) {
-			break;
-		}
 	}
 }
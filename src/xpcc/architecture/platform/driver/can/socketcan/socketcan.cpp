@@ -4,23 +4,65 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/ioctl.h>
 #include <net/if.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
 
 #include <linux/can.h>
 #include <linux/can/raw.h>
+#include <linux/can/error.h>
+#include <errno.h>
 #include <string.h>
 
+#include <algorithm>
+
 #undef  XPCC_LOG_LEVEL
 #define XPCC_LOG_LEVEL xpcc::log::DEBUG
 
-xpcc::hosted::SocketCan::SocketCan()
+// ----------------------------------------------------------------------------
+struct xpcc::hosted::SocketCan::Batch
+{
+	Batch() :
+		begin(0), end(0)
+	{
+		memset(frames, 0, sizeof(frames));
+		memset(headers, 0, sizeof(headers));
+		for (uint8_t ii = 0; ii < BatchSize; ++ii)
+		{
+			iov[ii].iov_base = &frames[ii];
+			iov[ii].iov_len = sizeof(struct canfd_frame);
+			headers[ii].msg_hdr.msg_iov = &iov[ii];
+			headers[ii].msg_hdr.msg_iovlen = 1;
+		}
+	}
+
+	struct canfd_frame frames[BatchSize];
+	struct iovec iov[BatchSize];
+	struct mmsghdr headers[BatchSize];
+	char control[BatchSize][CMSG_SPACE(sizeof(struct timeval))];
+
+	/// Valid frames are in [begin, end)
+	uint8_t begin;
+	uint8_t end;
+};
+
+constexpr uint8_t xpcc::hosted::SocketCan::BatchSize;
+constexpr uint8_t xpcc::hosted::SocketCan::FilterCount;
+
+// ----------------------------------------------------------------------------
+xpcc::hosted::SocketCan::SocketCan() :
+	skt(-1), flexibleData(false), busState(BusState::Connected),
+	receiveErrorCounter(0), transmitErrorCounter(0),
+	rx(new Batch), tx(new Batch)
 {
 }
 
 xpcc::hosted::SocketCan::~SocketCan()
 {
+	close();
 }
 
 bool
@@ -33,6 +75,17 @@ xpcc::hosted::SocketCan::open(std::string deviceName /*, xpcc::Can::Bitrate canB
 	strcpy(ifr.ifr_name, deviceName.c_str());
 	ioctl(skt, SIOCGIFINDEX, &ifr); /* ifr.ifr_ifindex gets filled with that device's index */
 
+	/* Enable CAN FD frames if the interface supports them */
+	flexibleData = false;
+	struct ifreq mtu;
+	strcpy(mtu.ifr_name, deviceName.c_str());
+	if (ioctl(skt, SIOCGIFMTU, &mtu) == 0 and mtu.ifr_mtu == CANFD_MTU)
+	{
+		int enable = 1;
+		flexibleData = (setsockopt(skt, SOL_CAN_RAW, CAN_RAW_FD_FRAMES,
+				&enable, sizeof(enable)) == 0);
+	}
+
 	/* Select that CAN interface, and bind the socket to it. */
 	struct sockaddr_can addr;
 	addr.can_family = AF_CAN;
@@ -46,8 +99,18 @@ xpcc::hosted::SocketCan::open(std::string deviceName /*, xpcc::Can::Bitrate canB
 
 	fcntl(skt, F_SETFL, O_NONBLOCK);
 
+	/* Receive the time of reception of every frame */
+	int timestamp = 1;
+	setsockopt(skt, SOL_SOCKET, SO_TIMESTAMP, &timestamp, sizeof(timestamp));
+
+	/* Receive error frames to track the state of the controller */
+	can_err_mask_t errorMask = CAN_ERR_CRTL | CAN_ERR_BUSOFF | CAN_ERR_RESTARTED;
+	setsockopt(skt, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errorMask, sizeof(errorMask));
+	busState = BusState::Connected;
+
 	XPCC_LOG_INFO << XPCC_FILE_INFO;
-	XPCC_LOG_INFO << "SocketCAN opened successfully with skt = " << skt << xpcc::endl;
+	XPCC_LOG_INFO << "SocketCAN opened successfully with skt = " << skt;
+	XPCC_LOG_INFO << (flexibleData ? " (CAN FD)" : "") << xpcc::endl;
 
 	return true;
 }
@@ -55,54 +118,226 @@ xpcc::hosted::SocketCan::open(std::string deviceName /*, xpcc::Can::Bitrate canB
 void
 xpcc::hosted::SocketCan::close()
 {
+	if (skt >= 0)
+	{
+		flush();
+		::close(skt);
+		skt = -1;
+	}
+	rx->begin = rx->end = 0;
+	tx->begin = tx->end = 0;
+}
+
+bool
+xpcc::hosted::SocketCan::setFilters(const Filter *filters, uint8_t count)
+{
+	if (count == 0)
+	{
+		// default filter of a new socket
+		struct can_filter all;
+		all.can_id = 0;
+		all.can_mask = 0;
+		return (setsockopt(skt, SOL_CAN_RAW, CAN_RAW_FILTER,
+				&all, sizeof(all)) == 0);
+	}
+
+	struct can_filter rfilter[FilterCount];
+	if (count > FilterCount) {
+		count = FilterCount;
+	}
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		rfilter[i].can_id = (filters[i].identifier & CAN_EFF_MASK) | CAN_EFF_FLAG;
+		rfilter[i].can_mask = (filters[i].mask & CAN_EFF_MASK) | CAN_EFF_FLAG;
+	}
+
+	if (setsockopt(skt, SOL_CAN_RAW, CAN_RAW_FILTER,
+			rfilter, count * sizeof(struct can_filter)) < 0)
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO;
+		XPCC_LOG_ERROR << "Could not set CAN_RAW_FILTER" << xpcc::endl;
+		return false;
+	}
+	return true;
 }
 
+// ----------------------------------------------------------------------------
 xpcc::Can::BusState
 xpcc::hosted::SocketCan::getBusState()
 {
-	return BusState::Connected;
+	return busState;
+}
+
+uint8_t
+xpcc::hosted::SocketCan::getReceiveErrorCounter()
+{
+	return receiveErrorCounter;
+}
+
+uint8_t
+xpcc::hosted::SocketCan::getTransmitErrorCounter()
+{
+	return transmitErrorCounter;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::hosted::SocketCan::receive()
+{
+	while (true)
+	{
+		while (rx->begin < rx->end)
+		{
+			const struct canfd_frame& frame = rx->frames[rx->begin];
+			const unsigned int size = rx->headers[rx->begin].msg_len;
+			if (not (frame.can_id & CAN_ERR_FLAG) and
+				(size == CAN_MTU or size == CANFD_MTU))
+			{
+				return true;
+			}
+
+			if (frame.can_id & CAN_ERR_FLAG)
+			{
+				if (frame.can_id & CAN_ERR_BUSOFF) {
+					busState = BusState::Off;
+				}
+				else if (frame.can_id & CAN_ERR_RESTARTED) {
+					busState = BusState::Connected;
+				}
+				else if (frame.can_id & CAN_ERR_CRTL)
+				{
+					if (frame.data[1] & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE)) {
+						busState = BusState::ErrorPassive;
+					}
+					else if (frame.data[1] & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING)) {
+						busState = BusState::ErrorWarning;
+					}
+#ifdef CAN_ERR_CRTL_ACTIVE
+					else if (frame.data[1] & CAN_ERR_CRTL_ACTIVE) {
+						busState = BusState::Connected;
+					}
+#endif
+				}
+#ifdef CAN_ERR_CNT
+				if (frame.can_id & CAN_ERR_CNT)
+				{
+					transmitErrorCounter = frame.data[6];
+					receiveErrorCounter = frame.data[7];
+				}
+#endif
+			}
+			rx->begin++;
+		}
+
+		// fetch the next batch
+		for (uint8_t ii = 0; ii < BatchSize; ++ii)
+		{
+			rx->headers[ii].msg_hdr.msg_control = rx->control[ii];
+			rx->headers[ii].msg_hdr.msg_controllen = sizeof(rx->control[ii]);
+			rx->headers[ii].msg_hdr.msg_flags = 0;
+		}
+
+		int count = recvmmsg(skt, rx->headers, BatchSize, MSG_DONTWAIT, nullptr);
+		if (count <= 0)
+		{
+			// 'Resource temporary not available' if no frame is waiting
+			rx->begin = rx->end = 0;
+			return false;
+		}
+		rx->begin = 0;
+		rx->end = count;
+	}
 }
 
 bool
 xpcc::hosted::SocketCan::isMessageAvailable()
 {
-	struct can_frame frame;
-	int nbytes = recv(skt, &frame, sizeof(struct can_frame), MSG_DONTWAIT | MSG_PEEK);
+	return receive();
+}
 
-	// recv returns 'Resource temporary not available' which is wired but ignored here.
-	/* if (nbytes < 0)
-	{
-		XPCC_LOG_DEBUG << XPCC_FILE_INFO;
-		XPCC_LOG_DEBUG << strerror(errno) << xpcc::endl;
-	} */
+bool
+xpcc::hosted::SocketCan::waitForMessage(uint16_t timeout)
+{
+	if (receive()) {
+		return true;
+	}
+
+	struct pollfd fd;
+	fd.fd = skt;
+	fd.events = POLLIN;
 
-	return (nbytes > 0);
+	return (poll(&fd, 1, timeout) > 0);
 }
 
 bool
 xpcc::hosted::SocketCan::getMessage(can::Message& message)
 {
-	struct can_frame frame;
-	int nbytes = recv(skt, &frame, sizeof(struct can_frame), MSG_DONTWAIT);
+	if (not receive()) {
+		return false;
+	}
+
+	// struct can_frame and struct canfd_frame share the same layout for
+	// the first 8 data bytes, the number of bytes received tells which
+	// one it was.
+	const struct canfd_frame& frame = rx->frames[rx->begin];
+	struct msghdr& header = rx->headers[rx->begin].msg_hdr;
+	const bool fd = (rx->headers[rx->begin].msg_len == CANFD_MTU);
+	const uint8_t length = std::min<uint8_t>(frame.len, fd ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
 
-	if (nbytes > 0)
+	message.setExtended(frame.can_id & CAN_EFF_FLAG);
+	message.setRemoteTransmitRequest(frame.can_id & CAN_RTR_FLAG);
+	message.identifier = frame.can_id & (message.isExtended() ? CAN_EFF_MASK : CAN_SFF_MASK);
+	message.setFlexibleData(fd);
+	message.setBitRateSwitch(fd and (frame.flags & CANFD_BRS));
+	message.length = length;
+	for (uint8_t ii = 0; ii < length; ++ii) {
+		message.data[ii] = frame.data[ii];
+	}
+
+	message.timestamp = 0;
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr;
+			cmsg = CMSG_NXTHDR(&header, cmsg))
 	{
-		message.identifier = frame.can_id;
-		message.length = frame.can_dlc;
-		message.setExtended(frame.can_id & CAN_EFF_FLAG);
-		message.setRemoteTransmitRequest(frame.can_id & CAN_RTR_FLAG);
-		for (uint8_t ii = 0; ii < frame.can_dlc; ++ii) {
-			message.data[ii] = frame.data[ii];
+		if (cmsg->cmsg_level == SOL_SOCKET and cmsg->cmsg_type == SCM_TIMESTAMP)
+		{
+			struct timeval time;
+			memcpy(&time, CMSG_DATA(cmsg), sizeof(time));
+			message.timestamp = uint64_t(time.tv_sec) * 1000000 + time.tv_usec;
 		}
+	}
+
+	rx->begin++;
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::hosted::SocketCan::isReadyToSend()
+{
+	if (tx->end < BatchSize) {
 		return true;
 	}
-	return false;
+	flush();
+	return (tx->end < BatchSize);
 }
 
 bool
 xpcc::hosted::SocketCan::sendMessage(const can::Message& message)
 {
-	struct can_frame frame;
+	if (message.isFlexibleData() and not flexibleData)
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO;
+		XPCC_LOG_ERROR << "CAN FD is not enabled on this interface" << xpcc::endl;
+		return false;
+	}
+
+	if (not isReadyToSend()) {
+		// the kernel doesn't accept any more frames
+		return false;
+	}
+
+	struct canfd_frame& frame = tx->frames[tx->end];
+	memset(&frame, 0, sizeof(frame));
 
 	frame.can_id = message.identifier;
 	if (message.isExtended()) {
@@ -112,13 +347,69 @@ xpcc::hosted::SocketCan::sendMessage(const can::Message& message)
 		frame.can_id |= CAN_RTR_FLAG;
 	}
 
-	frame.can_dlc = message.getLength();
+	// shorter CAN FD frames are padded with zeros
+	if (message.isFlexibleData()) {
+		frame.len = can::Message::roundUpLength(message.getLength());
+		if (message.isBitRateSwitch()) {
+			frame.flags = CANFD_BRS;
+		}
+		tx->iov[tx->end].iov_len = CANFD_MTU;
+	}
+	else {
+		frame.len = message.getLength();
+		tx->iov[tx->end].iov_len = CAN_MTU;
+	}
 
 	for (uint8_t ii = 0; ii < message.getLength(); ++ii) {
 		frame.data[ii] = message.data[ii];
 	}
+	tx->end++;
+
+	if (tx->end == BatchSize) {
+		flush();
+	}
+	return true;
+}
+
+bool
+xpcc::hosted::SocketCan::flush()
+{
+	while (tx->begin < tx->end)
+	{
+		int count = sendmmsg(skt, &tx->headers[tx->begin],
+				tx->end - tx->begin, MSG_DONTWAIT);
+		if (count < 0)
+		{
+			if (errno == EAGAIN or errno == EWOULDBLOCK or errno == ENOBUFS) {
+				// transmit queue of the interface is full, try again later
+				break;
+			}
+
+			XPCC_LOG_ERROR << XPCC_FILE_INFO;
+			XPCC_LOG_ERROR << "Could not send CAN frames: " << strerror(errno) << xpcc::endl;
+			tx->begin = tx->end;
+			break;
+		}
+		tx->begin += count;
+	}
 
-	int bytes_sent = write( skt, &frame, sizeof(frame) );
+	if (tx->begin == tx->end)
+	{
+		tx->begin = tx->end = 0;
+		return true;
+	}
 
-	return (bytes_sent > 0);
+	if (tx->begin > 0)
+	{
+		// move the remaining frames to the front
+		const uint8_t remaining = tx->end - tx->begin;
+		for (uint8_t ii = 0; ii < remaining; ++ii)
+		{
+			tx->frames[ii] = tx->frames[tx->begin + ii];
+			tx->iov[ii].iov_len = tx->iov[tx->begin + ii].iov_len;
+		}
+		tx->begin = 0;
+		tx->end = remaining;
+	}
+	return false;
 }
@@ -11,6 +11,7 @@
 #define XPCC_HOSTED_SOCKETCAN_HPP
 
 #include <iostream>
+#include <memory>
 
 #include <xpcc/architecture/interface/can.hpp>
 
@@ -20,8 +21,29 @@ namespace xpcc
 namespace hosted
 {
 
+/**
+ * CAN driver for the Linux SocketCAN interface.
+ *
+ * Frames are received and sent in batches of up to `BatchSize` frames
+ * with `recvmmsg()` and `sendmmsg()`, so a busy bus costs one syscall per
+ * batch instead of two per frame. Received messages carry the kernel
+ * timestamp (`SO_TIMESTAMP`) of their reception.
+ *
+ * sendMessage() only queues the frame, the queue is passed to the kernel
+ * when it is full or flush() is called. xpcc::CanConnector calls flush()
+ * at the end of every update(). isReadyToSend() returns `false` while
+ * the queue is full and the kernel refuses further frames, e.g. because
+ * the controller is stuck in bus-off.
+ *
+ * Error frames are evaluated to report the real bus state and the error
+ * counters of the controller.
+ */
 class SocketCan : public ::xpcc::Can
 {
+public:
+	/// Number of frames received or sent with one syscall
+	static constexpr uint8_t BatchSize = 32;
+
 public:
 	SocketCan();
 
@@ -39,17 +61,83 @@ public:
 	bool
 	getMessage(can::Message& message);
 
+	/// Block until a message was received or \p timeout milliseconds have passed
+	bool
+	waitForMessage(uint16_t timeout);
+
+	/**
+	 * Socket of the interface, e.g. to wait for several interfaces with
+	 * epoll. It is readable while frames are waiting in the kernel,
+	 * frames already fetched by isMessageAvailable() are not signalled.
+	 */
+	inline int
+	getFileDescriptor() const { return skt; }
+
+	/// `false` if the transmit queue is full and can't be flushed
+	bool
+	isReadyToSend();
+
+	/**
+	 * Whether CAN FD frames can be sent and received.
+	 *
+	 * This is the case if the interface was configured for CAN FD
+	 * (MTU of `CANFD_MTU`, e.g. `ip link set can0 type can fd on`).
+	 */
 	inline bool
-	isReadyToSend() { return true; }
+	isFlexibleDataEnabled() const { return flexibleData; }
 
+	/// Bus state as reported by the last error frame of the controller
 	BusState
 	getBusState();
 
+	/// Only available if the controller reports its error counters
+	uint8_t
+	getReceiveErrorCounter();
+
+	uint8_t
+	getTransmitErrorCounter();
+
+	/// Queue a message for transmission, see flush()
 	bool
 	sendMessage(const can::Message& message);
 
+	/**
+	 * Pass all queued messages to the kernel.
+	 *
+	 * @return	`true` if the queue is empty afterwards, `false` if the
+	 * 			kernel accepted only some of the messages.
+	 */
+	bool
+	flush();
+
+	/// Number of filters passed to the kernel, limited only to keep
+	/// the filter table on the stack of the caller small
+	static constexpr uint8_t FilterCount = 64;
+
+	/**
+	 * Install acceptance filters for extended frames on the socket
+	 * (`CAN_RAW_FILTER`). An empty list accepts all frames again.
+	 */
+	bool
+	setFilters(const Filter *filters, uint8_t count);
+
 private:
+	/// Make sure a received data frame is at the front of the batch
+	bool
+	receive();
+
+	struct Batch;
+
 	int skt;
+	bool flexibleData;
+
+	BusState busState;
+	uint8_t receiveErrorCounter;
+	uint8_t transmitErrorCounter;
+
+	// holds the kernel structures, see socketcan.cpp
+	std::unique_ptr<Batch> rx;
+	std::unique_ptr<Batch> tx;
 };
 
 } // hosted namespace
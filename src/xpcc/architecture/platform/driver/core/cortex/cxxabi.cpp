@@ -76,12 +76,16 @@ extern "C"
 	}
 
 	extern void * malloc_tr(size_t, uint32_t);
+
+	// attributes the next allocation to the caller of the operator
+	extern const void * xpcc_heap_caller;
 }
 
 // ----------------------------------------------------------------------------
 void *
 operator new(size_t size) throw ()
 {
+	xpcc_heap_caller = __builtin_return_address(0);
 	void * ptr = malloc(size);
 	xpcc_assert(ptr, "core", "heap", "new", size);
 	return ptr;
@@ -90,6 +94,7 @@ operator new(size_t size) throw ()
 void *
 operator new[](size_t size) throw ()
 {
+	xpcc_heap_caller = __builtin_return_address(0);
 	void * ptr = malloc(size);
 	xpcc_assert(ptr, "core", "heap", "new", size);
 	return ptr;
@@ -98,18 +103,21 @@ operator new[](size_t size) throw ()
 void *
 operator new(size_t size, std::nothrow_t) noexcept
 {
+	xpcc_heap_caller = __builtin_return_address(0);
 	return malloc(size);
 }
 
 void *
 operator new[](size_t size, std::nothrow_t) noexcept
 {
+	xpcc_heap_caller = __builtin_return_address(0);
 	return malloc(size);
 }
 
 void *
 operator new(size_t size, xpcc::MemoryTraits traits) noexcept
 {
+	xpcc_heap_caller = __builtin_return_address(0);
 	void * ptr = malloc_tr(size, traits.value);
 	xpcc_assert(ptr, "core", "heap", "new", size);
 	return ptr;
@@ -118,6 +126,7 @@ operator new(size_t size, xpcc::MemoryTraits traits) noexcept
 void *
 operator new[](size_t size, xpcc::MemoryTraits traits) noexcept
 {
+	xpcc_heap_caller = __builtin_return_address(0);
 	void * ptr = malloc_tr(size, traits.value);
 	xpcc_assert(ptr, "core", "heap", "new", size);
 	return ptr;
@@ -126,23 +135,36 @@ operator new[](size_t size, xpcc::MemoryTraits traits) noexcept
 void
 operator delete(void *ptr) noexcept
 {
+	// free(NULL) doesn't consume the caller
+	if (ptr) {
+		xpcc_heap_caller = __builtin_return_address(0);
+	}
 	free(ptr);
 }
 
 void
 operator delete(void* ptr, size_t) noexcept
 {
+	if (ptr) {
+		xpcc_heap_caller = __builtin_return_address(0);
+	}
 	free(ptr);
 }
 
 void
 operator delete[](void* ptr) noexcept
 {
+	if (ptr) {
+		xpcc_heap_caller = __builtin_return_address(0);
+	}
 	free(ptr);
 }
 
 void
 operator delete[](void* ptr, size_t) noexcept
 {
+	if (ptr) {
+		xpcc_heap_caller = __builtin_return_address(0);
+	}
 	free(ptr);
 }
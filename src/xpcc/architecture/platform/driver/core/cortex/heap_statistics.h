@@ -0,0 +1,118 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_CORTEX_HEAP_STATISTICS_H
+#define XPCC_CORTEX_HEAP_STATISTICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <xpcc/architecture/utils.hpp>
+
+/**
+ * @ingroup		cortex
+ * @defgroup	cortex_heap_statistics	Heap statistics
+ *
+ * Usage of the heap, independent of the selected allocator (`newlib`,
+ * `tlsf` or `block_allocator`).
+ *
+ * @code
+ * xpcc_heap_statistics_t statistics;
+ * xpcc_heap_get_statistics(&statistics);
+ * XPCC_LOG_INFO << "heap: " << statistics.used << " of " << statistics.size
+ *               << " bytes used, peak " << statistics.peak << xpcc::endl;
+ * @endcode
+ *
+ * Two optional recordings are enabled with parameters of the core driver:
+ *
+ * - `heap_call_sites`: number of call sites for which the allocations are
+ *   counted. Allocations with `new` are attributed to the caller of the
+ *   operator, direct calls to `malloc()` are attributed to `malloc()`.
+ * - `heap_trace_size`: number of entries of a ring buffer, which records
+ *   every allocation and release for offline analysis. If the buffer isn't
+ *   read out in time, the oldest entries are overwritten.
+ *
+ * The sizes are usable sizes of the blocks returned by the allocator,
+ * without its management data, but including rounding to its granularity.
+ *
+ * @warning	The functions are not interrupt safe, just as the allocators.
+ */
+
+/// @ingroup cortex_heap_statistics
+typedef struct
+{
+	size_t size;				///< Bytes managed by the allocator
+	size_t used;				///< Bytes currently allocated
+	size_t peak;				///< Maximum of used since start or the last reset
+	/// Largest size which can be allocated at once. Only a lower bound
+	/// for `newlib`, which can't report free blocks below the top of
+	/// the heap.
+	size_t largest_free_block;
+	uint32_t allocations;		///< Number of currently allocated blocks
+	uint32_t failures;			///< Number of failed allocations
+} xpcc_heap_statistics_t;
+
+/// Allocations of one call site.
+/// @ingroup cortex_heap_statistics
+typedef struct
+{
+	const void *caller;			///< Return address of the allocation
+	uint32_t allocations;		///< Number of allocations since start or reset
+	uint32_t bytes;				///< Sum of requested bytes
+	uint32_t failures;			///< Number of failed allocations
+} xpcc_heap_call_site_t;
+
+/// @ingroup cortex_heap_statistics
+typedef enum
+{
+	XPCC_HEAP_ALLOCATE = 0,
+	XPCC_HEAP_FREE = 1,
+	XPCC_HEAP_FAILURE = 2,
+} xpcc_heap_operation_t;
+
+/// Entry of the allocation trace.
+/// @ingroup cortex_heap_statistics
+typedef struct
+{
+	uint32_t sequence;			///< Consecutive number, gaps show overwritten entries
+	const void *caller;			///< Return address of the call
+	const void *pointer;		///< Allocated or released block, NULL on failure
+	uint32_t size;				///< Requested bytes, usable bytes for XPCC_HEAP_FREE
+	uint8_t operation;			///< xpcc_heap_operation_t
+} xpcc_heap_trace_t;
+
+/// Current usage of the heap.
+/// @ingroup cortex_heap_statistics
+xpcc_extern_c void
+xpcc_heap_get_statistics(xpcc_heap_statistics_t *statistics);
+
+/// Restart the peak at the current usage and clear the call sites.
+/// @ingroup cortex_heap_statistics
+xpcc_extern_c void
+xpcc_heap_reset_statistics(void);
+
+/**
+ * Copy the recorded call sites, sorted by the number of allocations.
+ *
+ * @return	Number of copied call sites, always 0 if `heap_call_sites`
+ * 			is 0.
+ * @ingroup cortex_heap_statistics
+ */
+xpcc_extern_c size_t
+xpcc_heap_get_call_sites(xpcc_heap_call_site_t *sites, size_t count);
+
+/**
+ * Remove up to `count` of the oldest entries from the trace.
+ *
+ * @return	Number of copied entries, always 0 if `heap_trace_size` is 0.
+ * @ingroup cortex_heap_statistics
+ */
+xpcc_extern_c size_t
+xpcc_heap_read_trace(xpcc_heap_trace_t *entries, size_t count);
+
+#endif // XPCC_CORTEX_HEAP_STATISTICS_H
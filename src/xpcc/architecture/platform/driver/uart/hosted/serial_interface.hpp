@@ -32,6 +32,16 @@ namespace xpcc
 		 *	- Read & write, whatever you want... Note: Use bytesAvailable() before read operation.
 		 *	- close()
 		 *
+		 * Received bytes are fetched from the device in chunks into a
+		 * receive buffer, so reading single characters doesn't cost one
+		 * system call per character. Bytes the device can't take at the
+		 * moment wait in poll() instead of spinning. writeBuffered()
+		 * keeps them in a transmit buffer and returns, they are sent with
+		 * the next write or flush().
+		 *
+		 * To wait for data in an event loop, poll getFileDescriptor() for
+		 * readability after read() returned nothing.
+		 *
 		 * @author	Philipp & Metty
 		 * @ingroup	linux
 		 */
@@ -93,6 +103,7 @@ namespace xpcc
 			 * - 38400
 			 * - 57600
 			 * - 115200
+			 * - 230400, 460800 and 921600 if supported by the system
 			 */
 			bool
 			setBaudRate(unsigned int baudRate);
@@ -122,6 +133,25 @@ namespace xpcc
 			bool
 			isOpen();
 
+			/**
+			 * Let the driver pass received bytes on immediately instead of
+			 * collecting them for a few milliseconds.
+			 *
+			 * Only available on Linux for drivers supporting
+			 * `ASYNC_LOW_LATENCY` (e.g. ftdi_sio). The port has to be open.
+			 *
+			 * @return	`false` if the driver doesn't support it
+			 */
+			bool
+			setLowLatency(bool enable = true);
+
+			/// Descriptor to poll for readability, -1 if not open
+			inline int
+			getFileDescriptor() const
+			{
+				return this->isConnected ? this->fileDescriptor : -1;
+			}
+
 			/**
 			 * Read exactly one byte from device.
 			 *
@@ -131,10 +161,18 @@ namespace xpcc
 			read(char& c);
 
 
+			/**
+			 * Read up to `length` bytes without blocking.
+			 *
+			 * @return	Number of bytes read
+			 */
+			std::size_t
+			read(uint8_t* data, std::size_t length);
+
 			/**
 			 * Read length bytes from device.
 			 *
-			 * Tries until `length` bytes are read.
+			 * Waits until `length` bytes are read.
 			 */
 			void
 			readBytes(uint8_t* data, std::size_t length);
@@ -149,6 +187,30 @@ namespace xpcc
 			virtual void
 			write(const char* str);
 
+			/**
+			 * Write `length` bytes with as few system calls as possible.
+			 *
+			 * Blocks until all bytes are handed to the device.
+			 *
+			 * @return	Number of bytes written, less than `length` only
+			 * 			on errors
+			 */
+			std::size_t
+			write(const uint8_t* data, std::size_t length);
+
+			/**
+			 * Write `length` bytes, keeping what the device can't take
+			 * at the moment in the transmit buffer.
+			 *
+			 * Blocks only if the transmit buffer is full. The buffered
+			 * bytes are sent with the next write or flush().
+			 *
+			 * @return	Number of bytes written or buffered, less than
+			 * 			`length` only on errors
+			 */
+			std::size_t
+			writeBuffered(const uint8_t* data, std::size_t length);
+
 			/**
 			 * Write length bytes to device.
 			 */
@@ -161,6 +223,18 @@ namespace xpcc
 			std::size_t
 			bytesAvailable() const;
 
+			/// Number of bytes not yet passed to the device
+			inline std::size_t
+			getTransmitBufferSize() const
+			{
+				return this->transmitBuffer.size;
+			}
+
+			/// Discard the received bytes, returns their number
+			std::size_t
+			discardReceiveBuffer();
+
+			/// Block until the transmit buffer was passed to the device
 			virtual void
 			flush();
 
@@ -177,6 +251,74 @@ namespace xpcc
 			void
 			dumpErrorMessage();
 
+			/// Read once from the device into the receive buffer
+			std::size_t
+			fillReceiveBuffer();
+
+			/// Write as much of the transmit buffer as the device takes
+			bool
+			sendTransmitBuffer();
+
+			/// Wait until the device becomes readable or writable
+			bool
+			waitForDevice(short events, int timeout = -1);
+
+			/// Ring of bytes, the buffers are not shared between threads
+			struct Buffer
+			{
+				static constexpr std::size_t capacity = 4096;
+
+				Buffer() :
+					head(0), size(0)
+				{
+				}
+
+				/// Longest contiguous sequence of stored bytes
+				inline std::size_t
+				getContiguousData() const
+				{
+					std::size_t end = capacity - this->head;
+					return (this->size < end) ? this->size : end;
+				}
+
+				/// Longest contiguous sequence of free bytes
+				inline std::size_t
+				getContiguousSpace() const
+				{
+					std::size_t tail = (this->head + this->size) % capacity;
+					std::size_t end = capacity - tail;
+					std::size_t free = capacity - this->size;
+					return (free < end) ? free : end;
+				}
+
+				inline uint8_t*
+				getTail()
+				{
+					return &this->data[(this->head + this->size) % capacity];
+				}
+
+				inline void
+				clear()
+				{
+					this->head = 0;
+					this->size = 0;
+				}
+
+				inline void
+				pop(std::size_t count)
+				{
+					this->head = (this->head + count) % capacity;
+					this->size -= count;
+				}
+
+				uint8_t data[capacity];
+				std::size_t head;
+				std::size_t size;
+			};
+
+			Buffer receiveBuffer;
+			Buffer transmitBuffer;
+
 			bool 			isConnected;	///< Is there an existing connection?
 			std::string 	deviceName;		///< The port (e.g. /dev/ttyS0)
 			unsigned int 	baudRate;
@@ -8,10 +8,12 @@
 // ----------------------------------------------------------------------------
 
 #include "serial_port.hpp"
+#include <algorithm>
 #include <iostream>
 
 xpcc::hosted::SerialPort::SerialPort():
 	shutdown(true),
+	writing(false),
 	port(io_service)
 {
 }
@@ -24,7 +26,24 @@ xpcc::hosted::SerialPort::~SerialPort()
 void
 xpcc::hosted::SerialPort::write(char c)
 {
-	this->io_service.post(boost::bind(&xpcc::hosted::SerialPort::doWrite, this, c));
+	this->write(reinterpret_cast<const uint8_t*>(&c), 1);
+}
+
+void
+xpcc::hosted::SerialPort::write(const uint8_t* data, std::size_t length)
+{
+	if (this->shutdown) {
+		return;
+	}
+
+	MutexGuard mutex(this->writeMutex);
+	this->writeBuffer.insert(this->writeBuffer.end(), data, data + length);
+
+	if (not this->writing)
+	{
+		this->writing = true;
+		this->io_service.post(boost::bind(&xpcc::hosted::SerialPort::writeStart, this));
+	}
 }
 
 
@@ -46,17 +65,27 @@ xpcc::hosted::SerialPort::readStart()
 bool
 xpcc::hosted::SerialPort::read(char& value)
 {
+	MutexGuard queueGuard( this->readMutex);
 	if(this->readBuffer.empty())
 		return false;
 	else
 	{
-		MutexGuard queueGuard( this->readMutex);
 		value=this->readBuffer.front();
-		this->readBuffer.pop();
+		this->readBuffer.pop_front();
 		return true;
 	}
 }
 
+std::size_t
+xpcc::hosted::SerialPort::read(uint8_t* data, std::size_t length)
+{
+	MutexGuard queueGuard( this->readMutex);
+	length = std::min(length, this->readBuffer.size());
+	std::copy(this->readBuffer.begin(), this->readBuffer.begin() + length, data);
+	this->readBuffer.erase(this->readBuffer.begin(), this->readBuffer.begin() + length);
+	return length;
+}
+
 bool
 xpcc::hosted::SerialPort::open(std::string deviceName, unsigned int baudRate)
 {
@@ -144,34 +173,24 @@ xpcc::hosted::SerialPort::doAbort(const boost::system::error_code& error)
 void
 xpcc::hosted::SerialPort::doClose(const boost::system::error_code& error)
 {
-	if( this->writeBuffer.empty() ) {
+	MutexGuard mutex(this->writeMutex);
+	if( not this->writing ) {
 		this->doAbort(error);
 	}
 	this->shutdown = true;
 }
 
 void
-xpcc::hosted::SerialPort::doWrite(const char c) {
-	if (!this->shutdown)
+xpcc::hosted::SerialPort::writeStart(void)
+{
 	{
-		std::cout<<"get 0x"<< std::hex << (int) c << std::dec
-		<< "(" << c << ")" << std::endl;
-
 		MutexGuard mutex(this->writeMutex);
-		bool idle = this->writeBuffer.empty();
-		this->writeBuffer.push(c);
-
-		if (idle) {
-			this->writeStart();
-		}
+		this->activeWriteBuffer.swap(this->writeBuffer);
+		this->writeBuffer.clear();
 	}
-}
 
-void
-xpcc::hosted::SerialPort::writeStart(void)
-{
 	boost::asio::async_write(this->port,
-			boost::asio::buffer(&this->writeBuffer.front(), 1),
+			boost::asio::buffer(this->activeWriteBuffer),
 			boost::bind(&xpcc::hosted::SerialPort::writeComplete, this,
 					boost::asio::placeholders::error));
 }
@@ -181,13 +200,14 @@ xpcc::hosted::SerialPort::writeComplete(const boost::system::error_code& error)
 {
 	if (!error) {
 		MutexGuard mutex(this->writeMutex);
-		this->writeBuffer.pop();
 		if (!this->writeBuffer.empty()) {
-			std::cout << "restart " << this->writeBuffer.size() << std::endl;
-			this->writeStart();
+			this->io_service.post(boost::bind(&xpcc::hosted::SerialPort::writeStart, this));
 		}
-		else if (this->shutdown) {
-			this->doAbort(error);
+		else {
+			this->writing = false;
+			if (this->shutdown) {
+				this->doAbort(error);
+			}
 		}
 	}
 	else {
@@ -203,12 +223,8 @@ xpcc::hosted::SerialPort::readComplete(const boost::system::error_code& error, s
     {
     	{
 			MutexGuard queueGuard( this->readMutex);
-			for(unsigned int i=0; i<bytes_transferred; ++i)
-			{
-				std::cout<<"get 0x"<< std::hex << (int) this->tmpRead[i] << std::dec
-				<< "(" << this->tmpRead[i] << ")" << std::endl;
-				this->readBuffer.push(this->tmpRead[i]);
-			}
+			this->readBuffer.insert(this->readBuffer.end(),
+					this->tmpRead, this->tmpRead + bytes_transferred);
     	}
         this->readStart();
     }
@@ -222,15 +238,12 @@ void
 xpcc::hosted::SerialPort::clearReadBuffer()
 {
 	MutexGuard queueGuard( this->readMutex);
-	while(!this->readBuffer.empty()) {
-		this->readBuffer.pop();
-	}
+	this->readBuffer.clear();
 }
 
 void
 xpcc::hosted::SerialPort::clearWriteBuffer()
 {
-	while(!this->writeBuffer.empty()) {
-		this->writeBuffer.pop();
-	}
+	MutexGuard mutex(this->writeMutex);
+	this->writeBuffer.clear();
 }
@@ -32,7 +32,8 @@
 #define XPCC_HOSTED_SERIAL_PORT_HPP
 
 #include <string>
-#include <queue>
+#include <deque>
+#include <vector>
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
 #include <boost/thread/mutex.hpp>
@@ -49,6 +50,11 @@ namespace xpcc
 		 *
 		 * Port is closed right after construction.
 		 *
+		 * Writes are collected while the previous write is in progress and
+		 * then passed to the port at once. Received bytes are buffered by
+		 * the I/O thread, read(uint8_t*, std::size_t) takes them out in
+		 * one go.
+		 *
 		 * \ingroup	linux
 		 */
 		class SerialPort : IODevice
@@ -64,12 +70,24 @@ namespace xpcc
 			virtual void
 			write(char c);
 
+			/// Queue \p length bytes for transmission
+			void
+			write(const uint8_t* data, std::size_t length);
+
 			virtual void
 			flush();
 
 			virtual bool
 			read(char& value);
 
+			/**
+			 * Read up to \p length bytes without blocking.
+			 *
+			 * \return	Number of bytes read
+			 */
+			std::size_t
+			read(uint8_t* data, std::size_t length);
+
 			virtual bool
 			open( std::string deviceName, unsigned int baudRate );
 
@@ -99,8 +117,10 @@ namespace xpcc
 			Mutex writeMutex;
 
 			char tmpRead[512];
-			std::queue<char> writeBuffer;
-			std::queue<char> readBuffer;
+			std::vector<char> writeBuffer;		///< waiting for the current write
+			std::vector<char> activeWriteBuffer;	///< owned by the I/O thread
+			bool writing;
+			std::deque<char> readBuffer;
 
 			boost::asio::io_service  io_service;
 			boost::asio::serial_port port;
@@ -115,9 +135,6 @@ namespace xpcc
 	        void
 	        doAbort(const boost::system::error_code& error);
 
-	        void
-	        doWrite(const char c);
-
 	        void
 	        writeStart(void);
 
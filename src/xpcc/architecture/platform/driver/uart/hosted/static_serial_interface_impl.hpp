@@ -32,14 +32,14 @@ template<int N>
 void
 xpcc::hosted::StaticSerialInterface<N>::writeBlocking(uint8_t data)
 {
-	backend->write(data);
+	backend->write(&data, 1);
 }
 
 template<int N>
 void
 xpcc::hosted::StaticSerialInterface<N>::writeBlocking(const uint8_t *data, std::size_t length)
 {
-	backend->writeBytes(data, length);
+	backend->write(data, length);
 }
 
 template<int N>
@@ -53,59 +53,42 @@ template<int N>
 bool
 xpcc::hosted::StaticSerialInterface<N>::write(uint8_t data)
 {
-	backend->write(data);
-	return true;
+	return (backend->writeBuffered(&data, 1) == 1);
 }
 
 template<int N>
 std::size_t
 xpcc::hosted::StaticSerialInterface<N>::write(const uint8_t *data, std::size_t length)
 {
-	backend->writeBytes(data, length);
-	return length;
+	return backend->writeBuffered(data, length);
 }
 
 template<int N>
 bool
 xpcc::hosted::StaticSerialInterface<N>::isWriteFinished()
 {
-	return true;
+	return (backend->getTransmitBufferSize() == 0);
 }
 
 template<int N>
 bool
 xpcc::hosted::StaticSerialInterface<N>::read(uint8_t &data)
 {
-	char c;
-	if (backend->read(c)) {
-		data = static_cast<uint8_t>(c);
-		return true;
-	}
-
-	return false;
+	return (backend->read(&data, 1) == 1);
 }
 
 template<int N>
 std::size_t
 xpcc::hosted::StaticSerialInterface<N>::read(uint8_t *data, std::size_t length)
 {
-	// Check how many bytes are available before reading to
-	// avoid a blocking access.
-	std::size_t available = backend->bytesAvailable();
-	if (available < length) {
-		length = available;
-	}
-
-	backend->readBytes(data, length);
-
-	return length;
+	return backend->read(data, length);
 }
 
 template<int N>
 std::size_t
 xpcc::hosted::StaticSerialInterface<N>::discardReceiveBuffer()
 {
-	return 0;
+	return backend->discardReceiveBuffer();
 }
 
 template<int N>
@@ -14,7 +14,10 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <cstring>
+
 #include <fcntl.h>		// file control
+#include <poll.h>
 #include <sys/ioctl.h>	// I/O control routines
 #include <termios.h>	// POSIX terminal control
 #include <unistd.h>
@@ -22,11 +25,17 @@
 
 #include <errno.h>
 
+#ifdef __linux__
+#	include <linux/serial.h>
+#endif
+
 #include <xpcc/debug/logger.hpp>
 
 #undef XPCC_LOG_LEVEL
 #define XPCC_LOG_LEVEL 	xpcc::log::ERROR
 
+constexpr std::size_t xpcc::hosted::SerialInterface::Buffer::capacity;
+
 // ----------------------------------------------------------------------------
 xpcc::hosted::SerialInterface::SerialInterface() :
 	isConnected(false),
@@ -85,7 +94,17 @@ xpcc::hosted::SerialInterface::setBaudRate(unsigned int rate)
 		(rate == 19200) ? B19200 :
 		(rate == 38400) ? B38400 :
 		(rate == 57600) ? B57600 :
-		(rate == 115200) ? B115200 : B0;
+		(rate == 115200) ? B115200 :
+#ifdef B230400
+		(rate == 230400) ? B230400 :
+#endif
+#ifdef B460800
+		(rate == 460800) ? B460800 :
+#endif
+#ifdef B921600
+		(rate == 921600) ? B921600 :
+#endif
+		B0;
 
 	// Change the configuration structure
 	int result1 = cfsetispeed(&configuration, baudRateConstant);
@@ -192,7 +211,8 @@ xpcc::hosted::SerialInterface::initSerial()
 	configuration.c_iflag &= ~(INLCR | IGNCR | ICRNL); // don't do anything funny with my data :)
 	configuration.c_oflag &= ~OPOST;    // no post-processing
 	configuration.c_oflag &= ~ONLCR;    //
-//	configStatus.c_cc[VMIN] = 1;        // read() should block until a character is read
+	configuration.c_cc[VMIN] = 0;       // read() returns whatever is available ...
+	configuration.c_cc[VTIME] = 0;      // ... without waiting for more
 
 	// write new configuration
 	tcsetattr(this->fileDescriptor, TCSANOW, &configuration);
@@ -215,6 +235,16 @@ xpcc::hosted::SerialInterface::close()
 	if (this->isConnected) {
 		XPCC_LOG_INFO << "Closing port!!" << xpcc::endl;
 
+		// give the device a second to take the remaining bytes
+		while (this->sendTransmitBuffer() and this->transmitBuffer.size > 0)
+		{
+			if (not this->waitForDevice(POLLOUT, 1000)) {
+				break;
+			}
+		}
+		this->transmitBuffer.clear();
+		this->receiveBuffer.clear();
+
 		int result = ::close(this->fileDescriptor);
 		(void) result;
 
@@ -231,31 +261,104 @@ xpcc::hosted::SerialInterface::isOpen()
 
 // ----------------------------------------------------------------------------
 bool
-xpcc::hosted::SerialInterface::read(char& c)
+xpcc::hosted::SerialInterface::setLowLatency(bool enable)
 {
-	if (::read(this->fileDescriptor, &c, 1) > 0)
-	{
-		XPCC_LOG_DEBUG << "0x" << xpcc::hex << c << " " << xpcc::endl;
-		return true;
+#ifdef __linux__
+	struct serial_struct serial;
+	if (ioctl(this->fileDescriptor, TIOCGSERIAL, &serial) < 0) {
+		return false;
 	}
 
+	if (enable) {
+		serial.flags |= ASYNC_LOW_LATENCY;
+	}
+	else {
+		serial.flags &= ~ASYNC_LOW_LATENCY;
+	}
+	return (ioctl(this->fileDescriptor, TIOCSSERIAL, &serial) == 0);
+#else
+	(void) enable;
 	return false;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+std::size_t
+xpcc::hosted::SerialInterface::fillReceiveBuffer()
+{
+	std::size_t space = this->receiveBuffer.getContiguousSpace();
+	if (space == 0) {
+		return 0;
+	}
+
+	ssize_t result = ::read(this->fileDescriptor, this->receiveBuffer.getTail(), space);
+	if (result <= 0) {
+		return 0;
+	}
+	this->receiveBuffer.size += result;
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::hosted::SerialInterface::read(char& c)
+{
+	if (this->receiveBuffer.size == 0 and this->fillReceiveBuffer() == 0) {
+		return false;
+	}
+
+	c = this->receiveBuffer.data[this->receiveBuffer.head];
+	this->receiveBuffer.pop(1);
+
+	XPCC_LOG_DEBUG << "0x" << xpcc::hex << c << " " << xpcc::endl;
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t
+xpcc::hosted::SerialInterface::read(uint8_t* data, std::size_t length)
+{
+	std::size_t count = 0;
+	while (count < length)
+	{
+		if (this->receiveBuffer.size == 0)
+		{
+			// read large requests directly, small ones through the buffer
+			if ((length - count) >= Buffer::capacity)
+			{
+				ssize_t result = ::read(this->fileDescriptor, data + count, length - count);
+				if (result > 0) {
+					count += result;
+				}
+				break;
+			}
+			if (this->fillReceiveBuffer() == 0) {
+				break;
+			}
+		}
+
+		std::size_t chunk = this->receiveBuffer.getContiguousData();
+		if (chunk > (length - count)) {
+			chunk = length - count;
+		}
+		std::memcpy(data + count, &this->receiveBuffer.data[this->receiveBuffer.head], chunk);
+		this->receiveBuffer.pop(chunk);
+		count += chunk;
+	}
+	return count;
 }
 
 // ----------------------------------------------------------------------------
 void
 xpcc::hosted::SerialInterface::readBytes(uint8_t* data, std::size_t length)
 {
-	int delta = length;
-	int result = 0 ;
-	while (delta > 0)
+	std::size_t count = 0;
+	while (count < length)
 	{
-		result = ::read(this->fileDescriptor, (data + (length - delta)), delta);
-		if (result < 0) {
-			usleep(20);	// swap the thread, so that something could be done while waiting
-			continue;
+		count += this->read(data + count, length - count);
+		if (count < length and not this->waitForDevice(POLLIN)) {
+			break;
 		}
-		delta -= result;
 	}
 
 	for (std::size_t i = 0; i < length; i++) {
@@ -265,49 +368,143 @@ xpcc::hosted::SerialInterface::readBytes(uint8_t* data, std::size_t length)
 }
 
 // ----------------------------------------------------------------------------
-void
-xpcc::hosted::SerialInterface::write(char c)
+std::size_t
+xpcc::hosted::SerialInterface::discardReceiveBuffer()
 {
-/*	SUB_LOGGER_LOG(logger, Logger::ERROR, "writeByte")
-		<< "0x" << std::hex << (int)data << "; ";
- */
-	int reply;
-	// retry on EAGAIN, otherwise report error
-	// some linux rfcomm devices need this
-	while(1) {
-		reply = ::write(this->fileDescriptor, &c, 1);
-		if (reply <= 0) {
-			if (errno!=EAGAIN) {
+	std::size_t count = this->receiveBuffer.size;
+	this->receiveBuffer.clear();
+
+	uint8_t data[256];
+	ssize_t result;
+	while ((result = ::read(this->fileDescriptor, data, sizeof(data))) > 0) {
+		count += result;
+	}
+	return count;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::hosted::SerialInterface::waitForDevice(short events, int timeout)
+{
+	struct pollfd descriptor = { this->fileDescriptor, events, 0 };
+	int result;
+	do {
+		result = ::poll(&descriptor, 1, timeout);
+	}
+	while (result < 0 and errno == EINTR);
+
+	if (result == 0) {
+		return false;
+	}
+	if (result < 0 or (descriptor.revents & (POLLERR | POLLHUP | POLLNVAL))) {
+		this->dumpErrorMessage();
+		return false;
+	}
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::hosted::SerialInterface::sendTransmitBuffer()
+{
+	while (this->transmitBuffer.size > 0)
+	{
+		ssize_t result = ::write(this->fileDescriptor,
+				&this->transmitBuffer.data[this->transmitBuffer.head],
+				this->transmitBuffer.getContiguousData());
+		if (result <= 0)
+		{
+			// retry on EAGAIN, otherwise report error
+			// some linux rfcomm devices need this
+			if (result < 0 and errno != EAGAIN and errno != EINTR)
+			{
 				this->dumpErrorMessage();
-				break;
+				this->transmitBuffer.clear();
+				return false;
 			}
+			return true;
+		}
+		this->transmitBuffer.pop(result);
+	}
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t
+xpcc::hosted::SerialInterface::write(const uint8_t* data, std::size_t length)
+{
+	std::size_t count = this->writeBuffered(data, length);
+	this->flush();
+
+	// bytes still queued after an error are lost
+	const std::size_t lost = this->transmitBuffer.size;
+	this->transmitBuffer.clear();
+	return (count > lost) ? (count - lost) : 0;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t
+xpcc::hosted::SerialInterface::writeBuffered(const uint8_t* data, std::size_t length)
+{
+	if (not this->sendTransmitBuffer()) {
+		return 0;
+	}
+
+	std::size_t count = 0;
+	if (this->transmitBuffer.size == 0)
+	{
+		// nothing queued, so the order is preserved
+		ssize_t result = ::write(this->fileDescriptor, data, length);
+		if (result < 0 and errno != EAGAIN and errno != EINTR)
+		{
+			this->dumpErrorMessage();
+			return 0;
+		}
+		if (result > 0) {
+			count = result;
 		}
-		else
+	}
+
+	while (count < length)
+	{
+		std::size_t space = this->transmitBuffer.getContiguousSpace();
+		if (space == 0)
 		{
-			break;
+			if (not this->waitForDevice(POLLOUT) or not this->sendTransmitBuffer()) {
+				break;
+			}
+			continue;
 		}
+
+		if (space > (length - count)) {
+			space = length - count;
+		}
+		std::memcpy(this->transmitBuffer.getTail(), data + count, space);
+		this->transmitBuffer.size += space;
+		count += space;
 	}
-//	SUB_LOGGER_LOG( logger, Logger::DEBUG, "writeByte" )
-//		<< "0x" << std::hex << data << " => " << reply << std::dec;
+	return count;
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::hosted::SerialInterface::write(char c)
+{
+	this->write(reinterpret_cast<const uint8_t*>(&c), 1);
 }
 
 // ----------------------------------------------------------------------------
 void
 xpcc::hosted::SerialInterface::write(const char* str)
 {
-	char c;
-	while ((c = *str++)) {
-		this->write(c);
-	}
+	this->write(reinterpret_cast<const uint8_t*>(str), std::strlen(str));
 }
 
 // ----------------------------------------------------------------------------
 void
 xpcc::hosted::SerialInterface::writeBytes(const uint8_t* data, std::size_t length)
 {
-	for (std::size_t i = 0; i < length; ++i) {
-		this->write(static_cast<char>(*data++));
-	}
+	this->write(data, length);
 }
 
 // ----------------------------------------------------------------------------
@@ -358,18 +555,23 @@ xpcc::hosted::SerialInterface::dumpErrorMessage()
 std::size_t
 xpcc::hosted::SerialInterface::bytesAvailable() const
 {
-	std::size_t bytesAvailable;
+	int bytesAvailable = 0;
 
 	ioctl(this->fileDescriptor, FIONREAD, &bytesAvailable);
 
-	return bytesAvailable;
+	return this->receiveBuffer.size + bytesAvailable;
 }
 
 // ----------------------------------------------------------------------------
 void
 xpcc::hosted::SerialInterface::flush()
 {
-	// TODO flush buffers
+	while (this->sendTransmitBuffer() and this->transmitBuffer.size > 0)
+	{
+		if (not this->waitForDevice(POLLOUT)) {
+			break;
+		}
+	}
 }
 
 // ----------------------------------------------------------------------------
@@ -84,6 +84,69 @@ namespace xpcc
 
 		virtual void
 		dropPacket() = 0;
+
+		/**
+		 * \brief	Wait until a packet was received or \p timeout
+		 * 			milliseconds have passed
+		 *
+		 * Backends which receive packets in a separate thread or through
+		 * a file descriptor override this method and block, so that an
+		 * idle application does not have to poll the backend. The default
+		 * implementation returns immediately.
+		 *
+		 * \return	\c true if the backend has work to do
+		 */
+		virtual bool
+		waitForPacket(uint16_t timeout)
+		{
+			(void) timeout;
+			return this->isPacketAvailable();
+		}
+
+	public:
+		/// Header and payload of a received or transmitted message
+		struct Packet
+		{
+			Header header;
+			SmartPointer payload;
+		};
+
+		/**
+		 * \brief	Take up to \p maximum received packets from the backend
+		 *
+		 * The default implementation uses isPacketAvailable(),
+		 * getPacketHeader(), getPacketPayload() and dropPacket().
+		 * Backends which have to lock their receive queue should
+		 * override it and lock only once per call.
+		 *
+		 * \return	Number of packets written to \p packets
+		 */
+		virtual uint8_t
+		receivePackets(Packet *packets, uint8_t maximum)
+		{
+			uint8_t count = 0;
+			while (count < maximum && this->isPacketAvailable())
+			{
+				packets[count].header = this->getPacketHeader();
+				packets[count].payload = this->getPacketPayload();
+				this->dropPacket();
+				count++;
+			}
+			return count;
+		}
+
+		/**
+		 * \brief	Send \p count packets in the given order
+		 *
+		 * The default implementation calls sendPacket() for every packet.
+		 */
+		virtual void
+		sendPackets(const Packet *packets, uint8_t count)
+		{
+			for (uint8_t i = 0; i < count; ++i) {
+				this->sendPacket(packets[i].header, packets[i].payload);
+			}
+		}
 	};
 }
 
@@ -30,11 +30,15 @@
 
 #include <stdlib.h>
 
+#include <xpcc/math/utils/misc.hpp>
+#include <xpcc/math/utils/bit_operation.hpp>
+
 #include "connector.hpp"
 
 // ----------------------------------------------------------------------------
 uint8_t xpcc::CanConnectorBase::messageCounter = 0;
 
+
 // ----------------------------------------------------------------------------
 uint32_t
 xpcc::CanConnectorBase::convertToIdentifier(const Header & header,
@@ -118,9 +122,160 @@ xpcc::CanConnectorBase::convertToHeader(const uint32_t & identifier,
 }
 
 // ----------------------------------------------------------------------------
+uint16_t
+xpcc::CanConnectorBase::getNumberOfFragments(uint16_t messageSize,
+		uint8_t fragmentSize)
+{
+	return (messageSize + fragmentSize - 1) / fragmentSize;
+}
+
+// ----------------------------------------------------------------------------
+uint8_t
+xpcc::CanConnectorBase::getFragmentHeaderSize(Fragmentation fragmentation)
+{
+	return (fragmentation == Fragmentation::Legacy) ? 2 : 3;
+}
+
 uint8_t
-xpcc::CanConnectorBase::getNumberOfFragments(uint8_t messageSize)
+xpcc::CanConnectorBase::getFragmentSize(Fragmentation fragmentation,
+		bool flexibleData)
+{
+	return (flexibleData ? 64 : 8) - getFragmentHeaderSize(fragmentation);
+}
+
+uint16_t
+xpcc::CanConnectorBase::getMaximumPayloadSize(Fragmentation fragmentation,
+		bool flexibleData)
+{
+	const uint16_t fragmentSize = getFragmentSize(fragmentation, flexibleData);
+	if (fragmentation == Fragmentation::Legacy)
+	{
+		// 8 bit size field, 8 bit wide bitmask of received fragments
+		return xpcc::min<uint16_t>(255, 8 * fragmentSize);
+	}
+	else
+	{
+		// 12 bit size field, 8 bit fragment index
+		return xpcc::min<uint16_t>(4095, 256 * fragmentSize);
+	}
+}
+
+// ----------------------------------------------------------------------------
+uint8_t
+xpcc::CanConnectorBase::calculateFilters(const Postman& postman,
+		Can::Filter *filters, uint8_t maximum)
+{
+	uint8_t count = 0;
+	for (uint16_t component = 1; component <= 0xff; ++component)
+	{
+		if (postman.isComponentAvailable(component))
+		{
+			count = addFilter(filters, count, maximum,
+					XPCC_CAN_PACKET_DESTINATION(component),
+					XPCC_CAN_PACKET_DESTINATION_MASK);
+		}
+	}
+
+	for (uint16_t event = 0; event <= 0xff; ++event)
+	{
+		if (postman.isEventSubscribed(event))
+		{
+			count = addFilter(filters, count, maximum,
+					XPCC_CAN_PACKET_EVENT | XPCC_CAN_PACKET_ID(event),
+					XPCC_CAN_PACKET_EVENT_MASK |
+					XPCC_CAN_PACKET_ACKNOWLEDGE_MASK |
+					XPCC_CAN_PACKET_ID_MASK);
+		}
+	}
+
+	if (count == 0 and maximum > 0)
+	{
+		// An empty list would accept everything, use the unused
+		// packet type instead.
+		filters[0].identifier = XPCC_CAN_PACKET_TYPE_MASK;
+		filters[0].mask = XPCC_CAN_PACKET_TYPE_MASK;
+		count = 1;
+	}
+	return count;
+}
+
+uint8_t
+xpcc::CanConnectorBase::addFilter(Can::Filter *filters, uint8_t count,
+		uint8_t maximum, uint32_t identifier, uint32_t mask)
+{
+	if (maximum == 0) {
+		return 0;
+	}
+
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		if (isCovered(filters[i], identifier, mask)) {
+			// already accepted by this filter
+			return count;
+		}
+	}
+
+	if (count < maximum)
+	{
+		filters[count].identifier = identifier & mask;
+		filters[count].mask = mask;
+		return count + 1;
+	}
+
+	// No free filter: merge the two entries (including the new one)
+	// which keep most of their mask bits in common.
+	const Can::Filter added = { identifier & mask, mask };
+	uint8_t first = 0;
+	uint8_t second = count;
+	int8_t bestBits = -1;
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		for (uint8_t k = i + 1; k <= count; ++k)
+		{
+			const Can::Filter& other = (k < count) ? filters[k] : added;
+			const int8_t bits = xpcc::bitCount(static_cast<uint32_t>(
+					filters[i].mask & other.mask &
+					~(filters[i].identifier ^ other.identifier)));
+			if (bits > bestBits)
+			{
+				first = i;
+				second = k;
+				bestBits = bits;
+			}
+		}
+	}
+
+	const Can::Filter& other = (second < count) ? filters[second] : added;
+	filters[first].mask &= other.mask & ~(filters[first].identifier ^ other.identifier);
+	filters[first].identifier &= filters[first].mask;
+	if (second < count) {
+		// the freed entry takes the new filter
+		filters[second] = added;
+	}
+
+	// remove the filters which are now covered by the merged one
+	const Can::Filter merged = filters[first];
+	for (uint8_t i = 0; i < count; )
+	{
+		if (i != first and isCovered(merged, filters[i].identifier, filters[i].mask))
+		{
+			count--;
+			filters[i] = filters[count];
+			if (first == count) {
+				first = i;
+			}
+		}
+		else {
+			i++;
+		}
+	}
+	return count;
+}
+
+bool
+xpcc::CanConnectorBase::isCovered(const Can::Filter& filter,
+		uint32_t identifier, uint32_t mask)
 {
-	div_t n = div(messageSize, 6);
-	return (n.rem > 0) ? n.quot + 1 : n.quot;
+	return ((filter.mask & mask) == filter.mask and
+			((filter.identifier ^ identifier) & filter.mask) == 0);
 }
@@ -31,8 +31,12 @@
 #ifndef	XPCC__CAN_CONNECTOR_HPP
 #define	XPCC__CAN_CONNECTOR_HPP
 
-#include <xpcc/container/linked_list.hpp>
+#include <xpcc/container/intrusive_linked_list.hpp>
+#include <xpcc/utils/allocator.hpp>
+#include <xpcc/processing/timer/timeout.hpp>
+#include <xpcc/architecture/interface/can.hpp>
 #include "../backend_interface.hpp"
+#include "../../postman/postman.hpp"
 
 // Filter
 #define XPCC_CAN_PACKET_DESTINATION(x)		(static_cast<uint32_t>(x) << 16)
@@ -58,6 +62,66 @@ namespace xpcc
 {
 	class CanConnectorBase
 	{
+	public:
+		/**
+		 * \brief	Format of the fragments of packets longer than 8 bytes
+		 *
+		 * Both sides of a bus need to use the same format.
+		 */
+		enum class Fragmentation : uint8_t
+		{
+			/**
+			 * 2 byte fragment header (fragment index and message counter,
+			 * total size), up to 8 fragments which may arrive in any
+			 * order. Limits packets to 48 bytes with classic CAN frames.
+			 */
+			Legacy,
+
+			/**
+			 * 3 byte fragment header (fragment index, message counter and
+			 * 12 bit total size), up to 256 fragments which have to
+			 * arrive in order. Allows packets of up to 1280 bytes with
+			 * classic CAN frames and 4095 bytes with CAN FD frames.
+			 */
+			Extended,
+		};
+
+		/// Counters of the reassembly of fragmented packets
+		struct ReassemblyStatistics
+		{
+			ReassemblyStatistics() :
+				completed(0), expired(0), evicted(0), discarded(0)
+			{
+			}
+
+			/// Number of completely received packets
+			uint32_t completed;
+			/// Incomplete packets removed after their timeout
+			uint32_t expired;
+			/// Incomplete packets removed to make room for a new one
+			uint32_t evicted;
+			/// Invalid or unexpected fragments
+			uint32_t discarded;
+		};
+
+		/// Counters of the transmitted packets
+		struct TransmitStatistics
+		{
+			TransmitStatistics() :
+				sent(0), dropped(0), queueLength(0), peakQueueLength(0)
+			{
+			}
+
+			/// Packets completely handed to the driver
+			uint32_t sent;
+			/// Packets too large to be sent or dropped while the bus was off
+			uint32_t dropped;
+			/// Packets currently waiting for the driver
+			uint16_t queueLength;
+			/// Highest number of packets waiting for the driver
+			uint16_t peakQueueLength;
+		};
+
 	public:
 		/// Convert a packet header to a can identifier
 		static uint32_t
@@ -86,8 +150,49 @@ namespace xpcc
 		 * \brief	Calculate the number of fragments needed to send a message
 		 * 			with a length of \p messageSize.
 		 */
+		static uint16_t
+		getNumberOfFragments(uint16_t messageSize, uint8_t fragmentSize = 6);
+
+		/// Size of the header in front of the data of each fragment
 		static uint8_t
-		getNumberOfFragments(uint8_t messageSize);
+		getFragmentHeaderSize(Fragmentation fragmentation);
+
+		/// Number of payload bytes per fragment
+		static uint8_t
+		getFragmentSize(Fragmentation fragmentation, bool flexibleData);
+
+		/// Maximum size of a packet which can be sent with fragments
+		static uint16_t
+		getMaximumPayloadSize(Fragmentation fragmentation, bool flexibleData);
+
+		/**
+		 * \brief	Calculate the acceptance filters for the components and
+		 * 			events known to \p postman
+		 *
+		 * Every component gets a filter for all packets addressed to it,
+		 * every subscribed event one for the event with its identifier.
+		 * If there are more than \p maximum filters needed, the two
+		 * filters with most mask bits in common are merged. The result
+		 * therefore always accepts a superset of the needed packets.
+		 *
+		 * \param[in]	postman	Postman of this board
+		 * \param[out]	filters	Array with room for \p maximum filters
+		 * \param[in]	maximum	Number of filters supported by the hardware
+		 *
+		 * \return	Number of used filters
+		 */
+		static uint8_t
+		calculateFilters(const Postman& postman,
+				Can::Filter *filters, uint8_t maximum);
+
+	protected:
+		static uint8_t
+		addFilter(Can::Filter *filters, uint8_t count, uint8_t maximum,
+				uint32_t identifier, uint32_t mask);
+
+		/// Check if \p filter accepts everything accepted by \p identifier and \p mask
+		static bool
+		isCovered(const Can::Filter& filter, uint32_t identifier, uint32_t mask);
 
 	protected:
 		static uint8_t messageCounter;
@@ -119,6 +224,54 @@ namespace xpcc
 	 * sendMessage(const can::Message& message);
 	 * \endcode
 	 *
+	 * Drivers on hosted targets may additionally provide the following
+	 * method, which is then used by waitForPacket().
+	 *
+	 * \code
+	 * /// Block until a message was received or the timeout (in ms) expired.
+	 * /// \return true if a message is available, false otherwise
+	 * bool
+	 * waitForMessage(uint16_t timeout);
+	 * \endcode
+	 *
+	 * If the driver provides the following method and it returns \c true,
+	 * packets longer than 8 bytes are sent as CAN FD frames with up to
+	 * 62 bytes of payload per fragment.
+	 *
+	 * \code
+	 * bool
+	 * isFlexibleDataEnabled();
+	 * \endcode
+	 *
+	 * update() sends as many waiting frames as the driver accepts.
+	 * Drivers which collect frames to send them in batches provide
+	 * the following method, which is called at the end of update().
+	 *
+	 * \code
+	 * void
+	 * flush();
+	 * \endcode
+	 *
+	 * Drivers with hardware acceptance filters (see xpcc::Can::Filter)
+	 * provide the following members, which are used by
+	 * setAcceptanceFilters().
+	 *
+	 * \code
+	 * static constexpr uint8_t FilterCount;
+	 *
+	 * void
+	 * setFilters(const xpcc::Can::Filter *filters, uint8_t count);
+	 * \endcode
+	 *
+	 * \section reassembly Reassembly of fragmented packets
+	 *
+	 * Fragments are collected in a table with \p ReassemblySlots entries
+	 * which is indexed by the header of the packet and the message counter.
+	 * A packet which received no fragment for the reassembly timeout is
+	 * removed, as is the oldest incomplete packet if a new one doesn't fit
+	 * into the table any more. Memory and lookup time are therefore bounded
+	 * on a lossy bus. See getReassemblyStatistics().
+	 *
 	 * \section structure Definition of the structure of a CAN message
 	 *
 	 * \image html xpcc_can_identifier.png
@@ -130,13 +283,20 @@ namespace xpcc
 	 *
 	 * Every event is send with the destination identifier \c 0x00.
 	 *
-	 * \todo timeout
-	 *
 	 * \ingroup	backend
 	 */
-	template <typename Driver>
+	template <typename Driver, uint8_t ReassemblySlots = 8>
 	class CanConnector : protected CanConnectorBase, public BackendInterface
 	{
+		static_assert(ReassemblySlots > 0 and
+				(ReassemblySlots & (ReassemblySlots - 1)) == 0,
+				"ReassemblySlots must be a power of two!");
+
+	public:
+		using CanConnectorBase::Fragmentation;
+		using CanConnectorBase::ReassemblyStatistics;
+		using CanConnectorBase::TransmitStatistics;
+
 	public:
 		CanConnector(Driver *driver);
 
@@ -159,16 +319,70 @@ namespace xpcc
 		virtual void
 		dropPacket();
 
+		virtual bool
+		waitForPacket(uint16_t timeout);
+
 
 		virtual void
 		update();
 
+
+		/// Select the format of fragmented packets, defaults to Fragmentation::Legacy
+		void
+		setFragmentation(Fragmentation fragmentation);
+
+		inline Fragmentation
+		getFragmentation() const
+		{
+			return this->fragmentation;
+		}
+
+		/// Time in milliseconds after which an incomplete packet is dropped
+		inline void
+		setReassemblyTimeout(uint16_t timeout)
+		{
+			this->reassemblyTimeout = timeout;
+		}
+
+		inline const ReassemblyStatistics&
+		getReassemblyStatistics() const
+		{
+			return this->reassemblyStatistics;
+		}
+
+		inline const TransmitStatistics&
+		getTransmitStatistics() const
+		{
+			return this->transmitStatistics;
+		}
+
+		/// Number of packets waiting for the driver
+		inline uint16_t
+		getSendQueueSize() const
+		{
+			return this->transmitStatistics.queueLength;
+		}
+
+		/**
+		 * \brief	Program the acceptance filters of the driver
+		 *
+		 * Afterwards only packets for the components and events known
+		 * to \p postman (see calculateFilters()) are received. Call it
+		 * again whenever components or event listeners are added.
+		 *
+		 * \return	\c false if the driver doesn't support filters
+		 */
+		bool
+		setAcceptanceFilters(const Postman& postman);
+
 	protected:
 		CanConnector(const CanConnector&);
 
 		CanConnector&
 		operator = (const CanConnector&);
 
+		class SendListItem;
+
 		/**
 		 * \brief	Try to send a CAN message via CAN Driver
 		 *
@@ -176,16 +390,51 @@ namespace xpcc
 		 */
 		bool
 		sendMessage(const uint32_t & identifier,
-				const uint8_t *data, uint8_t size);
+				const uint8_t *data, uint8_t size, bool flexibleData = false);
 
 		void
 		sendWaitingMessages();
 
+		/**
+		 * \brief	Send the next frame of \p message
+		 *
+		 * \return	\b true if the frame could be send, \b false otherwise
+		 */
+		bool
+		sendNextFrame(SendListItem& message);
+
+		/// Remove the first packet of the send list
+		void
+		removeWaitingMessage(bool sent);
+
+		class ReceiveListItem;
+
+		/// Append a packet to the list of received packets
+		ReceiveListItem *
+		appendReceivedMessage(const Header& header, const SmartPointer& payload);
+
 		bool
 		retrieveMessage();
 
+		class ReassemblySlot;
+
+		/**
+		 * \brief	Find the slot for a packet or allocate a new one
+		 *
+		 * If the table is full the oldest incomplete packet is evicted.
+		 */
+		ReassemblySlot&
+		getReassemblySlot(const Header& header, uint8_t counter);
+
+		void
+		releaseReassemblySlot(ReassemblySlot& slot);
+
+		/// Remove all incomplete packets whose timeout expired
+		void
+		removeExpiredReassemblies();
+
 	protected:
-		class SendListItem
+		class SendListItem : public IntrusiveLinkedListHook<>
 		{
 		public:
 			SendListItem(const uint32_t & inIdentifier,
@@ -213,43 +462,68 @@ namespace xpcc
 			operator = (const SendListItem& other);
 		};
 
-		class ReceiveListItem
+		class ReceiveListItem : public IntrusiveLinkedListHook<>
 		{
 		public:
-			ReceiveListItem(uint8_t size, const Header& inHeader,
-					uint8_t messageCounter = 0) :
-				header(inHeader), payload(size),
-				receivedFragments(0),
-				counter(messageCounter)
+			ReceiveListItem(const Header& inHeader,
+					const SmartPointer& inPayload) :
+				header(inHeader), payload(inPayload)
 			{
 			}
 
 			ReceiveListItem(const ReceiveListItem& other) :
-				header(other.header), payload(other.payload),
-				receivedFragments(other.receivedFragments),
-				counter(other.counter)
+				header(other.header), payload(other.payload)
 			{
 			}
 
 			Header header;
 			SmartPointer payload;
 
-			uint8_t receivedFragments;
-			const uint8_t counter;
-
 		private:
 			ReceiveListItem&
 			operator = (const ReceiveListItem& other);
 		};
 
-		typedef xpcc::LinkedList< SendListItem > SendList;
-		typedef xpcc::LinkedList< ReceiveListItem > ReceiveList;
+		class ReassemblySlot
+		{
+		public:
+			ReassemblySlot() :
+				counter(0), receivedFragments(0), used(false)
+			{
+			}
+
+			Header header;
+			SmartPointer payload;
+			xpcc::ShortTimeout timeout;
+
+			uint8_t counter;
+
+			/// Bitmask of the received fragments for Fragmentation::Legacy,
+			/// number of received fragments for Fragmentation::Extended
+			uint8_t receivedFragments;
+			bool used;
+		};
+
+		typedef xpcc::IntrusiveLinkedList< SendListItem > SendList;
+		typedef xpcc::IntrusiveLinkedList< ReceiveListItem > ReceiveList;
 
 	protected:
 		SendList sendList;
-		ReceiveList pendingMessages;
 		ReceiveList receivedMessages;
 
+		// Items are recycled in pools instead of being freed after every
+		// packet, the heap is only touched when a pool grows.
+		allocator::Block< SendListItem, 4 > sendItems;
+		allocator::Block< ReceiveListItem, 4 > receiveItems;
+
+		ReassemblySlot reassemblyTable[ReassemblySlots];
+		uint8_t usedReassemblySlots;
+		uint16_t reassemblyTimeout;
+		ReassemblyStatistics reassemblyStatistics;
+		TransmitStatistics transmitStatistics;
+
+		Fragmentation fragmentation;
+
 		Driver *canDriver;
 	};
 }
@@ -36,47 +36,146 @@
 #include <xpcc/architecture/interface/can_message.hpp>
 
 // ----------------------------------------------------------------------------
-template<typename Driver>
-xpcc::CanConnector<Driver>::CanConnector(Driver *driver) :
+namespace xpcc
+{
+	namespace can_connector
+	{
+		// used if the driver is able to block until a message arrives
+		template<typename Driver>
+		auto
+		waitForMessage(Driver *driver, uint16_t timeout, int)
+				-> decltype(driver->waitForMessage(timeout))
+		{
+			return driver->waitForMessage(timeout);
+		}
+
+		template<typename Driver>
+		bool
+		waitForMessage(Driver *driver, uint16_t, long)
+		{
+			return driver->isMessageAvailable();
+		}
+
+		// used if the driver is able to send and receive CAN FD frames
+		template<typename Driver>
+		auto
+		isFlexibleDataEnabled(Driver *driver, int)
+				-> decltype(driver->isFlexibleDataEnabled())
+		{
+			return driver->isFlexibleDataEnabled();
+		}
+
+		template<typename Driver>
+		bool
+		isFlexibleDataEnabled(Driver *, long)
+		{
+			return false;
+		}
+
+		// used if the driver queues frames until they are flushed
+		template<typename Driver>
+		auto
+		flush(Driver *driver, int)
+				-> decltype(driver->flush(), void())
+		{
+			driver->flush();
+		}
+
+		template<typename Driver>
+		void
+		flush(Driver *, long)
+		{
+		}
+
+		// used if the driver has hardware acceptance filters
+		template<typename Driver>
+		auto
+		setFilters(Driver *driver, const Postman& postman, int)
+				-> decltype(driver->setFilters(
+						static_cast<const Can::Filter *>(nullptr), 0), bool())
+		{
+			Can::Filter filters[Driver::FilterCount];
+			uint8_t count = CanConnectorBase::calculateFilters(postman,
+					filters, Driver::FilterCount);
+			driver->setFilters(filters, count);
+			return true;
+		}
+
+		template<typename Driver>
+		bool
+		setFilters(Driver *, const Postman&, long)
+		{
+			return false;
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+template<typename Driver, uint8_t ReassemblySlots>
+xpcc::CanConnector<Driver, ReassemblySlots>::CanConnector(Driver *driver) :
+	usedReassemblySlots(0), reassemblyTimeout(100),
+	fragmentation(Fragmentation::Legacy),
 	canDriver(driver)
 {
 }
 
-template<typename Driver>
-xpcc::CanConnector<Driver>::~CanConnector()
+template<typename Driver, uint8_t ReassemblySlots>
+xpcc::CanConnector<Driver, ReassemblySlots>::~CanConnector()
 {
+	while (!this->sendList.isEmpty()) {
+		this->removeWaitingMessage(false);
+	}
+	while (!this->receivedMessages.isEmpty()) {
+		this->dropPacket();
+	}
 }
 
 // ----------------------------------------------------------------------------
-template<typename Driver>
+template<typename Driver, uint8_t ReassemblySlots>
 bool
-xpcc::CanConnector<Driver>::isPacketAvailable() const
+xpcc::CanConnector<Driver, ReassemblySlots>::setAcceptanceFilters(const Postman& postman)
+{
+	return can_connector::setFilters(this->canDriver, postman, 0);
+}
+
+// ----------------------------------------------------------------------------
+template<typename Driver, uint8_t ReassemblySlots>
+bool
+xpcc::CanConnector<Driver, ReassemblySlots>::isPacketAvailable() const
 {
 	return !this->receivedMessages.isEmpty();
 }
 
-template<typename Driver>
+template<typename Driver, uint8_t ReassemblySlots>
 const xpcc::Header&
-xpcc::CanConnector<Driver>::getPacketHeader() const
+xpcc::CanConnector<Driver, ReassemblySlots>::getPacketHeader() const
 {
-	return this->receivedMessages.getFront().header;
+	return this->receivedMessages.getFront()->header;
 }
 
-template<typename Driver>
+template<typename Driver, uint8_t ReassemblySlots>
 const xpcc::SmartPointer
-xpcc::CanConnector<Driver>::getPacketPayload() const
+xpcc::CanConnector<Driver, ReassemblySlots>::getPacketPayload() const
 {
-	return this->receivedMessages.getFront().payload;
+	return this->receivedMessages.getFront()->payload;
 }
 
 // ----------------------------------------------------------------------------
-template<typename Driver>
+template<typename Driver, uint8_t ReassemblySlots>
 void
-xpcc::CanConnector<Driver>::sendPacket(const Header &header, SmartPointer payload)
+xpcc::CanConnector<Driver, ReassemblySlots>::sendPacket(const Header &header, SmartPointer payload)
 {
 	bool successful = false;
 	bool fragmented = (payload.getSize() > 8);
 
+	if (fragmented && payload.getSize() > getMaximumPayloadSize(this->fragmentation,
+			can_connector::isFlexibleDataEnabled(this->canDriver, 0)))
+	{
+		// the packet can't be described by the fragment header
+		this->transmitStatistics.dropped++;
+		return;
+	}
+
 	uint32_t identifier = convertToIdentifier(header, fragmented);
 	if (!fragmented && this->canDriver->isReadyToSend())
 	{
@@ -88,210 +187,447 @@ xpcc::CanConnector<Driver>::sendPacket(const Header &header, SmartPointer payloa
 	if (!successful)
 	{
 		// append the message to the list of waiting messages
-		this->sendList.append(SendListItem(identifier, payload));
+		SendListItem *item = this->sendItems.allocate(1);
+		if (item == nullptr) {
+			this->transmitStatistics.dropped++;
+			return;
+		}
+		this->sendList.append(*new (item) SendListItem(identifier, payload));
+
+		TransmitStatistics& statistics = this->transmitStatistics;
+		statistics.queueLength++;
+		if (statistics.queueLength > statistics.peakQueueLength) {
+			statistics.peakQueueLength = statistics.queueLength;
+		}
+	}
+	else {
+		this->transmitStatistics.sent++;
 	}
 }
 
 // ----------------------------------------------------------------------------
-template<typename Driver>
+template<typename Driver, uint8_t ReassemblySlots>
 void
-xpcc::CanConnector<Driver>::dropPacket()
+xpcc::CanConnector<Driver, ReassemblySlots>::dropPacket()
 {
-	this->receivedMessages.removeFront();
+	ReceiveListItem *item = this->receivedMessages.removeFront();
+	item->~ReceiveListItem();
+	this->receiveItems.deallocate(item);
+}
+
+template<typename Driver, uint8_t ReassemblySlots>
+bool
+xpcc::CanConnector<Driver, ReassemblySlots>::waitForPacket(uint16_t timeout)
+{
+	// fragments waiting for transmission have to be handled by update()
+	if (!this->receivedMessages.isEmpty() || !this->sendList.isEmpty()) {
+		return true;
+	}
+	return can_connector::waitForMessage(this->canDriver, timeout, 0);
 }
 
 // ----------------------------------------------------------------------------
-template<typename Driver>
+template<typename Driver, uint8_t ReassemblySlots>
 void
-xpcc::CanConnector<Driver>::update()
+xpcc::CanConnector<Driver, ReassemblySlots>::update()
 {
+	this->removeExpiredReassemblies();
+
 	while (this->canDriver->isMessageAvailable()) {
 		this->retrieveMessage();
 	}
 	this->sendWaitingMessages();
+	can_connector::flush(this->canDriver, 0);
+}
+
+// ----------------------------------------------------------------------------
+template<typename Driver, uint8_t ReassemblySlots>
+void
+xpcc::CanConnector<Driver, ReassemblySlots>::setFragmentation(Fragmentation fragmentation)
+{
+	if (this->fragmentation != fragmentation)
+	{
+		// fragments of the other format can't be completed any more
+		for (ReassemblySlot& slot : this->reassemblyTable)
+		{
+			if (slot.used) {
+				this->releaseReassemblySlot(slot);
+			}
+		}
+		this->fragmentation = fragmentation;
+	}
 }
 
 // ----------------------------------------------------------------------------
 // protected
 // ----------------------------------------------------------------------------
 
-template<typename Driver>
+template<typename Driver, uint8_t ReassemblySlots>
 bool
-xpcc::CanConnector<Driver>::sendMessage(const uint32_t & identifier,
-		const uint8_t *data, uint8_t size)
+xpcc::CanConnector<Driver, ReassemblySlots>::sendMessage(const uint32_t & identifier,
+		const uint8_t *data, uint8_t size, bool flexibleData)
 {
 	xpcc::can::Message message(identifier, size);
 
 	// copy payload data
 	std::memcpy(message.data, data, size);
 
+	if (flexibleData)
+	{
+		// pad the frame to the next valid CAN FD length
+		message.setFlexibleData();
+		message.length = can::Message::roundUpLength(size);
+		std::memset(message.data + size, 0, message.length - size);
+	}
+
 	return this->canDriver->sendMessage(message);
 }
 
-template<typename Driver>
+template<typename Driver, uint8_t ReassemblySlots>
 void
-xpcc::CanConnector<Driver>::sendWaitingMessages()
+xpcc::CanConnector<Driver, ReassemblySlots>::sendWaitingMessages()
 {
 	if (this->sendList.isEmpty()) {
 		// no message in the queue
 		return;
 	}
-	else if (canDriver->getBusState() != Driver::BusState::Connected) {
-		// No connection to the CAN bus, drop all messages which should be send
+	else if (canDriver->getBusState() == Driver::BusState::Off) {
+		// No connection to the CAN bus, drop all messages which should be send.
+		// In the error warning and error passive states the controller
+		// is still able to send, the driver refuses frames if it can't
+		// keep up.
 		while (!sendList.isEmpty()) {
-			sendList.removeFront();
+			this->removeWaitingMessage(false);
 		}
 		return;
 	}
 
-	SendListItem& message = this->sendList.getFront();
+	// send as many frames as the driver accepts
+	while (!this->sendList.isEmpty() &&
+			this->sendNextFrame(*this->sendList.getFront()))
+	{
+	}
+}
 
-	uint8_t messageSize = message.payload.getSize();
+template<typename Driver, uint8_t ReassemblySlots>
+bool
+xpcc::CanConnector<Driver, ReassemblySlots>::sendNextFrame(SendListItem& message)
+{
+	uint16_t messageSize = message.payload.getSize();
 	if (messageSize > 8)
 	{
 		// fragmented message
-		uint8_t data[8];
+		const bool flexibleData = can_connector::isFlexibleDataEnabled(this->canDriver, 0);
+		const uint8_t headerSize = getFragmentHeaderSize(this->fragmentation);
+		const uint8_t maximumFragmentSize = getFragmentSize(this->fragmentation, flexibleData);
 
-		data[0] = message.fragmentIndex | (this->messageCounter & 0xf0);
-		data[1] = messageSize; 	// size of the complete message
+		uint8_t data[64];
+		if (this->fragmentation == Fragmentation::Legacy)
+		{
+			data[0] = message.fragmentIndex | (this->messageCounter & 0xf0);
+			data[1] = messageSize; 	// size of the complete message
+		}
+		else
+		{
+			data[0] = message.fragmentIndex;
+			data[1] = (this->messageCounter & 0xf0) | (messageSize >> 8);
+			data[2] = messageSize;
+		}
 
 		bool sendFinished = true;
-		uint8_t offset = message.fragmentIndex * 6;
-		uint8_t fragmentSize = messageSize - offset;
-		if (fragmentSize > 6)
+		uint16_t offset = message.fragmentIndex * maximumFragmentSize;
+		uint16_t fragmentSize = messageSize - offset;
+		if (fragmentSize > maximumFragmentSize)
 		{
-			fragmentSize = 6;
+			fragmentSize = maximumFragmentSize;
 			sendFinished = false;
 		}
-		// otherwise fragmentSize is smaller or equal to six, so the last
-		// fragment is about to be sent.
+		// otherwise this is the last fragment
 
-		memcpy(data + 2, message.payload.getPointer() + offset, fragmentSize);
+		memcpy(data + headerSize, message.payload.getPointer() + offset, fragmentSize);
 
-		if (sendMessage(message.identifier, data, fragmentSize + 2))
+		if (!sendMessage(message.identifier, data, fragmentSize + headerSize, flexibleData)) {
+			return false;
+		}
+
+		message.fragmentIndex++;
+		if (sendFinished)
 		{
-			message.fragmentIndex++;
-			if (sendFinished)
-			{
-				// message was the last fragment
-				// => remove it from the list
-				this->sendList.removeFront();
-				this->messageCounter += 0x10;
-			}
+			// message was the last fragment
+			// => remove it from the list
+			this->removeWaitingMessage(true);
+			this->messageCounter += 0x10;
 		}
+		return true;
 	}
 	else
 	{
-		if (this->sendMessage(message.identifier, message.payload.getPointer(),
+		if (!this->sendMessage(message.identifier, message.payload.getPointer(),
 				messageSize))
 		{
-			this->sendList.removeFront();
+			return false;
 		}
+		this->removeWaitingMessage(true);
+		return true;
+	}
+}
+
+template<typename Driver, uint8_t ReassemblySlots>
+void
+xpcc::CanConnector<Driver, ReassemblySlots>::removeWaitingMessage(bool sent)
+{
+	SendListItem *item = this->sendList.removeFront();
+	item->~SendListItem();
+	this->sendItems.deallocate(item);
+
+	this->transmitStatistics.queueLength--;
+	if (sent) {
+		this->transmitStatistics.sent++;
+	}
+	else {
+		this->transmitStatistics.dropped++;
 	}
 }
 
-template<typename Driver>
+template<typename Driver, uint8_t ReassemblySlots>
+typename xpcc::CanConnector<Driver, ReassemblySlots>::ReceiveListItem *
+xpcc::CanConnector<Driver, ReassemblySlots>::appendReceivedMessage(
+		const Header& header, const SmartPointer& payload)
+{
+	ReceiveListItem *item = this->receiveItems.allocate(1);
+	if (item != nullptr) {
+		this->receivedMessages.append(*new (item) ReceiveListItem(header, payload));
+	}
+	return item;
+}
+
+template<typename Driver, uint8_t ReassemblySlots>
 bool
-xpcc::CanConnector<Driver>::retrieveMessage()
+xpcc::CanConnector<Driver, ReassemblySlots>::retrieveMessage()
 {
 	can::Message message;
-	if (this->canDriver->getMessage(message))
+	if (!this->canDriver->getMessage(message)) {
+		return false;
+	}
+
+	xpcc::Header header;
+	bool isFragment = convertToHeader(message.identifier, header);
+
+	if (!isFragment)
 	{
-		xpcc::Header header;
-		bool isFragment = convertToHeader(message.identifier, header);
+		ReceiveListItem *item = this->appendReceivedMessage(header,
+				SmartPointer(message.length));
+		if (item != nullptr) {
+			std::memcpy(item->payload.getPointer(), message.data, message.length);
+		}
+		return true;
+	}
+
+	// decode the fragment header
+	const uint8_t headerSize = getFragmentHeaderSize(this->fragmentation);
+	uint8_t fragmentIndex;
+	uint8_t counter;
+	uint16_t messageSize;
+	if (this->fragmentation == Fragmentation::Legacy)
+	{
+		fragmentIndex = message.data[0] & 0x0f;
+		counter = message.data[0] & 0xf0;
+		messageSize = message.data[1];
+	}
+	else
+	{
+		fragmentIndex = message.data[0];
+		counter = message.data[1] & 0xf0;
+		messageSize = ((message.data[1] & 0x0f) << 8) | message.data[2];
+	}
+
+	// CAN FD frames carry more bytes per fragment
+	const bool flexibleData = message.isFlexibleData();
+	const uint8_t maximumFragmentSize = getFragmentSize(this->fragmentation, flexibleData);
+
+	// calculate the number of messages need to send messageSize-bytes
+	const uint16_t numberOfFragments = this->getNumberOfFragments(messageSize,
+			maximumFragmentSize);
 
-		if (!isFragment)
+	if (message.length <= headerSize || messageSize <= 8 ||
+			messageSize > getMaximumPayloadSize(this->fragmentation, flexibleData) ||
+			fragmentIndex >= numberOfFragments)
+	{
+		// illegal format:
+		//   fragmented messages need to have at least one byte payload,
+		// 	 the size must fit into the fragments and the fragment number
+		//	 should not be higher than the number of fragments.
+		this->reassemblyStatistics.discarded++;
+		return false;
+	}
+
+	// check the length of the fragment (all fragments except the
+	// last one need to be completely filled, CAN FD frames may be padded)
+	const uint16_t offset = fragmentIndex * maximumFragmentSize;
+	uint8_t fragmentSize = maximumFragmentSize;
+	if (fragmentIndex + 1 == numberOfFragments)
+	{
+		// this one is the last fragment
+		fragmentSize = messageSize - offset;
+	}
+
+	const uint8_t expectedLength = flexibleData ?
+			can::Message::roundUpLength(fragmentSize + headerSize) :
+			(fragmentSize + headerSize);
+	if (message.length != expectedLength)
+	{
+		// illegal format
+		this->reassemblyStatistics.discarded++;
+		return false;
+	}
+
+	ReassemblySlot& slot = this->getReassemblySlot(header, counter);
+	if (slot.receivedFragments != 0 && slot.payload.getSize() != messageSize)
+	{
+		// fragment of a different message with the same header and
+		// counter -> most likely the old one was lost
+		this->reassemblyStatistics.discarded++;
+		slot.receivedFragments = 0;
+	}
+
+	bool complete;
+	if (this->fragmentation == Fragmentation::Legacy)
+	{
+		// create a marker for the currently received fragment and
+		// test if the fragment was already received
+		const uint8_t currentFragment = (1 << fragmentIndex);
+		if (currentFragment & slot.receivedFragments)
 		{
-			this->receivedMessages.append(ReceiveListItem(message.length, header));
-			std::memcpy(this->receivedMessages.getBack().payload.getPointer(),
-					message.data,
-					message.length);
+			// error: received fragment twice -> most likely a new message -> delete the old one
+			this->reassemblyStatistics.discarded++;
+			slot.receivedFragments = 0;
 		}
-		else
+		if (slot.receivedFragments == 0) {
+			slot.payload = SmartPointer(messageSize);
+		}
+		slot.receivedFragments |= currentFragment;
+
+		complete = (xpcc::bitCount(slot.receivedFragments) == numberOfFragments);
+	}
+	else
+	{
+		// fragments have to arrive in order, the first one starts a new message
+		if (fragmentIndex == 0)
 		{
-			// find existing container otherwise create a new one
-			const uint8_t fragmentIndex = message.data[0] & 0x0f;
-			const uint8_t counter = message.data[0] & 0xf0;
-			const uint8_t messageSize = message.data[1];
-
-			// calculate the number of messages need to send messageSize-bytes
-			uint8_t numberOfFragments = this->getNumberOfFragments(messageSize);
-
-			if (message.length < 3 || messageSize > 48 ||
-					fragmentIndex >= numberOfFragments)
-			{
-				// illegal format:
-				//   fragmented messages need to have at least 3 byte payload,
-				// 	 the maximum size is 48 Bytes and the fragment number
-				//	 should not be higher than the number of fragments.
-				return false;
+			if (slot.receivedFragments != 0) {
+				this->reassemblyStatistics.discarded++;
 			}
+			slot.payload = SmartPointer(messageSize);
+			slot.receivedFragments = 0;
+		}
+		else if (fragmentIndex != slot.receivedFragments)
+		{
+			// missing fragment, the message can't be completed any more
+			this->reassemblyStatistics.discarded++;
+			this->releaseReassemblySlot(slot);
+			return false;
+		}
+		slot.receivedFragments++;
 
-			// check the length of the fragment (all fragments except the
-			// last one need to have a payload-length of 6 bytes + 2 byte
-			// fragment information)
-			uint8_t offset = fragmentIndex * 6;
-			if (fragmentIndex + 1 == numberOfFragments)
-			{
-				// this one is the last fragment
-				if (messageSize - offset != message.length - 2)
-				{
-					// illegal format
-					return false;
-				}
-			}
-			else if (message.length != 8)
-			{
-				// illegal format
-				return false;
-			}
+		complete = (fragmentIndex + 1 == numberOfFragments);
+	}
 
-			// Check if other parts of this message are already in the
-			// list of receiving messages.
-			typename ReceiveList::iterator packet = this->pendingMessages.begin();
-			for ( ; packet != this->pendingMessages.end(); ++packet)
-			{
-				if (packet->header == header &&
-					packet->counter == counter)
-				{
-					break;
-				}
-			}
+	std::memcpy(slot.payload.getPointer() + offset,
+			message.data + headerSize,
+			fragmentSize);
 
-			if (packet == this->pendingMessages.end()) {
-				// message not found => first part of this message,
-				// prepend it to the list
-				this->pendingMessages.prepend(ReceiveListItem(messageSize, header, counter));
-				packet = this->pendingMessages.begin();
-			}
+	// test if this was the last segment, otherwise we have to wait
+	// for more messages
+	if (complete)
+	{
+		this->appendReceivedMessage(slot.header, slot.payload);
+		this->reassemblyStatistics.completed++;
+		this->releaseReassemblySlot(slot);
+	}
+	else {
+		slot.timeout.restart(this->reassemblyTimeout);
+	}
+
+	return true;
+}
 
-			// create a marker for the currently received fragment and
-			// test if the fragment was already received
-			const uint8_t currentFragment = (1 << fragmentIndex);
-			if (currentFragment & packet->receivedFragments)
-			{
-				// error: received fragment twice -> most likely a new message -> delete the old one
-				//XPCC_LOG_WARNING << "lost fragment" << xpcc::flush;
-				packet->receivedFragments = 0;
+// ----------------------------------------------------------------------------
+template<typename Driver, uint8_t ReassemblySlots>
+typename xpcc::CanConnector<Driver, ReassemblySlots>::ReassemblySlot&
+xpcc::CanConnector<Driver, ReassemblySlots>::getReassemblySlot(
+		const Header& header, uint8_t counter)
+{
+	// Start searching at the hashed position, so that usually the first
+	// probe already hits. Because the table is small, every slot is
+	// checked before a new one is allocated.
+	const uint8_t start = (header.source ^ header.packetIdentifier ^
+			(counter >> 4)) & (ReassemblySlots - 1);
+
+	ReassemblySlot *freeSlot = nullptr;
+	ReassemblySlot *oldestSlot = nullptr;
+	for (uint8_t i = 0; i < ReassemblySlots; ++i)
+	{
+		ReassemblySlot& slot = this->reassemblyTable[(start + i) & (ReassemblySlots - 1)];
+		if (slot.used)
+		{
+			if (slot.counter == counter && slot.header == header) {
+				return slot;
+			}
+			if (oldestSlot == nullptr ||
+					slot.timeout.remaining() < oldestSlot->timeout.remaining()) {
+				oldestSlot = &slot;
 			}
-			packet->receivedFragments |= currentFragment;
-
-			std::memcpy(packet->payload.getPointer() + offset,
-					message.data + 2,
-					message.length - 2);
-
-			// test if this was the last segment, otherwise we have to wait
-			// for more messages
-			if (xpcc::bitCount(packet->receivedFragments) == numberOfFragments)
-			{
-				this->receivedMessages.append(*packet);
-				this->pendingMessages.remove(packet);
+		}
+		else if (freeSlot == nullptr)
+		{
+			freeSlot = &slot;
+			if (this->usedReassemblySlots == 0) {
+				break;
 			}
 		}
+	}
 
-		return true;
+	if (freeSlot == nullptr)
+	{
+		// table is full => give up the packet which waits the longest
+		this->reassemblyStatistics.evicted++;
+		this->releaseReassemblySlot(*oldestSlot);
+		freeSlot = oldestSlot;
 	}
-	else {
-		return false;
+
+	freeSlot->used = true;
+	freeSlot->header = header;
+	freeSlot->counter = counter;
+	freeSlot->receivedFragments = 0;
+	freeSlot->timeout.restart(this->reassemblyTimeout);
+	this->usedReassemblySlots++;
+
+	return *freeSlot;
+}
+
+template<typename Driver, uint8_t ReassemblySlots>
+void
+xpcc::CanConnector<Driver, ReassemblySlots>::releaseReassemblySlot(ReassemblySlot& slot)
+{
+	slot.used = false;
+	slot.receivedFragments = 0;
+	this->usedReassemblySlots--;
+}
+
+template<typename Driver, uint8_t ReassemblySlots>
+void
+xpcc::CanConnector<Driver, ReassemblySlots>::removeExpiredReassemblies()
+{
+	if (this->usedReassemblySlots == 0) {
+		return;
+	}
+
+	for (ReassemblySlot& slot : this->reassemblyTable)
+	{
+		if (slot.used && slot.timeout.isExpired())
+		{
+			this->reassemblyStatistics.expired++;
+			this->releaseReassemblySlot(slot);
+		}
 	}
 }
@@ -31,6 +31,53 @@
 #include "../connector.hpp"
 #include "can_connector_base_test.hpp"
 
+namespace
+{
+	class FilterPostman : public xpcc::Postman
+	{
+	public:
+		FilterPostman() :
+			components(), events()
+		{
+		}
+
+		DeliverInfo
+		deliverPacket(const xpcc::Header&, const xpcc::SmartPointer&) override
+		{
+			return OK;
+		}
+
+		bool
+		isComponentAvailable(uint8_t component) const override
+		{
+			return components[component];
+		}
+
+		bool
+		isEventSubscribed(uint8_t event) const override
+		{
+			return events[event];
+		}
+
+		bool components[256];
+		bool events[256];
+	};
+
+	bool
+	isAccepted(const xpcc::Can::Filter *filters, uint8_t count,
+			uint32_t identifier)
+	{
+		for (uint8_t i = 0; i < count; ++i)
+		{
+			if ((identifier & filters[i].mask) ==
+					(filters[i].identifier & filters[i].mask)) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
 // ----------------------------------------------------------------------------
 void
 CanConnectorBaseTest::testConversionToIdentifier()
@@ -131,3 +178,102 @@ CanConnectorBaseTest::testConversionToHeader()
 	TEST_ASSERT_FALSE(connector.convertToHeader(identifier, header));
 	TEST_ASSERT_EQUALS(header, xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 0, 0x0a));
 }
+
+// ----------------------------------------------------------------------------
+void
+CanConnectorBaseTest::testCalculateFilters()
+{
+	FilterPostman postman;
+	postman.components[0x12] = true;
+	postman.components[0x13] = true;
+	postman.events[0x20] = true;
+
+	xpcc::Can::Filter filters[14];
+	TEST_ASSERT_EQUALS(xpcc::CanConnectorBase::calculateFilters(postman, filters, 14), 3);
+
+	TEST_ASSERT_EQUALS(filters[0].identifier, 0x00120000U);
+	TEST_ASSERT_EQUALS(filters[0].mask, 0x00ff0000U);
+	TEST_ASSERT_EQUALS(filters[1].identifier, 0x00130000U);
+	TEST_ASSERT_EQUALS(filters[1].mask, 0x00ff0000U);
+	TEST_ASSERT_EQUALS(filters[2].identifier, 0x00000020U);
+	TEST_ASSERT_EQUALS(filters[2].mask, 0x1cff00ffU);
+
+	// actions, responses, acknowledges and fragments for the components
+	TEST_ASSERT_TRUE(isAccepted(filters, 3, 0x00120a05));
+	TEST_ASSERT_TRUE(isAccepted(filters, 3, 0x0d130a05));
+	// subscribed event from any source, also fragmented
+	TEST_ASSERT_TRUE(isAccepted(filters, 3, 0x00000a20));
+	TEST_ASSERT_TRUE(isAccepted(filters, 3, 0x01000b20));
+
+	TEST_ASSERT_FALSE(isAccepted(filters, 3, 0x00140a05));
+	TEST_ASSERT_FALSE(isAccepted(filters, 3, 0x00000a21));
+	TEST_ASSERT_FALSE(isAccepted(filters, 3, 0x04000a20));
+}
+
+void
+CanConnectorBaseTest::testCalculateFiltersMerged()
+{
+	FilterPostman postman;
+	for (uint16_t i = 0x10; i < 0x18; ++i) {
+		postman.components[i] = true;
+	}
+	postman.events[0x40] = true;
+	postman.events[0x41] = true;
+	postman.events[0x42] = true;
+	postman.events[0x43] = true;
+
+	xpcc::Can::Filter filters[4];
+	uint8_t count = xpcc::CanConnectorBase::calculateFilters(postman, filters, 4);
+	TEST_ASSERT_EQUALS(count, 4);
+
+	// the result accepts a superset of the needed packets
+	for (uint16_t i = 0x10; i < 0x18; ++i) {
+		TEST_ASSERT_TRUE(isAccepted(filters, count,
+				xpcc::CanConnectorBase::convertToIdentifier(
+					xpcc::Header(xpcc::Header::Type::REQUEST, false, i, 1, 2), false)));
+	}
+	for (uint16_t i = 0x40; i < 0x44; ++i) {
+		TEST_ASSERT_TRUE(isAccepted(filters, count,
+				xpcc::CanConnectorBase::convertToIdentifier(
+					xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 1, i), false)));
+	}
+
+	// but still rejects unrelated components and events
+	TEST_ASSERT_FALSE(isAccepted(filters, count, 0x00200000));
+	TEST_ASSERT_FALSE(isAccepted(filters, count, 0x00000080));
+}
+
+void
+CanConnectorBaseTest::testCalculateFiltersEmpty()
+{
+	FilterPostman postman;
+
+	xpcc::Can::Filter filters[2];
+	TEST_ASSERT_EQUALS(xpcc::CanConnectorBase::calculateFilters(postman, filters, 2), 1);
+
+	TEST_ASSERT_FALSE(isAccepted(filters, 1, 0x00000000));
+	TEST_ASSERT_FALSE(isAccepted(filters, 1, 0x00120a05));
+	TEST_ASSERT_FALSE(isAccepted(filters, 1, 0x08120a05));
+
+	// all events with the default implementation of the postman
+	class DefaultPostman : public xpcc::Postman
+	{
+		DeliverInfo
+		deliverPacket(const xpcc::Header&, const xpcc::SmartPointer&) override
+		{
+			return OK;
+		}
+
+		bool
+		isComponentAvailable(uint8_t) const override
+		{
+			return false;
+		}
+	} defaultPostman;
+
+	uint8_t count = xpcc::CanConnectorBase::calculateFilters(defaultPostman, filters, 2);
+	for (uint16_t i = 0; i <= 0xff; ++i) {
+		TEST_ASSERT_TRUE(isAccepted(filters, count, i));
+	}
+	TEST_ASSERT_FALSE(isAccepted(filters, count, 0x00120a05));
+}
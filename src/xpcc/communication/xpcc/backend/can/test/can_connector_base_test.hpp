@@ -41,6 +41,15 @@ public:
 	
 	void
 	testConversionToHeader();
+	
+	void
+	testCalculateFilters();
+	
+	void
+	testCalculateFiltersMerged();
+	
+	void
+	testCalculateFiltersEmpty();
 };
 
 #endif // CAN_CONNECTOR_BASE_TEST_HPP
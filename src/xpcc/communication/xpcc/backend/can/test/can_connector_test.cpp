@@ -28,6 +28,8 @@
  */
 // ----------------------------------------------------------------------------
 
+#include <xpcc/architecture/driver/test/testing_clock.hpp>
+
 #include "can_connector_test.hpp"
 
 // ----------------------------------------------------------------------------
@@ -110,6 +112,14 @@ CanConnectorTest::CanConnectorTest() :
 	for (uint8_t i = 0; i < sizeof(fragmentedPayload); ++i) {
 		fragmentedPayload[i] = i * 2;
 	}
+	
+	for (uint8_t i = 0; i < sizeof(largePayload); ++i) {
+		largePayload[i] = i + 1;
+	}
+	
+	for (uint16_t i = 0; i < sizeof(extendedPayload); ++i) {
+		extendedPayload[i] = i * 3;
+	}
 }
 
 // ----------------------------------------------------------------------------
@@ -153,9 +163,9 @@ CanConnectorTest::testSendFragmentedMessage()
 	// fragmented messages aren't send directly but queued immediately
 	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 0U);
 	
-	// with two send slots two message should be send
+	// with two send slots two message should be send within one update
 	connector->update();
-	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 1U);
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 2U);
 	connector->update();
 	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 2U);
 	
@@ -274,3 +284,315 @@ CanConnectorTest::testReceiveFragmentedMessage()
 	
 	TEST_ASSERT_FALSE(connector->isPacketAvailable());
 }
+
+void
+CanConnectorTest::testSendFlexibleDataMessage()
+{
+#ifdef XPCC__OS_HOSTED
+	driver->flexibleData = true;
+	driver->sendSlots = 10;
+	this->messageCounter = connector->messageCounter = 0x20;
+	
+	xpcc::SmartPointer payload(&largePayload);
+	connector->sendPacket(xpccHeader, payload);
+	connector->update();
+	
+	// 100 bytes need two fragments with 62 and 38 bytes
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 2U);
+	
+	xpcc::can::Message& first = driver->sendList.getFront();
+	TEST_ASSERT_EQUALS(first.identifier, fragmentedIdentifier);
+	TEST_ASSERT_TRUE(first.isFlexibleData());
+	TEST_ASSERT_EQUALS(first.length, 64);
+	TEST_ASSERT_EQUALS(first.data[0], 0x20);
+	TEST_ASSERT_EQUALS(first.data[1], sizeof(largePayload));
+	TEST_ASSERT_EQUALS_ARRAY(&first.data[2], &largePayload[0], 62);
+	driver->sendList.removeFront();
+	
+	// 38 + 2 bytes are padded to the next valid length of 48 bytes
+	xpcc::can::Message& second = driver->sendList.getFront();
+	TEST_ASSERT_TRUE(second.isFlexibleData());
+	TEST_ASSERT_EQUALS(second.length, 48);
+	TEST_ASSERT_EQUALS(second.data[0], 0x21);
+	TEST_ASSERT_EQUALS_ARRAY(&second.data[2], &largePayload[62], 38);
+	TEST_ASSERT_EQUALS(second.data[40], 0);
+	TEST_ASSERT_EQUALS(second.data[47], 0);
+	
+	TEST_ASSERT_EQUALS(connector->messageCounter, 0x30);
+#endif
+}
+
+void
+CanConnectorTest::testReceiveFlexibleDataMessage()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::can::Message message(fragmentedIdentifier, 64);
+	message.setFlexibleData();
+	message.data[0] = 0x71;
+	message.data[1] = sizeof(largePayload);
+	memcpy(&message.data[2], &largePayload[62], 38);
+	
+	// wrong padding
+	message.length = 40;
+	driver->receiveList.append(message);
+	connector->update();
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+	
+	message.length = 48;
+	driver->receiveList.append(message);
+	
+	message.length = 64;
+	message.data[0] = 0x70;
+	memcpy(&message.data[2], &largePayload[0], 62);
+	driver->receiveList.append(message);
+	
+	connector->update();
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+	
+	TEST_ASSERT_EQUALS(connector->getPacketHeader(), xpccHeader);
+	TEST_ASSERT_EQUALS(connector->getPacketPayload().getSize(), sizeof(largePayload));
+	TEST_ASSERT_EQUALS_ARRAY(
+			connector->getPacketPayload().getPointer(),
+			largePayload,
+			sizeof(largePayload));
+	connector->dropPacket();
+	
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+#endif
+}
+
+void
+CanConnectorTest::testReassemblyTimeout()
+{
+	TestingClock::time = 1000;
+	connector->setReassemblyTimeout(50);
+	
+	this->messageCounter = 0x10;
+	xpcc::can::Message message;
+	createMessage(message, 0);
+	driver->receiveList.append(message);
+	createMessage(message, 1);
+	driver->receiveList.append(message);
+	connector->update();
+	
+	// each fragment restarts the timeout
+	TestingClock::time += 49;
+	connector->update();
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().expired, 0U);
+	
+	TestingClock::time += 2;
+	connector->update();
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().expired, 1U);
+	
+	// the last fragment alone doesn't complete the packet any more
+	createMessage(message, 2);
+	driver->receiveList.append(message);
+	connector->update();
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+	
+	createMessage(message, 0);
+	driver->receiveList.append(message);
+	createMessage(message, 1);
+	driver->receiveList.append(message);
+	connector->update();
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().completed, 1U);
+}
+
+void
+CanConnectorTest::testReassemblyEviction()
+{
+	TestingClock::time = 1000;
+	this->messageCounter = 0x10;
+	
+	// start more packets than the table can hold, each from another source
+	xpcc::can::Message message;
+	for (uint8_t i = 0; i < 9; ++i)
+	{
+		createMessage(message, 0);
+		message.identifier = (fragmentedIdentifier & 0xffff00ff) | (i << 8);
+		driver->receiveList.append(message);
+		connector->update();
+		
+		TestingClock::time += 1;
+	}
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().evicted, 1U);
+	
+	// the first packet was evicted, the second one can still be completed.
+	// The remaining fragments of the first one only start a new packet.
+	for (uint8_t source : {1, 0})
+	{
+		for (uint8_t fragment : {1, 2})
+		{
+			createMessage(message, fragment);
+			message.identifier = (fragmentedIdentifier & 0xffff00ff) | (source << 8);
+			driver->receiveList.append(message);
+		}
+	}
+	connector->update();
+	
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+	if (connector->isPacketAvailable())
+	{
+		TEST_ASSERT_EQUALS(connector->getPacketHeader().source, 1);
+		connector->dropPacket();
+	}
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().completed, 1U);
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().evicted, 1U);
+}
+
+void
+CanConnectorTest::testExtendedFragmentation()
+{
+	connector->setFragmentation(TestingCanConnector::Fragmentation::Extended);
+	this->messageCounter = connector->messageCounter = 0x70;
+	driver->sendSlots = 100;
+	
+	xpcc::SmartPointer payload(&extendedPayload);
+	connector->sendPacket(xpccHeader, payload);
+	connector->update();
+	
+	// 300 bytes in fragments of 5 bytes
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 60U);
+	
+	xpcc::can::Message& first = driver->sendList.getFront();
+	TEST_ASSERT_EQUALS(first.identifier, fragmentedIdentifier);
+	TEST_ASSERT_EQUALS(first.length, 8);
+	TEST_ASSERT_EQUALS(first.data[0], 0);
+	TEST_ASSERT_EQUALS(first.data[1], 0x71);
+	TEST_ASSERT_EQUALS(first.data[2], 300 - 256);
+	TEST_ASSERT_EQUALS_ARRAY(&first.data[3], &extendedPayload[0], 5);
+	
+	// loop the frames back to the connector
+	while (!driver->sendList.isEmpty())
+	{
+		driver->receiveList.append(driver->sendList.getFront());
+		driver->sendList.removeFront();
+	}
+	connector->update();
+	
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getPacketHeader(), xpccHeader);
+	TEST_ASSERT_EQUALS(connector->getPacketPayload().getSize(), sizeof(extendedPayload));
+	TEST_ASSERT_EQUALS_ARRAY(
+			connector->getPacketPayload().getPointer(),
+			extendedPayload,
+			sizeof(extendedPayload));
+	connector->dropPacket();
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().completed, 1U);
+}
+
+void
+CanConnectorTest::testExtendedFragmentationOutOfOrder()
+{
+	connector->setFragmentation(TestingCanConnector::Fragmentation::Extended);
+	
+	xpcc::can::Message message(fragmentedIdentifier, 8);
+	message.data[1] = 0x30;
+	message.data[2] = 12;
+	
+	// fragments 0 and 2 of a packet with 12 bytes
+	message.data[0] = 0;
+	driver->receiveList.append(message);
+	message.data[0] = 2;
+	message.length = 5;
+	driver->receiveList.append(message);
+	connector->update();
+	
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().discarded, 1U);
+	
+	// the late fragment 1 can't complete the packet either
+	message.data[0] = 1;
+	message.length = 8;
+	driver->receiveList.append(message);
+	connector->update();
+	
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().discarded, 2U);
+	TEST_ASSERT_EQUALS(connector->getReassemblyStatistics().completed, 0U);
+}
+
+// ----------------------------------------------------------------------------
+namespace
+{
+	class SingleComponentPostman : public xpcc::Postman
+	{
+		DeliverInfo
+		deliverPacket(const xpcc::Header&, const xpcc::SmartPointer&) override
+		{
+			return OK;
+		}
+
+		bool
+		isComponentAvailable(uint8_t component) const override
+		{
+			return (component == 0x11);
+		}
+
+		bool
+		isEventSubscribed(uint8_t event) const override
+		{
+			return (event == 0x30);
+		}
+	};
+}
+
+void
+CanConnectorTest::testSetAcceptanceFilters()
+{
+	SingleComponentPostman postman;
+	TEST_ASSERT_TRUE(connector->setAcceptanceFilters(postman));
+	
+	TEST_ASSERT_EQUALS(driver->filterCount, 2);
+	TEST_ASSERT_EQUALS(driver->filters[0].identifier, 0x00110000U);
+	TEST_ASSERT_EQUALS(driver->filters[0].mask, XPCC_CAN_PACKET_DESTINATION_MASK);
+	TEST_ASSERT_EQUALS(driver->filters[1].identifier, 0x00000030U);
+	TEST_ASSERT_EQUALS(driver->filters[1].mask, 0x1cff00ffU);
+}
+
+void
+CanConnectorTest::testFlushDriver()
+{
+	driver->sendSlots = 2;
+	
+	connector->sendPacket(xpccHeader, xpcc::SmartPointer(&shortPayload));
+	TEST_ASSERT_EQUALS(driver->flushCount, 0);
+	
+	// frames batched by the driver are sent at the end of update()
+	connector->update();
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 1U);
+	TEST_ASSERT_EQUALS(driver->flushCount, 1);
+}
+
+void
+CanConnectorTest::testTransmitStatistics()
+{
+	connector->sendPacket(xpccHeader, xpcc::SmartPointer(&shortPayload));
+	connector->sendPacket(xpccHeader, xpcc::SmartPointer(&fragmentedPayload));
+	TEST_ASSERT_EQUALS(connector->getSendQueueSize(), 2U);
+	
+	// too large for legacy fragments
+	connector->sendPacket(xpccHeader, xpcc::SmartPointer(&largePayload));
+	TEST_ASSERT_EQUALS(connector->getSendQueueSize(), 2U);
+	TEST_ASSERT_EQUALS(connector->getTransmitStatistics().dropped, 1U);
+	
+	// the short message and the first fragment
+	driver->sendSlots = 2;
+	connector->update();
+	TEST_ASSERT_EQUALS(connector->getSendQueueSize(), 1U);
+	TEST_ASSERT_EQUALS(connector->getTransmitStatistics().sent, 1U);
+	
+	driver->sendSlots = 2;
+	connector->update();
+	TEST_ASSERT_EQUALS(connector->getSendQueueSize(), 0U);
+	TEST_ASSERT_EQUALS(connector->getTransmitStatistics().sent, 2U);
+	TEST_ASSERT_EQUALS(connector->getTransmitStatistics().peakQueueLength, 2U);
+	
+	// sent directly
+	driver->sendSlots = 1;
+	connector->sendPacket(xpccHeader, xpcc::SmartPointer(&shortPayload));
+	TEST_ASSERT_EQUALS(connector->getSendQueueSize(), 0U);
+	TEST_ASSERT_EQUALS(connector->getTransmitStatistics().sent, 3U);
+}
@@ -75,6 +75,33 @@ public:
     void
     testReceiveFragmentedMessage();
     
+    void
+    testSendFlexibleDataMessage();
+    
+    void
+    testReceiveFlexibleDataMessage();
+    
+    void
+    testReassemblyTimeout();
+    
+    void
+    testReassemblyEviction();
+    
+    void
+    testExtendedFragmentation();
+    
+    void
+    testExtendedFragmentationOutOfOrder();
+    
+    void
+    testSetAcceptanceFilters();
+    
+    void
+    testFlushDriver();
+    
+    void
+    testTransmitStatistics();
+    
 private:
 	TestingCanConnector *connector;
 	FakeCanDriver *driver;
@@ -86,6 +113,8 @@ private:
 	
 	uint8_t shortPayload[8];
 	uint8_t fragmentedPayload[14];
+	uint8_t largePayload[100];
+	uint8_t extendedPayload[300];
 };
 
 #endif
@@ -31,7 +31,8 @@
 #include "fake_can_driver.hpp"
 
 FakeCanDriver::FakeCanDriver() :
-	sendSlots(0)
+	sendSlots(0), flexibleData(false), flushCount(0),
+	filters(), filterCount(0xff)
 {
 }
 
@@ -93,3 +94,24 @@ FakeCanDriver::getBusState()
 {
 	return xpcc::Can::BusState::Connected;
 }
+
+bool
+FakeCanDriver::isFlexibleDataEnabled() const
+{
+	return this->flexibleData;
+}
+
+void
+FakeCanDriver::flush()
+{
+	this->flushCount++;
+}
+
+void
+FakeCanDriver::setFilters(const Filter *filters, uint8_t count)
+{
+	for (uint8_t i = 0; i < count; ++i) {
+		this->filters[i] = filters[i];
+	}
+	this->filterCount = count;
+}
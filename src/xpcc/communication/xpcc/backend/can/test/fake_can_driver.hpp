@@ -60,6 +60,17 @@ public:
 	static BusState
 	getBusState();
 	
+	bool
+	isFlexibleDataEnabled() const;
+	
+	void
+	flush();
+	
+	static constexpr uint8_t FilterCount = 4;
+	
+	void
+	setFilters(const Filter *filters, uint8_t count);
+	
 public:
 	/// Messages which should be received
 	xpcc::LinkedList<xpcc::can::Message> receiveList;
@@ -69,6 +80,16 @@ public:
 	
 	/// number of messages which could be send
 	uint8_t sendSlots;
+	
+	/// pretend to support CAN FD frames
+	bool flexibleData;
+	
+	/// number of calls of flush()
+	uint8_t flushCount;
+	
+	/// filters set by the last call of setFilters()
+	Filter filters[FilterCount];
+	uint8_t filterCount;
 };
 
 #endif	// FAKE_CAN_DRIVER_HPP
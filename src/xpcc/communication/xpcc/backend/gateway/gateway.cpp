@@ -0,0 +1,297 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "gateway.hpp"
+
+#include <algorithm>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <xpcc/architecture/interface/assert.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef  XPCC_LOG_LEVEL
+#define XPCC_LOG_LEVEL xpcc::log::DEBUG
+
+namespace xpcc
+{
+
+constexpr uint8_t Gateway::maxInterfaces;
+
+// ----------------------------------------------------------------------------
+Gateway::Queue::Queue(std::size_t capacity) :
+	mask(0), head(0), size(0)
+{
+	std::size_t n = 1;
+	while (n < capacity) {
+		n <<= 1;
+	}
+	this->buffer.resize(n);
+	this->mask = n - 1;
+}
+
+bool
+Gateway::Queue::push(const BackendInterface::Packet& packet)
+{
+	if (this->size > this->mask) {
+		return false;
+	}
+	this->buffer[(this->head + this->size) & this->mask] = packet;
+	this->size++;
+	return true;
+}
+
+std::size_t
+Gateway::Queue::getContiguous(const BackendInterface::Packet*& packets) const
+{
+	packets = &this->buffer[this->head];
+	std::size_t toEnd = this->buffer.size() - this->head;
+	return (this->size < toEnd) ? this->size : toEnd;
+}
+
+void
+Gateway::Queue::pop(std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		// release the payload now instead of when the slot is reused
+		this->buffer[this->head].payload = SmartPointer();
+		this->head = (this->head + 1) & this->mask;
+	}
+	this->size -= count;
+}
+
+// ----------------------------------------------------------------------------
+Gateway::Interface::Interface(BackendInterface& backend, int fileDescriptor,
+		std::size_t queueSize) :
+	backend(&backend), fileDescriptor(fileDescriptor), queue(queueSize),
+	ready(false)
+{
+}
+
+// ----------------------------------------------------------------------------
+Gateway::Gateway(uint8_t burstSize, uint16_t pollInterval) :
+	receiveBuffer(burstSize > 0 ? burstSize : 1),
+	burstSize(burstSize > 0 ? burstSize : 1), pollInterval(pollInterval)
+{
+	for (uint32_t& route : this->routes) {
+		route = 0xffffffff;
+	}
+	this->interfaces.reserve(maxInterfaces);
+
+	this->epollDescriptor = epoll_create1(0);
+	if (this->epollDescriptor < 0) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not create epoll instance!" << xpcc::endl;
+	}
+}
+
+Gateway::~Gateway()
+{
+	if (this->epollDescriptor >= 0) {
+		::close(this->epollDescriptor);
+	}
+}
+
+// ----------------------------------------------------------------------------
+uint8_t
+Gateway::addInterface(BackendInterface& backend, int fileDescriptor,
+		std::size_t queueSize)
+{
+	xpcc_assert(this->interfaces.size() < maxInterfaces, "gateway", "add", "interfaces");
+
+	uint8_t index = this->interfaces.size();
+	this->interfaces.emplace_back(backend, fileDescriptor, queueSize);
+
+	if (fileDescriptor >= 0 and this->epollDescriptor >= 0)
+	{
+		struct epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.u32 = index;
+		if (epoll_ctl(this->epollDescriptor, EPOLL_CTL_ADD, fileDescriptor, &event) < 0)
+		{
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not watch interface "
+					<< index << ", polling it instead!" << xpcc::endl;
+			this->interfaces.back().fileDescriptor = -1;
+		}
+	}
+	return index;
+}
+
+// ----------------------------------------------------------------------------
+void
+Gateway::setRoute(uint8_t destination, uint32_t interfaces)
+{
+	this->routes[destination] = interfaces;
+}
+
+void
+Gateway::addRoute(uint8_t destination, uint8_t interface)
+{
+	if (this->routes[destination] == 0xffffffff) {
+		// replace flooding by the first explicit route
+		this->routes[destination] = 0;
+	}
+	this->routes[destination] |= (uint32_t(1) << interface);
+}
+
+void
+Gateway::removeRoute(uint8_t destination)
+{
+	this->routes[destination] = 0xffffffff;
+}
+
+const Gateway::Statistics&
+Gateway::getStatistics(uint8_t interface) const
+{
+	return this->interfaces[interface].statistics;
+}
+
+std::size_t
+Gateway::getQueueSize(uint8_t interface) const
+{
+	return this->interfaces[interface].queue.getSize();
+}
+
+// ----------------------------------------------------------------------------
+void
+Gateway::forward(uint8_t source, const BackendInterface::Packet& packet)
+{
+	uint32_t targets = this->routes[packet.header.destination];
+	targets &= ~(uint32_t(1) << source);
+
+	bool forwarded = false;
+	for (uint8_t i = 0; i < this->interfaces.size(); ++i)
+	{
+		if (not (targets & (uint32_t(1) << i))) {
+			continue;
+		}
+
+		Interface& target = this->interfaces[i];
+		if (target.queue.push(packet)) {
+			forwarded = true;
+		}
+		else {
+			target.statistics.dropped++;
+		}
+	}
+
+	if (forwarded) {
+		this->interfaces[source].statistics.forwarded++;
+	}
+}
+
+bool
+Gateway::hasPendingWork() const
+{
+	for (const Interface& interface : this->interfaces)
+	{
+		if (interface.ready or interface.queue.getSize() > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// ----------------------------------------------------------------------------
+bool
+Gateway::waitForActivity(uint16_t timeout)
+{
+	if (this->hasPendingWork()) {
+		timeout = 0;
+	}
+	else if (not this->pollTimeout.isArmed()) {
+		return true;
+	}
+	else
+	{
+		// The timeout may expire after isArmed() was checked, a negative
+		// remaining time must not wrap around to a long timeout.
+		const int32_t remaining = this->pollTimeout.remaining();
+		if (remaining < int32_t(timeout)) {
+			timeout = std::max<int32_t>(0, remaining);
+		}
+	}
+
+	if (this->epollDescriptor < 0) {
+		return true;
+	}
+
+	struct epoll_event events[maxInterfaces];
+	int count = epoll_wait(this->epollDescriptor, events, maxInterfaces, timeout);
+	for (int i = 0; i < count; ++i) {
+		this->interfaces[events[i].data.u32].ready = true;
+	}
+
+	return (count > 0) or this->hasPendingWork() or
+			not this->pollTimeout.isArmed();
+}
+
+void
+Gateway::update()
+{
+	// update every interface once in a while, even without activity
+	bool tick = not this->pollTimeout.isArmed();
+	if (tick) {
+		this->pollTimeout.restart(this->pollInterval);
+	}
+
+	for (uint8_t i = 0; i < this->interfaces.size(); ++i)
+	{
+		Interface& interface = this->interfaces[i];
+		if (not (interface.ready or tick or interface.fileDescriptor < 0)) {
+			continue;
+		}
+
+		interface.backend->update();
+		uint8_t count = interface.backend->receivePackets(
+				this->receiveBuffer.data(), this->burstSize);
+
+		interface.statistics.received += count;
+		for (uint8_t k = 0; k < count; ++k)
+		{
+			this->forward(i, this->receiveBuffer[k]);
+			this->receiveBuffer[k].payload = SmartPointer();
+		}
+
+		// a full burst probably left packets in the backend
+		interface.ready = (count == this->burstSize);
+	}
+
+	for (Interface& interface : this->interfaces)
+	{
+		std::size_t remaining = this->burstSize;
+		while (remaining > 0 and interface.queue.getSize() > 0)
+		{
+			const BackendInterface::Packet *packets;
+			std::size_t count = interface.queue.getContiguous(packets);
+			if (count > remaining) {
+				count = remaining;
+			}
+
+			interface.backend->sendPackets(packets, count);
+			interface.queue.pop(count);
+			interface.statistics.sent += count;
+			remaining -= count;
+		}
+
+		if (remaining < this->burstSize) {
+			interface.backend->update();
+		}
+	}
+}
+
+void
+Gateway::run(uint16_t timeout)
+{
+	this->waitForActivity(timeout);
+	this->update();
+}
+
+} // xpcc namespace
@@ -0,0 +1,239 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__GATEWAY_HPP
+#define	XPCC__GATEWAY_HPP
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+#include <xpcc/processing/timer/timeout.hpp>
+
+#include "../backend_interface.hpp"
+
+namespace xpcc
+{
+
+/**
+ * @brief	Forwards packets between several backends on one epoll loop
+ *
+ * Every backend added with addInterface() is an interface of the gateway,
+ * e.g. a CanConnector for each SocketCAN interface plus a ZeroMQConnector
+ * or TipcConnector. Packets received on one interface are forwarded to
+ * the interfaces given by the route of their destination, never back to
+ * the interface they came from. Destinations without a route (including
+ * the events with destination 0) are forwarded to all other interfaces.
+ *
+ * @code
+ * xpcc::hosted::SocketCan can0, can1;
+ * xpcc::CanConnector<xpcc::hosted::SocketCan> connector0(&can0), connector1(&can1);
+ * xpcc::ZeroMQConnector zmq(...);
+ *
+ * xpcc::Gateway gateway;
+ * uint8_t bus0 = gateway.addInterface(connector0, can0.getFileDescriptor());
+ * uint8_t bus1 = gateway.addInterface(connector1, can1.getFileDescriptor());
+ * gateway.addInterface(zmq, zmq.getFileDescriptor());
+ *
+ * // the drive components live on bus 1 only
+ * gateway.addRoute(robot::component::DRIVE, bus1);
+ *
+ * while (true) {
+ *     gateway.run(100);
+ * }
+ * @endcode
+ *
+ * Each interface has a bounded transmit queue, packets routed to a full
+ * queue are dropped and counted. To bound the latency every interface
+ * receives and sends at most `burstSize` packets per update() before the
+ * next interface is served.
+ *
+ * An interface is updated and read when its file descriptor becomes
+ * readable. The descriptor must stay readable until the packets were
+ * taken out of the backend, or be reset by the update() method of the
+ * backend (see ZeroMQConnector::getFileDescriptor()). Additionally all
+ * interfaces are updated and read every `pollInterval` milliseconds,
+ * which bounds the latency of interfaces without a descriptor and
+ * retries frames a backend couldn't send before.
+ *
+ * @ingroup	backend
+ */
+class Gateway
+{
+public:
+	/// Routes are stored as bitmask of the interfaces
+	static constexpr uint8_t maxInterfaces = 32;
+
+	/// Counters of an interface
+	struct Statistics
+	{
+		Statistics() :
+			received(0), forwarded(0), sent(0), dropped(0)
+		{
+		}
+
+		/// Packets received from this interface
+		uint32_t received;
+		/// Packets received from this interface and queued for at least one other
+		uint32_t forwarded;
+		/// Packets passed to this interface
+		uint32_t sent;
+		/// Packets for this interface dropped because its queue was full
+		uint32_t dropped;
+	};
+
+public:
+	/**
+	 * @param	burstSize		Maximum number of packets received from and
+	 * 							sent to one interface per update()
+	 * @param	pollInterval	Maximum time in milliseconds between two
+	 * 							updates of all interfaces
+	 */
+	Gateway(uint8_t burstSize = 32, uint16_t pollInterval = 10);
+
+	~Gateway();
+
+	Gateway(const Gateway&) = delete;
+	Gateway& operator=(const Gateway&) = delete;
+
+	/**
+	 * @brief	Add a backend as interface
+	 *
+	 * @param	backend			Backend, has to outlive the gateway
+	 * @param	fileDescriptor	Readable when the backend received packets,
+	 * 							-1 to poll the backend instead
+	 * @param	queueSize		Capacity of the transmit queue, rounded up
+	 * 							to the next power of two
+	 *
+	 * @return	Index of the interface, used for the routes
+	 */
+	uint8_t
+	addInterface(BackendInterface& backend, int fileDescriptor = -1,
+			std::size_t queueSize = 256);
+
+	inline uint8_t
+	getNumberOfInterfaces() const
+	{
+		return this->interfaces.size();
+	}
+
+	/// Forward packets for \p destination to the given set of interfaces
+	void
+	setRoute(uint8_t destination, uint32_t interfaces);
+
+	/// Forward packets for \p destination to \p interface as well
+	void
+	addRoute(uint8_t destination, uint8_t interface);
+
+	/// Forward packets for \p destination to all interfaces again
+	void
+	removeRoute(uint8_t destination);
+
+	/// Bitmask of the interfaces packets for \p destination are forwarded to
+	inline uint32_t
+	getRoute(uint8_t destination) const
+	{
+		return this->routes[destination];
+	}
+
+	const Statistics&
+	getStatistics(uint8_t interface) const;
+
+	/// Number of packets waiting in the transmit queue of \p interface
+	std::size_t
+	getQueueSize(uint8_t interface) const;
+
+	/**
+	 * @brief	Block until an interface has work to do or \p timeout
+	 * 			milliseconds have passed
+	 *
+	 * The timeout is limited to the next update of all interfaces, see
+	 * the poll interval.
+	 *
+	 * @return	`true` if update() has work to do
+	 */
+	bool
+	waitForActivity(uint16_t timeout);
+
+	/// Receive, route and send packets without blocking
+	void
+	update();
+
+	/// Wait for activity and update the gateway
+	void
+	run(uint16_t timeout);
+
+protected:
+	/// Bounded ring of packets waiting to be sent to one interface
+	class Queue
+	{
+	public:
+		explicit
+		Queue(std::size_t capacity);
+
+		bool
+		push(const BackendInterface::Packet& packet);
+
+		/// Longest contiguous sequence of waiting packets
+		std::size_t
+		getContiguous(const BackendInterface::Packet*& packets) const;
+
+		void
+		pop(std::size_t count);
+
+		inline std::size_t
+		getSize() const
+		{
+			return this->size;
+		}
+
+	private:
+		std::vector<BackendInterface::Packet> buffer;
+		std::size_t mask;
+		std::size_t head;
+		std::size_t size;
+	};
+
+	struct Interface
+	{
+		Interface(BackendInterface& backend, int fileDescriptor,
+				std::size_t queueSize);
+
+		BackendInterface *backend;
+		int fileDescriptor;
+		Queue queue;
+
+		/// Descriptor was readable or the last burst didn't empty the backend
+		bool ready;
+
+		Statistics statistics;
+	};
+
+	/// Route a packet received on interface \p source
+	void
+	forward(uint8_t source, const BackendInterface::Packet& packet);
+
+	bool
+	hasPendingWork() const;
+
+protected:
+	std::vector<Interface> interfaces;
+	std::vector<BackendInterface::Packet> receiveBuffer;
+	uint32_t routes[256];
+
+	uint8_t burstSize;
+	uint16_t pollInterval;
+	xpcc::ShortTimeout pollTimeout;
+
+	int epollDescriptor;
+};
+
+} // xpcc namespace
+
+#endif // XPCC__GATEWAY_HPP
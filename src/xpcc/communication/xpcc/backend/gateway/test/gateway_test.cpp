@@ -0,0 +1,192 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unistd.h>
+
+#include <xpcc/communication/xpcc/backend/gateway/gateway.hpp>
+
+#include "../../../test/fake_backend.hpp"
+#include "gateway_test.hpp"
+
+namespace
+{
+	void
+	receive(FakeBackend& backend, uint8_t destination, uint8_t identifier)
+	{
+		xpcc::Header header(xpcc::Header::Type::REQUEST, false,
+				destination, 0x01, identifier);
+		backend.messagesToReceive.append(Message(header, xpcc::SmartPointer()));
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+GatewayTest::testFlooding()
+{
+	FakeBackend backend0, backend1, backend2;
+	
+	xpcc::Gateway gateway;
+	TEST_ASSERT_EQUALS(gateway.addInterface(backend0), 0);
+	TEST_ASSERT_EQUALS(gateway.addInterface(backend1), 1);
+	TEST_ASSERT_EQUALS(gateway.addInterface(backend2), 2);
+	TEST_ASSERT_EQUALS(gateway.getNumberOfInterfaces(), 3);
+	
+	receive(backend0, 0x12, 0x34);
+	gateway.update();
+	
+	// forwarded to all interfaces except the one it came from
+	TEST_ASSERT_TRUE(backend0.messagesSend.isEmpty());
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getSize(), 1U);
+	TEST_ASSERT_EQUALS(backend2.messagesSend.getSize(), 1U);
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getFront().header.destination, 0x12);
+	TEST_ASSERT_EQUALS(backend2.messagesSend.getFront().header.packetIdentifier, 0x34);
+	TEST_ASSERT_TRUE(backend0.messagesToReceive.isEmpty());
+	
+	TEST_ASSERT_EQUALS(gateway.getStatistics(0).received, 1U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(0).forwarded, 1U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(1).sent, 1U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(2).sent, 1U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(0).sent, 0U);
+}
+
+void
+GatewayTest::testRoutes()
+{
+	FakeBackend backend0, backend1, backend2;
+	
+	xpcc::Gateway gateway;
+	gateway.addInterface(backend0);
+	gateway.addInterface(backend1);
+	gateway.addInterface(backend2);
+	
+	TEST_ASSERT_EQUALS(gateway.getRoute(0x12), 0xffffffff);
+	gateway.addRoute(0x12, 2);
+	TEST_ASSERT_EQUALS(gateway.getRoute(0x12), 0x04U);
+	
+	receive(backend0, 0x12, 0x01);
+	receive(backend0, 0x13, 0x02);
+	gateway.update();
+	
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getSize(), 1U);
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getFront().header.destination, 0x13);
+	TEST_ASSERT_EQUALS(backend2.messagesSend.getSize(), 2U);
+	
+	// never sent back to the source, even with an explicit route
+	receive(backend2, 0x12, 0x03);
+	gateway.update();
+	TEST_ASSERT_EQUALS(backend2.messagesSend.getSize(), 2U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(2).received, 1U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(2).forwarded, 0U);
+	
+	gateway.setRoute(0x12, 0);
+	receive(backend0, 0x12, 0x04);
+	gateway.update();
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getSize(), 1U);
+	TEST_ASSERT_EQUALS(backend2.messagesSend.getSize(), 2U);
+	
+	gateway.removeRoute(0x12);
+	TEST_ASSERT_EQUALS(gateway.getRoute(0x12), 0xffffffff);
+	receive(backend0, 0x12, 0x05);
+	gateway.update();
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getSize(), 2U);
+	TEST_ASSERT_EQUALS(backend2.messagesSend.getSize(), 3U);
+}
+
+void
+GatewayTest::testQueueOverflow()
+{
+	FakeBackend backend0, backend1;
+	
+	// queues are filled completely before anything is sent
+	xpcc::Gateway gateway(10);
+	gateway.addInterface(backend0);
+	gateway.addInterface(backend1, -1, 3);
+	
+	for (uint8_t i = 0; i < 6; ++i) {
+		receive(backend0, 0x12, i);
+	}
+	gateway.update();
+	
+	// capacity is rounded up to four
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getSize(), 4U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(0).received, 6U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(0).forwarded, 4U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(1).dropped, 2U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(1).sent, 4U);
+	
+	// packets keep their order across the end of the ring
+	backend1.messagesSend.removeAll();
+	for (uint8_t i = 0; i < 3; ++i) {
+		receive(backend0, 0x12, 0x10 + i);
+	}
+	gateway.update();
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getSize(), 3U);
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		TEST_ASSERT_EQUALS(backend1.messagesSend.getFront().header.packetIdentifier, 0x10 + i);
+		backend1.messagesSend.removeFront();
+	}
+}
+
+void
+GatewayTest::testBurstLimit()
+{
+	FakeBackend backend0, backend1;
+	
+	xpcc::Gateway gateway(4);
+	gateway.addInterface(backend0);
+	gateway.addInterface(backend1);
+	
+	for (uint8_t i = 0; i < 10; ++i) {
+		receive(backend0, 0x12, i);
+	}
+	
+	gateway.update();
+	TEST_ASSERT_EQUALS(backend0.messagesToReceive.getSize(), 6U);
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getSize(), 4U);
+	TEST_ASSERT_TRUE(gateway.waitForActivity(1000));
+	
+	gateway.update();
+	gateway.update();
+	TEST_ASSERT_TRUE(backend0.messagesToReceive.isEmpty());
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getSize(), 10U);
+	TEST_ASSERT_EQUALS(gateway.getQueueSize(1), 0U);
+	TEST_ASSERT_EQUALS(gateway.getStatistics(1).sent, 10U);
+}
+
+void
+GatewayTest::testFileDescriptor()
+{
+	int pipeDescriptors[2];
+	TEST_ASSERT_EQUALS(pipe(pipeDescriptors), 0);
+	
+	FakeBackend backend0, backend1;
+	
+	xpcc::Gateway gateway(32, 1000);
+	gateway.addInterface(backend0, pipeDescriptors[0]);
+	gateway.addInterface(backend1, -1);
+	
+	// first update reads every interface
+	gateway.update();
+	
+	receive(backend0, 0x12, 0x01);
+	gateway.update();
+	TEST_ASSERT_TRUE(backend1.messagesSend.isEmpty());
+	
+	TEST_ASSERT_FALSE(gateway.waitForActivity(0));
+	
+	char c = 0;
+	TEST_ASSERT_EQUALS(write(pipeDescriptors[1], &c, 1), 1);
+	TEST_ASSERT_TRUE(gateway.waitForActivity(100));
+	gateway.update();
+	TEST_ASSERT_EQUALS(backend1.messagesSend.getSize(), 1U);
+	
+	close(pipeDescriptors[0]);
+	close(pipeDescriptors[1]);
+}
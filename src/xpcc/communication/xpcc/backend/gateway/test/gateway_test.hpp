@@ -0,0 +1,34 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef GATEWAY_TEST_HPP
+#define GATEWAY_TEST_HPP
+
+#include <unittest/testsuite.hpp>
+
+class GatewayTest : public unittest::TestSuite
+{
+public:
+	void
+	testFlooding();
+	
+	void
+	testRoutes();
+	
+	void
+	testQueueOverflow();
+	
+	void
+	testBurstLimit();
+	
+	void
+	testFileDescriptor();
+};
+
+#endif // GATEWAY_TEST_HPP
@@ -0,0 +1,114 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "connector.hpp"
+
+namespace xpcc
+{
+
+SharedMemoryConnector::SharedMemoryConnector(const std::string& name,
+		std::size_t slotCount, std::size_t slotSize) :
+	ring(name, slotCount, slotSize), hasCurrent(false),
+	lostPackets(0), droppedPackets(0)
+{
+}
+
+// ----------------------------------------------------------------------------
+void
+SharedMemoryConnector::sendPacket(const Header &header, SmartPointer payload)
+{
+	if (not this->ring.publish(header, payload)) {
+		this->droppedPackets++;
+	}
+}
+
+// ----------------------------------------------------------------------------
+bool
+SharedMemoryConnector::readPacket(Packet& packet)
+{
+	std::size_t lost;
+	while (true)
+	{
+		switch (this->ring.read(packet.header, packet.payload, lost))
+		{
+			case SharedMemoryRing::Result::Packet:
+				return true;
+
+			case SharedMemoryRing::Result::Lost:
+				this->lostPackets += lost;
+				break;
+
+			case SharedMemoryRing::Result::Empty:
+				return false;
+		}
+	}
+}
+
+void
+SharedMemoryConnector::update()
+{
+	if (not this->hasCurrent) {
+		this->hasCurrent = this->readPacket(this->current);
+	}
+}
+
+// ----------------------------------------------------------------------------
+bool
+SharedMemoryConnector::isPacketAvailable() const
+{
+	return this->hasCurrent;
+}
+
+const Header&
+SharedMemoryConnector::getPacketHeader() const
+{
+	return this->current.header;
+}
+
+const xpcc::SmartPointer
+SharedMemoryConnector::getPacketPayload() const
+{
+	return this->current.payload;
+}
+
+void
+SharedMemoryConnector::dropPacket()
+{
+	this->current.payload = SmartPointer();
+	this->hasCurrent = false;
+}
+
+// ----------------------------------------------------------------------------
+uint8_t
+SharedMemoryConnector::receivePackets(Packet *packets, uint8_t maximum)
+{
+	uint8_t count = 0;
+	if (this->hasCurrent and maximum > 0)
+	{
+		packets[count++] = this->current;
+		this->dropPacket();
+	}
+
+	// read directly from the ring without a local queue
+	while (count < maximum and this->readPacket(packets[count])) {
+		count++;
+	}
+	return count;
+}
+
+bool
+SharedMemoryConnector::waitForPacket(uint16_t timeout)
+{
+	if (this->hasCurrent) {
+		return true;
+	}
+	return this->ring.wait(timeout);
+}
+
+} // xpcc namespace
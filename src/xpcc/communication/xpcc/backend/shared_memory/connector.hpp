@@ -0,0 +1,135 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__SHARED_MEMORY_CONNECTOR_HPP
+#define	XPCC__SHARED_MEMORY_CONNECTOR_HPP
+
+#include <string>
+
+#include "../backend_interface.hpp"
+#include "ring.hpp"
+
+namespace xpcc
+{
+
+/**
+ * @brief	Backend for processes on the same host
+ *
+ * All connectors which use the same name share one SharedMemoryRing.
+ * Every packet sent by one connector is received by all others, like
+ * with the ZeroMQ or TIPC backends, but without a system call or a
+ * thread per packet. A waiting receiver is woken by a futex.
+ *
+ * @code
+ * xpcc::SharedMemoryConnector connector("/robot");
+ * xpcc::Dispatcher dispatcher(&connector, &postman);
+ *
+ * while (true) {
+ *     dispatcher.waitForPacket(10);
+ *     dispatcher.update();
+ * }
+ * @endcode
+ *
+ * A connector which doesn't read the ring for longer than the ring
+ * needs to wrap around loses the oldest packets, see getLostPackets().
+ * The capacity and the largest payload are chosen by the first connector,
+ * which creates the ring.
+ *
+ * @ingroup	backend
+ */
+class SharedMemoryConnector : public BackendInterface
+{
+public:
+	/**
+	 * @param	name		Name of the shared memory segment, starting
+	 * 						with a slash
+	 * @param	slotCount	Number of packets in the ring
+	 * @param	slotSize	Largest payload in bytes
+	 */
+	SharedMemoryConnector(const std::string& name, std::size_t slotCount = 1024,
+			std::size_t slotSize = 256);
+
+	virtual void
+	sendPacket(const Header &header, SmartPointer payload = SmartPointer()) override;
+
+	virtual bool
+	isPacketAvailable() const override;
+
+	virtual const Header&
+	getPacketHeader() const override;
+
+	virtual const xpcc::SmartPointer
+	getPacketPayload() const override;
+
+	virtual void
+	dropPacket() override;
+
+	virtual uint8_t
+	receivePackets(Packet *packets, uint8_t maximum) override;
+
+	virtual bool
+	waitForPacket(uint16_t timeout) override;
+
+	virtual void
+	update() override;
+
+	/// `false` if the shared memory couldn't be opened
+	inline bool
+	isOpen() const
+	{
+		return this->ring.isOpen();
+	}
+
+	/// Received packets which were overwritten before they were read
+	inline uint32_t
+	getLostPackets() const
+	{
+		return this->lostPackets;
+	}
+
+	/// Packets which weren't sent because the payload exceeded the slot size
+	inline uint32_t
+	getDroppedPackets() const
+	{
+		return this->droppedPackets;
+	}
+
+	/// Slots taken over from producers which died while writing,
+	/// see SharedMemoryRing::getAbandonedSlots()
+	inline uint32_t
+	getAbandonedSlots() const
+	{
+		return this->ring.getAbandonedSlots();
+	}
+
+	/// Remove the shared memory segment, see SharedMemoryRing::remove()
+	static inline bool
+	remove(const std::string& name)
+	{
+		return SharedMemoryRing::remove(name);
+	}
+
+protected:
+	bool
+	readPacket(Packet& packet);
+
+protected:
+	SharedMemoryRing ring;
+
+	/// Packet returned by getPacketHeader() and getPacketPayload()
+	Packet current;
+	bool hasCurrent;
+
+	uint32_t lostPackets;
+	uint32_t droppedPackets;
+};
+
+} // xpcc namespace
+
+#endif // XPCC__SHARED_MEMORY_CONNECTOR_HPP
@@ -0,0 +1,538 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "ring.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <xpcc/debug/logger.hpp>
+
+#undef  XPCC_LOG_LEVEL
+#define XPCC_LOG_LEVEL xpcc::log::DEBUG
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 and ATOMIC_INT_LOCK_FREE == 2,
+		"The shared memory ring requires lock-free atomics!");
+
+namespace xpcc
+{
+
+// ----------------------------------------------------------------------------
+struct SharedMemoryRing::Slot
+{
+	/**
+	 * State of the slot for packet n:
+	 *
+	 * - 4 * (n + 1) - 1 while packet n is written
+	 * - 4 * (n + 1) once it is published
+	 * - 4 * (n + 1) + 1 if packet n was abandoned, the producer of an
+	 *   earlier lap may still write into the slot
+	 * - 4 * (n + 1) + 2 if packet n was abandoned and the slot is free
+	 */
+	std::atomic<uint64_t> sequence;
+	/// Header and payload size
+	std::atomic<uint64_t> packet;
+	std::atomic<uint32_t> producer;
+
+	// followed by the payload buffer
+};
+
+struct SharedMemoryRing::Control
+{
+	static constexpr uint32_t magicValue = 0x78706363;	// "xpcc"
+
+	std::atomic<uint32_t> magic;
+	uint32_t slotCount;
+	uint32_t slotSize;
+	std::atomic<uint32_t> nextProducer;
+
+	// written by the producers only
+	alignas(64) std::atomic<uint64_t> head;
+
+	// futex word, incremented for every published packet
+	alignas(64) std::atomic<uint32_t> published;
+	std::atomic<uint32_t> waiters;
+
+	// slots taken over from dead producers
+	std::atomic<uint32_t> abandoned;
+};
+
+constexpr uint32_t SharedMemoryRing::Control::magicValue;
+constexpr uint32_t SharedMemoryRing::takeoverTimeout;
+
+namespace
+{
+	constexpr uint64_t
+	writing(uint64_t n)
+	{
+		return 4 * (n + 1) - 1;
+	}
+
+	constexpr uint64_t
+	published(uint64_t n)
+	{
+		return 4 * (n + 1);
+	}
+
+	constexpr uint64_t
+	abandoned(uint64_t n)
+	{
+		return 4 * (n + 1) + 1;
+	}
+
+	enum State : uint64_t
+	{
+		Published = 0,
+		Abandoned = 1,
+		Released = 2,
+		Writing = 3,
+	};
+
+	inline State
+	getState(uint64_t sequence)
+	{
+		return State(sequence & 3);
+	}
+
+	std::size_t
+	roundUp(std::size_t value, std::size_t minimum)
+	{
+		std::size_t n = minimum;
+		while (n < value) {
+			n <<= 1;
+		}
+		return n;
+	}
+
+	uint64_t
+	pack(const Header& header, std::size_t size)
+	{
+		return uint64_t(static_cast<uint8_t>(header.type)) |
+				(uint64_t(header.isAcknowledge) << 8) |
+				(uint64_t(header.destination) << 16) |
+				(uint64_t(header.source) << 24) |
+				(uint64_t(header.packetIdentifier) << 32) |
+				(uint64_t(size) << 40);
+	}
+
+	Header
+	unpack(uint64_t packet)
+	{
+		return Header(
+				/* type = */ Header::Type(packet & 0xff),
+				/* ack  = */ (packet >> 8) & 0xff,
+				/* dest = */ packet >> 16,
+				/* src  = */ packet >> 24,
+				/* id   = */ packet >> 32);
+	}
+
+	std::size_t
+	unpackSize(uint64_t packet)
+	{
+		return (packet >> 40) & 0xffff;
+	}
+}
+
+// ----------------------------------------------------------------------------
+std::size_t
+SharedMemoryRing::getSlotsOffset()
+{
+	return (sizeof(Control) + 63) & ~std::size_t(63);
+}
+
+std::size_t
+SharedMemoryRing::getSlotStride(std::size_t slotSize)
+{
+	return (sizeof(Slot) + slotSize + 63) & ~std::size_t(63);
+}
+
+std::size_t
+SharedMemoryRing::getSegmentSize(std::size_t slotCount, std::size_t slotSize)
+{
+	return getSlotsOffset() + slotCount * getSlotStride(slotSize);
+}
+
+// ----------------------------------------------------------------------------
+SharedMemoryRing::SharedMemoryRing(const std::string& name,
+		std::size_t slotCount, std::size_t slotSize) :
+	control(nullptr), slots(nullptr), slotStride(0), mappedSize(0),
+	producerId(0), cursor(0)
+{
+	slotCount = roundUp(slotCount, 2);
+	if (slotSize > 0xffff) {
+		slotSize = 0xffff;
+	}
+	std::size_t size = getSegmentSize(slotCount, slotSize);
+
+	bool created = true;
+	int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+	if (fd < 0 and errno == EEXIST)
+	{
+		created = false;
+		fd = shm_open(name.c_str(), O_RDWR, 0);
+	}
+	if (fd < 0) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not open shared memory '"
+				<< name.c_str() << "', errno=" << errno << xpcc::endl;
+		return;
+	}
+
+	if (created)
+	{
+		if (ftruncate(fd, size) < 0)
+		{
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not resize shared memory!" << xpcc::endl;
+			::close(fd);
+			shm_unlink(name.c_str());
+			return;
+		}
+	}
+	else
+	{
+		// the creator may not have resized the segment yet
+		struct stat status;
+		status.st_size = 0;
+		for (int i = 0; i < 1000; ++i)
+		{
+			if (fstat(fd, &status) == 0 and status.st_size > 0) {
+				break;
+			}
+			usleep(1000);
+		}
+		size = status.st_size;
+	}
+
+	void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not map shared memory!" << xpcc::endl;
+		return;
+	}
+
+	Control *segment = static_cast<Control *>(memory);
+	uint8_t *segmentSlots = static_cast<uint8_t *>(memory) + getSlotsOffset();
+	if (created)
+	{
+		new (segment) Control();
+		segment->slotCount = slotCount;
+		segment->slotSize = slotSize;
+		segment->nextProducer = 0;
+		segment->head = 0;
+		segment->published = 0;
+		segment->waiters = 0;
+		segment->abandoned = 0;
+		for (std::size_t i = 0; i < slotCount; ++i)
+		{
+			Slot *slot = new (segmentSlots + i * getSlotStride(slotSize)) Slot();
+			slot->sequence = 0;
+		}
+		segment->magic.store(Control::magicValue, std::memory_order_release);
+	}
+	else
+	{
+		for (int i = 0; i < 1000; ++i)
+		{
+			if (segment->magic.load(std::memory_order_acquire) == Control::magicValue) {
+				break;
+			}
+			usleep(1000);
+		}
+		if (segment->magic.load(std::memory_order_acquire) != Control::magicValue or
+			size != getSegmentSize(segment->slotCount, segment->slotSize))
+		{
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Shared memory '" << name.c_str()
+					<< "' is not a valid ring!" << xpcc::endl;
+			munmap(memory, size);
+			return;
+		}
+	}
+
+	this->control = segment;
+	this->slots = segmentSlots;
+	this->slotStride = getSlotStride(segment->slotSize);
+	this->mappedSize = size;
+
+	this->producerId = segment->nextProducer.fetch_add(1) + 1;
+	this->cursor = segment->head.load(std::memory_order_acquire);
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+	if (this->control != nullptr) {
+		munmap(this->control, this->mappedSize);
+	}
+}
+
+bool
+SharedMemoryRing::remove(const std::string& name)
+{
+	return (shm_unlink(name.c_str()) == 0);
+}
+
+// ----------------------------------------------------------------------------
+std::size_t
+SharedMemoryRing::getSlotCount() const
+{
+	return (this->control != nullptr) ? this->control->slotCount : 0;
+}
+
+std::size_t
+SharedMemoryRing::getSlotSize() const
+{
+	return (this->control != nullptr) ? this->control->slotSize : 0;
+}
+
+uint32_t
+SharedMemoryRing::getAbandonedSlots() const
+{
+	return (this->control != nullptr) ? this->control->abandoned.load() : 0;
+}
+
+SharedMemoryRing::Slot&
+SharedMemoryRing::getSlot(uint64_t sequence) const
+{
+	std::size_t index = sequence & (this->control->slotCount - 1);
+	return *reinterpret_cast<Slot *>(this->slots + index * this->slotStride);
+}
+
+uint8_t *
+SharedMemoryRing::getPayload(Slot& slot)
+{
+	return reinterpret_cast<uint8_t *>(&slot + 1);
+}
+
+// ----------------------------------------------------------------------------
+bool
+SharedMemoryRing::claim(uint64_t& n, Slot*& slot)
+{
+	while (true)
+	{
+		n = this->control->head.fetch_add(1, std::memory_order_acq_rel);
+		slot = &this->getSlot(n);
+
+		// Another producer may still be writing the packet published one
+		// lap earlier, which takes a single copy.
+		uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+		std::chrono::steady_clock::time_point deadline;
+		bool waiting = false;
+		while (true)
+		{
+			if (sequence >= writing(n)) {
+				return false;
+			}
+
+			const State state = getState(sequence);
+			if (state == Published or state == Released)
+			{
+				if (slot->sequence.compare_exchange_weak(sequence, writing(n),
+						std::memory_order_acquire, std::memory_order_relaxed)) {
+					return true;
+				}
+			}
+			else if (state == Abandoned)
+			{
+				// still reserved for a stalled producer, skip it this lap too
+				if (slot->sequence.compare_exchange_weak(sequence, abandoned(n),
+						std::memory_order_relaxed, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else
+			{
+				const auto now = std::chrono::steady_clock::now();
+				if (not waiting)
+				{
+					waiting = true;
+					deadline = now + std::chrono::milliseconds(takeoverTimeout);
+				}
+				else if (now >= deadline)
+				{
+					// The other producer died or stalls while writing, its
+					// packet is lost. The slot stays reserved for it until
+					// it finishes, readers skip packet n.
+					if (slot->sequence.compare_exchange_strong(sequence, abandoned(n),
+							std::memory_order_relaxed, std::memory_order_relaxed))
+					{
+						this->control->abandoned.fetch_add(1);
+						XPCC_LOG_ERROR << XPCC_FILE_INFO << "Took over the slot of packet "
+								<< uint32_t(sequence / 4) << " from a dead producer!" << xpcc::endl;
+						break;
+					}
+					continue;
+				}
+				std::this_thread::yield();
+				sequence = slot->sequence.load(std::memory_order_relaxed);
+			}
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+bool
+SharedMemoryRing::publish(const Header& header, const SmartPointer& payload)
+{
+	std::size_t size = payload.getSize();
+	if (this->control == nullptr or size > this->control->slotSize) {
+		return false;
+	}
+
+	uint64_t n;
+	Slot *slot;
+	if (not this->claim(n, slot)) {
+		// a later packet already took the slot
+		return false;
+	}
+	// readers must not see the new payload before the claim
+	std::atomic_thread_fence(std::memory_order_release);
+
+	std::memcpy(getPayload(*slot), payload.getPointer(), size);
+	slot->packet.store(pack(header, size), std::memory_order_relaxed);
+	slot->producer.store(this->producerId, std::memory_order_relaxed);
+
+	uint64_t sequence = writing(n);
+	if (not slot->sequence.compare_exchange_strong(sequence, published(n),
+			std::memory_order_release, std::memory_order_relaxed))
+	{
+		// Another producer took the slot over while this one was stalled.
+		// Nobody publishes into it until it is released here, so neither
+		// the payload nor the header of another packet was touched.
+		while (getState(sequence) == Abandoned and
+				not slot->sequence.compare_exchange_weak(sequence, sequence + 1,
+						std::memory_order_release, std::memory_order_relaxed)) {
+		}
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Dropped packet " << uint32_t(n)
+				<< ", its slot was taken over!" << xpcc::endl;
+		return false;
+	}
+
+	this->control->published.fetch_add(1);
+	if (this->control->waiters.load() > 0) {
+		syscall(SYS_futex, &this->control->published, FUTEX_WAKE, INT_MAX,
+				nullptr, nullptr, 0);
+	}
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+SharedMemoryRing::Result
+SharedMemoryRing::read(Header& header, SmartPointer& payload, std::size_t& lost)
+{
+	lost = 0;
+	while (this->control != nullptr)
+	{
+		Slot& slot = this->getSlot(this->cursor);
+		const uint64_t expected = published(this->cursor);
+		uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence < expected) {
+			// not yet published or still being written
+			return Result::Empty;
+		}
+		if (sequence == abandoned(this->cursor) or sequence == abandoned(this->cursor) + 1)
+		{
+			// the producer published its packet in a later slot
+			this->cursor++;
+			continue;
+		}
+		if (sequence > expected)
+		{
+			// overwritten, continue with the oldest packet still available
+			uint64_t oldest = this->control->head.load(std::memory_order_acquire) -
+					this->control->slotCount;
+			if (oldest <= this->cursor) {
+				oldest = this->cursor + 1;
+			}
+			lost = oldest - this->cursor;
+			this->cursor = oldest;
+			return Result::Lost;
+		}
+
+		uint64_t packet = slot.packet.load(std::memory_order_relaxed);
+		bool own = (slot.producer.load(std::memory_order_relaxed) == this->producerId);
+
+		SmartPointer data;
+		if (not own)
+		{
+			std::size_t size = unpackSize(packet);
+			if (size > this->control->slotSize) {
+				// torn read, rejected below
+				size = 0;
+			}
+			data = SmartPointer(uint16_t(size));
+			std::memcpy(data.getPointer(), getPayload(slot), size);
+		}
+
+		// validate the copy like a seqlock
+		std::atomic_thread_fence(std::memory_order_acquire);
+		this->cursor++;
+		if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+		{
+			lost = 1;
+			return Result::Lost;
+		}
+
+		if (not own)
+		{
+			header = unpack(packet);
+			payload = data;
+			return Result::Packet;
+		}
+	}
+	return Result::Empty;
+}
+
+bool
+SharedMemoryRing::isPacketAvailable() const
+{
+	if (this->control == nullptr) {
+		return false;
+	}
+	return (this->getSlot(this->cursor).sequence.load(std::memory_order_acquire) >=
+			published(this->cursor));
+}
+
+bool
+SharedMemoryRing::wait(uint16_t timeout)
+{
+	if (this->control == nullptr) {
+		return false;
+	}
+	if (this->isPacketAvailable()) {
+		return true;
+	}
+
+	// The futex returns immediately if a packet was published after
+	// reading the counter, so no wakeup gets lost.
+	uint32_t seen = this->control->published.load();
+	this->control->waiters.fetch_add(1);
+	if (not this->isPacketAvailable())
+	{
+		struct timespec time;
+		time.tv_sec = timeout / 1000;
+		time.tv_nsec = (timeout % 1000) * 1000000L;
+		syscall(SYS_futex, &this->control->published, FUTEX_WAIT, seen,
+				&time, nullptr, 0);
+	}
+	this->control->waiters.fetch_sub(1);
+
+	return this->isPacketAvailable();
+}
+
+} // xpcc namespace
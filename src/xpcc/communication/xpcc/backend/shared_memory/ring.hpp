@@ -0,0 +1,190 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__SHARED_MEMORY_RING_HPP
+#define	XPCC__SHARED_MEMORY_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <stdint.h>
+
+#include <xpcc/container/smart_pointer.hpp>
+
+#include "../header.hpp"
+
+namespace xpcc
+{
+
+/**
+ * @brief	Broadcast ring of xpcc packets in a POSIX shared memory segment
+ *
+ * Every process which opens a ring with the same name maps the same
+ * segment. Any number of producers publish packets, every reader keeps
+ * its own cursor and receives all packets published after it opened
+ * the ring. Neither side takes a lock or enters the kernel, except to
+ * block an idle reader in wait().
+ *
+ * The segment consists of a ring of slots, each holding the header and
+ * a buffer for the payload of one packet:
+ *
+ * - A producer claims the next slot with a single atomic increment and
+ *   copies the header and payload into it. Payloads larger than the
+ *   slot size are rejected.
+ * - Each slot carries a sequence number which tells whether the slot is
+ *   written, only one producer can own a slot at a time. A reader checks
+ *   the sequence number again after copying the packet (like a seqlock),
+ *   so packets overwritten while reading are detected.
+ * - Producers never wait for readers. A reader which falls more than a
+ *   full ring behind loses the oldest packets, see Result::Lost.
+ * - A producer only waits for the producer of the previous lap of its
+ *   slot. If that one doesn't finish within takeoverTimeout, it is
+ *   assumed to have died while writing: its packet is lost for all
+ *   readers and counted, see getAbandonedSlots(). The slot stays reserved
+ *   for that producer, packets of later laps skip it and take the next
+ *   one. A producer which was merely stalled finishes writing into the
+ *   reserved slot, drops its packet and releases the slot.
+ *
+ * Readers block on a futex in the segment, producers only issue the wake
+ * system call while a reader is actually waiting.
+ *
+ * The segment is not removed when the last ring is closed, use remove()
+ * once it is no longer needed.
+ *
+ * @ingroup	backend
+ */
+class SharedMemoryRing
+{
+public:
+	/// Time in milliseconds a producer waits for the producer of the
+	/// previous lap of its slot
+	static constexpr uint32_t takeoverTimeout = 100;
+
+	enum class Result
+	{
+		/// No new packet
+		Empty,
+		/// A packet was read
+		Packet,
+		/// Packets were overwritten before they could be read
+		Lost,
+	};
+
+public:
+	/**
+	 * @brief	Open or create the ring \p name
+	 *
+	 * @param	name		Name of the segment, e.g. "/xpcc"
+	 * @param	slotCount	Number of slots, rounded up to the next power
+	 * 						of two. Ignored if the ring exists.
+	 * @param	slotSize	Largest payload in bytes. Ignored if the ring
+	 * 						exists.
+	 */
+	SharedMemoryRing(const std::string& name, std::size_t slotCount = 1024,
+			std::size_t slotSize = 256);
+
+	~SharedMemoryRing();
+
+	SharedMemoryRing(const SharedMemoryRing&) = delete;
+	SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+	/// Remove the segment, rings which are still open stay usable
+	static bool
+	remove(const std::string& name);
+
+	inline bool
+	isOpen() const
+	{
+		return (this->control != nullptr);
+	}
+
+	/// Identifier unique among all producers of this ring
+	inline uint32_t
+	getProducerId() const
+	{
+		return this->producerId;
+	}
+
+	std::size_t
+	getSlotCount() const;
+
+	/// Largest payload which can be published
+	std::size_t
+	getSlotSize() const;
+
+	/// Slots taken over from dead producers by all processes
+	uint32_t
+	getAbandonedSlots() const;
+
+	/**
+	 * @brief	Publish a packet to all readers
+	 *
+	 * @return	`false` if the payload is larger than the slot size, a
+	 * 			later packet already took the slot or the slot was taken
+	 * 			over while writing
+	 */
+	bool
+	publish(const Header& header, const SmartPointer& payload);
+
+	/**
+	 * @brief	Read the next packet
+	 *
+	 * Packets published by this ring itself are skipped. On
+	 * Result::Lost the cursor was moved forward, \p lost holds the
+	 * number of skipped packets.
+	 */
+	Result
+	read(Header& header, SmartPointer& payload, std::size_t& lost);
+
+	/// `true` if packets were published after the cursor
+	bool
+	isPacketAvailable() const;
+
+	/// Block until a packet was published or \p timeout milliseconds passed
+	bool
+	wait(uint16_t timeout);
+
+private:
+	struct Slot;
+	struct Control;
+
+	/// Slots start on their own cache line after the control block
+	static std::size_t
+	getSlotsOffset();
+
+	/// Distance between two slots, a multiple of the cache line size
+	static std::size_t
+	getSlotStride(std::size_t slotSize);
+
+	static std::size_t
+	getSegmentSize(std::size_t slotCount, std::size_t slotSize);
+
+	Slot&
+	getSlot(uint64_t sequence) const;
+
+	/// Reserve the slot of the next packet \p n for writing
+	bool
+	claim(uint64_t& n, Slot*& slot);
+
+	static uint8_t *
+	getPayload(Slot& slot);
+
+private:
+	Control *control;
+	uint8_t *slots;
+	std::size_t slotStride;
+	std::size_t mappedSize;
+
+	uint32_t producerId;
+	uint64_t cursor;
+};
+
+} // xpcc namespace
+
+#endif // XPCC__SHARED_MEMORY_RING_HPP
@@ -0,0 +1,278 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <xpcc/communication/xpcc/backend/shared_memory/connector.hpp>
+
+#include "shared_memory_test.hpp"
+
+namespace
+{
+	std::string
+	getName(const char *test)
+	{
+		std::string name = "/xpcc-test-" + std::to_string(getpid()) + "-" + test;
+		xpcc::SharedMemoryConnector::remove(name);
+		return name;
+	}
+	
+	xpcc::SmartPointer
+	createPayload(uint16_t size, uint8_t value)
+	{
+		xpcc::SmartPointer payload(size);
+		for (uint16_t i = 0; i < size; ++i) {
+			payload.getPointer()[i] = value + i;
+		}
+		return payload;
+	}
+	
+	bool
+	checkPayload(const xpcc::SmartPointer& payload, uint16_t size, uint8_t value)
+	{
+		if (payload.getSize() != size) {
+			return false;
+		}
+		for (uint16_t i = 0; i < size; ++i)
+		{
+			if (payload.getPointer()[i] != uint8_t(value + i)) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+SharedMemoryTest::testBroadcast()
+{
+	std::string name = getName("broadcast");
+	xpcc::SharedMemoryConnector connector0(name);
+	xpcc::SharedMemoryConnector connector1(name);
+	xpcc::SharedMemoryConnector connector2(name);
+	TEST_ASSERT_TRUE(connector0.isOpen());
+	TEST_ASSERT_TRUE(connector1.isOpen());
+	TEST_ASSERT_TRUE(connector2.isOpen());
+	
+	xpcc::Header header(xpcc::Header::Type::RESPONSE, true, 0x12, 0x34, 0x56);
+	connector0.sendPacket(header, createPayload(10, 0x20));
+	connector0.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 0x34, 0x57));
+	
+	// the sender doesn't receive its own packets
+	connector0.update();
+	TEST_ASSERT_FALSE(connector0.isPacketAvailable());
+	
+	connector1.update();
+	TEST_ASSERT_TRUE(connector1.isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector1.getPacketHeader(), header);
+	TEST_ASSERT_TRUE(checkPayload(connector1.getPacketPayload(), 10, 0x20));
+	connector1.dropPacket();
+	connector1.update();
+	TEST_ASSERT_TRUE(connector1.isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector1.getPacketHeader().packetIdentifier, 0x57);
+	TEST_ASSERT_EQUALS(connector1.getPacketPayload().getSize(), 0U);
+	connector1.dropPacket();
+	connector1.update();
+	TEST_ASSERT_FALSE(connector1.isPacketAvailable());
+	
+	// every connector has its own cursor
+	xpcc::BackendInterface::Packet packets[4];
+	TEST_ASSERT_EQUALS(connector2.receivePackets(packets, 4), 2);
+	TEST_ASSERT_EQUALS(packets[0].header, header);
+	TEST_ASSERT_TRUE(checkPayload(packets[0].payload, 10, 0x20));
+	TEST_ASSERT_EQUALS(packets[1].header, xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 0x34, 0x57));
+	TEST_ASSERT_EQUALS(connector2.receivePackets(packets, 4), 0);
+	
+	connector2.sendPacket(header, createPayload(3, 0x40));
+	TEST_ASSERT_EQUALS(connector0.receivePackets(packets, 4), 1);
+	TEST_ASSERT_TRUE(checkPayload(packets[0].payload, 3, 0x40));
+	TEST_ASSERT_EQUALS(connector2.receivePackets(packets, 4), 0);
+	
+	TEST_ASSERT_EQUALS(connector1.getLostPackets(), 0U);
+	TEST_ASSERT_EQUALS(connector0.getDroppedPackets(), 0U);
+	
+	TEST_ASSERT_TRUE(xpcc::SharedMemoryConnector::remove(name));
+}
+
+void
+SharedMemoryTest::testRingOverrun()
+{
+	std::string name = getName("ring");
+	xpcc::SharedMemoryConnector receiver(name, 4);
+	// the ring already exists, the capacity is ignored
+	xpcc::SharedMemoryConnector sender(name, 1024);
+	
+	for (uint8_t i = 0; i < 10; ++i) {
+		sender.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, i));
+	}
+	
+	// only the last four packets are left
+	xpcc::BackendInterface::Packet packets[10];
+	TEST_ASSERT_EQUALS(receiver.receivePackets(packets, 10), 4);
+	TEST_ASSERT_EQUALS(receiver.getLostPackets(), 6U);
+	for (uint8_t i = 0; i < 4; ++i) {
+		TEST_ASSERT_EQUALS(packets[i].header.packetIdentifier, 6 + i);
+	}
+	
+	xpcc::SharedMemoryConnector::remove(name);
+}
+
+void
+SharedMemoryTest::testSlotReuse()
+{
+	std::string name = getName("reuse");
+	xpcc::SharedMemoryConnector sender(name, 4, 32);
+	xpcc::SharedMemoryConnector receiver(name);
+	
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x56);
+	xpcc::BackendInterface::Packet packets[3];
+	for (uint8_t i = 0; i < 10; ++i)
+	{
+		// the slots are overwritten every few packets
+		sender.sendPacket(header, createPayload(20, i));
+		sender.sendPacket(header, createPayload(7, i + 100));
+		sender.sendPacket(header, createPayload(32 - i, i + 200));
+		
+		TEST_ASSERT_EQUALS(receiver.receivePackets(packets, 3), 3);
+		TEST_ASSERT_TRUE(checkPayload(packets[0].payload, 20, i));
+		TEST_ASSERT_TRUE(checkPayload(packets[1].payload, 7, i + 100));
+		TEST_ASSERT_TRUE(checkPayload(packets[2].payload, 32 - i, i + 200));
+	}
+	TEST_ASSERT_EQUALS(receiver.getLostPackets(), 0U);
+	
+	xpcc::SharedMemoryConnector::remove(name);
+}
+
+void
+SharedMemoryTest::testPayloadSize()
+{
+	std::string name = getName("size");
+	xpcc::SharedMemoryConnector sender(name, 16, 32);
+	xpcc::SharedMemoryConnector receiver(name);
+	
+	// payloads larger than a slot are dropped
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x56);
+	sender.sendPacket(header, createPayload(32, 0));
+	sender.sendPacket(header, createPayload(33, 0));
+	TEST_ASSERT_EQUALS(sender.getDroppedPackets(), 1U);
+	
+	xpcc::BackendInterface::Packet packets[2];
+	TEST_ASSERT_EQUALS(receiver.receivePackets(packets, 2), 1);
+	TEST_ASSERT_TRUE(checkPayload(packets[0].payload, 32, 0));
+	TEST_ASSERT_EQUALS(receiver.getLostPackets(), 0U);
+	
+	xpcc::SharedMemoryConnector::remove(name);
+}
+
+void
+SharedMemoryTest::testWaitForPacket()
+{
+	std::string name = getName("wait");
+	xpcc::SharedMemoryConnector sender(name);
+	xpcc::SharedMemoryConnector receiver(name);
+	
+	TEST_ASSERT_FALSE(receiver.waitForPacket(0));
+	
+	std::thread thread([&sender]() {
+		usleep(20000);
+		sender.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x56));
+	});
+	TEST_ASSERT_TRUE(receiver.waitForPacket(1000));
+	thread.join();
+	
+	receiver.update();
+	TEST_ASSERT_TRUE(receiver.isPacketAvailable());
+	TEST_ASSERT_TRUE(receiver.waitForPacket(0));
+	receiver.dropPacket();
+	TEST_ASSERT_FALSE(receiver.waitForPacket(10));
+	
+	xpcc::SharedMemoryConnector::remove(name);
+}
+
+void
+SharedMemoryTest::testDeadProducer()
+{
+	std::string name = getName("dead");
+	xpcc::SharedMemoryConnector sender(name, 4, 8);
+	xpcc::SharedMemoryConnector receiver(name);
+	
+	for (uint8_t i = 0; i < 4; ++i) {
+		sender.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, i));
+	}
+	xpcc::BackendInterface::Packet packets[4];
+	TEST_ASSERT_EQUALS(receiver.receivePackets(packets, 4), 4);
+	
+	// Simulate a producer which died while writing packet 4 into the
+	// first slot. The head of the ring comes on the second cache line.
+	// With 8 byte payloads every slot takes one cache line at the end of
+	// the segment, the sequence number comes first.
+	int fd = shm_open(name.c_str(), O_RDWR, 0);
+	TEST_ASSERT_TRUE(fd >= 0);
+	struct stat status;
+	TEST_ASSERT_EQUALS(fstat(fd, &status), 0);
+	void *memory = mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	TEST_ASSERT_TRUE(memory != MAP_FAILED);
+	uint64_t *head = reinterpret_cast<uint64_t *>(static_cast<uint8_t *>(memory) + 64);
+	uint64_t *sequence = reinterpret_cast<uint64_t *>(
+			static_cast<uint8_t *>(memory) + status.st_size - 4 * 64);
+	TEST_ASSERT_EQUALS(*head, 4U);
+	TEST_ASSERT_EQUALS(*sequence, 4U);
+	*head = 5;
+	*sequence = 4 * 5 - 1;
+	
+	// packet 8 takes over the slot after the timeout and moves on to the
+	// next one, readers lose packet 4 and the overwritten packet 5
+	const auto start = std::chrono::steady_clock::now();
+	for (uint8_t i = 5; i <= 8; ++i) {
+		sender.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, i));
+	}
+	TEST_ASSERT_TRUE(std::chrono::steady_clock::now() - start >=
+			std::chrono::milliseconds(xpcc::SharedMemoryRing::takeoverTimeout));
+	TEST_ASSERT_EQUALS(*sequence, 4U * 9 + 1);
+	TEST_ASSERT_EQUALS(*head, 10U);
+	TEST_ASSERT_EQUALS(sender.getAbandonedSlots(), 1U);
+	TEST_ASSERT_EQUALS(receiver.getAbandonedSlots(), 1U);
+	
+	TEST_ASSERT_EQUALS(receiver.receivePackets(packets, 4), 3);
+	TEST_ASSERT_EQUALS(receiver.getLostPackets(), 2U);
+	TEST_ASSERT_EQUALS(packets[0].header.packetIdentifier, 6);
+	TEST_ASSERT_EQUALS(packets[1].header.packetIdentifier, 7);
+	TEST_ASSERT_EQUALS(packets[2].header.packetIdentifier, 8);
+	
+	// the slot stays reserved for the stalled producer on the next lap
+	sender.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 9));
+	sender.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 10));
+	sender.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 11));
+	TEST_ASSERT_EQUALS(*sequence, 4U * 13 + 1);
+	TEST_ASSERT_EQUALS(sender.getAbandonedSlots(), 1U);
+	TEST_ASSERT_EQUALS(receiver.receivePackets(packets, 4), 3);
+	TEST_ASSERT_EQUALS(packets[2].header.packetIdentifier, 11);
+	
+	// once released, the slot is used again
+	*sequence += 1;
+	for (uint8_t i = 12; i <= 14; ++i) {
+		sender.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, i));
+	}
+	TEST_ASSERT_EQUALS(*sequence, 4U * 17);
+	TEST_ASSERT_EQUALS(receiver.receivePackets(packets, 4), 3);
+	TEST_ASSERT_EQUALS(packets[2].header.packetIdentifier, 14);
+	TEST_ASSERT_EQUALS(receiver.getLostPackets(), 2U);
+	
+	munmap(memory, status.st_size);
+	xpcc::SharedMemoryConnector::remove(name);
+}
@@ -0,0 +1,37 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef SHARED_MEMORY_TEST_HPP
+#define SHARED_MEMORY_TEST_HPP
+
+#include <unittest/testsuite.hpp>
+
+class SharedMemoryTest : public unittest::TestSuite
+{
+public:
+	void
+	testBroadcast();
+	
+	void
+	testRingOverrun();
+	
+	void
+	testSlotReuse();
+	
+	void
+	testPayloadSize();
+	
+	void
+	testWaitForPacket();
+	
+	void
+	testDeadProducer();
+};
+
+#endif // SHARED_MEMORY_TEST_HPP
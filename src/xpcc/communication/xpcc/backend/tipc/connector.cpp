@@ -34,8 +34,8 @@
 #define XPCC_LOG_LEVEL xpcc::log::WARNING
 
 // ----------------------------------------------------------------------------
-xpcc::TipcConnector::TipcConnector() :
-	receiver(this->transmitter.getPortId())
+xpcc::TipcConnector::TipcConnector(std::size_t receiveQueueSize) :
+	receiver(this->transmitter.getPortId(), receiveQueueSize)
 {
 }
 
@@ -52,6 +52,32 @@ xpcc::TipcConnector::setDomainId(unsigned int domainId)
 	this->receiver.setDomainId( domainId );
 }
 
+// ----------------------------------------------------------------------------
+void
+xpcc::TipcConnector::setSubscriptions(const Postman& postman)
+{
+	// component 0 is the destination of events
+	for (unsigned int id = 1; id < 256; ++id)
+	{
+		if (postman.isComponentAvailable(id)) {
+			this->receiver.addReceiverId(id);
+		}
+		else {
+			this->receiver.removeReceiverId(id);
+		}
+	}
+
+	for (unsigned int id = 0; id < 256; ++id)
+	{
+		if (postman.isEventSubscribed(id)) {
+			this->receiver.addEventId(id);
+		}
+		else {
+			this->receiver.removeEventId(id);
+		}
+	}
+}
+
 // ----------------------------------------------------------------------------
 bool
 xpcc::TipcConnector::isPacketAvailable() const
@@ -87,6 +113,36 @@ xpcc::TipcConnector::dropPacket()
 	this->receiver.dropPacket();
 }
 
+// ----------------------------------------------------------------------------
+bool
+xpcc::TipcConnector::waitForPacket(uint16_t timeout)
+{
+	return this->receiver.waitForPacket(timeout);
+}
+
+// ----------------------------------------------------------------------------
+uint8_t
+xpcc::TipcConnector::receivePackets(Packet *packets, uint8_t maximum)
+{
+	uint8_t count = this->receiver.readPackets(packets, maximum);
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		// split the received packet into the xpcc header and payload
+		const SmartPointer packet = packets[i].payload;
+		packets[i].header = *(const xpcc::Header*) packet.getPointer();
+
+		SmartPointer payload( packet.getSize() - sizeof(xpcc::Header) );
+		if( payload.getSize() > 0 ) {
+			memcpy(
+					payload.getPointer(),
+					packet.getPointer() + sizeof(xpcc::Header),
+					payload.getSize() );
+		}
+		packets[i].payload = payload;
+	}
+	return count;
+}
+
 // ----------------------------------------------------------------------------
 void
 xpcc::TipcConnector::sendPacket(const xpcc::Header &header, SmartPointer payload)
@@ -121,5 +177,6 @@ xpcc::TipcConnector::sendPacket(const xpcc::Header &header, SmartPointer payload
 void
 xpcc::TipcConnector::update()
 {
-	// nothing to do, because TipcReceiver is using threads
+	// nothing else to do, because TipcReceiver is using threads
+	this->receiver.clearNotification();
 }
@@ -38,6 +38,7 @@
 #include <xpcc/container/smart_pointer.hpp>
 
 #include "../backend_interface.hpp"
+#include "../../postman/postman.hpp"
 
 namespace xpcc
 {
@@ -47,6 +48,11 @@ namespace xpcc
 	 * Messages that are received by the same connector, that has transmitted
 	 * them, will be ignored.
 	 *
+	 * Only events and components subscribed with addEventId() and
+	 * addReceiverId(), or all at once with setSubscriptions(), are bound
+	 * as TIPC name sequences. Other packets are filtered by the kernel
+	 * and never reach this connector.
+	 *
 	 * \see 	tipc
 	 *
 	 * \ingroup	backend
@@ -55,7 +61,12 @@ namespace xpcc
 	class TipcConnector : public BackendInterface
 	{
 	public :
-		TipcConnector();
+		/**
+		 * \param	receiveQueueSize	Capacity of the receive queue,
+		 * 							rounded up to the next power of two
+		 */
+		explicit
+		TipcConnector(std::size_t receiveQueueSize = 1024);
 
 		~TipcConnector();
 
@@ -92,6 +103,46 @@ namespace xpcc
 			this->receiver.addReceiverId(id);
 		}
 
+		/// Stop receiving an event
+		inline void
+		removeEventId(uint8_t id)
+		{
+			this->receiver.removeEventId(id);
+		}
+
+		/// Stop receiving packets for a component
+		inline void
+		removeReceiverId(uint8_t id)
+		{
+			this->receiver.removeReceiverId(id);
+		}
+
+		/**
+		 * \brief	Subscribe to the components and events of a postman
+		 *
+		 * Adds a receiver for every component for which
+		 * Postman::isComponentAvailable() returns \c true and every
+		 * event for which Postman::isEventSubscribed() returns \c true.
+		 * All other subscriptions are withdrawn. Call it again whenever
+		 * components or event listeners are added.
+		 */
+		void
+		setSubscriptions(const Postman& postman);
+
+		/// Delivered and dropped packets addressed to component \p id
+		inline tipc::Receiver::Statistics
+		getComponentStatistics(uint8_t id) const
+		{
+			return this->receiver.getComponentStatistics(id);
+		}
+
+		/// Delivered and dropped packets of the event \p id
+		inline tipc::Receiver::Statistics
+		getEventStatistics(uint8_t id) const
+		{
+			return this->receiver.getEventStatistics(id);
+		}
+
 		/// Check if a new packet was received by the backend
 		virtual bool
 		isPacketAvailable() const;
@@ -120,14 +171,43 @@ namespace xpcc
 		virtual void
 		dropPacket();
 
+		/// Number of received packets dropped because the receive queue was full
+		inline uint32_t
+		getDroppedPackets() const
+		{
+			return this->receiver.getOverflows();
+		}
+
+		/// Block until a packet has arrived or \p timeout milliseconds have passed
+		virtual bool
+		waitForPacket(uint16_t timeout);
+
+		/// Move up to \p maximum packets out of the receive queue
+		virtual uint8_t
+		receivePackets(Packet *packets, uint8_t maximum);
+
 		/**
 		 * \brief	Update method
 		 *
-		 * Does nothing here as TIPC is implemented with threads.
+		 * Only resets the descriptor returned by getFileDescriptor(), as
+		 * TIPC is implemented with threads.
 		 */
 		virtual void
 		update();
 
+		/**
+		 * \brief	Descriptor which becomes readable when packets were
+		 * 			received
+		 *
+		 * The descriptor is reset by update(), which has to be followed
+		 * by reading all available packets.
+		 */
+		inline int
+		getFileDescriptor()
+		{
+			return this->receiver.getNotificationDescriptor();
+		}
+
 		/**
 		 * Send a Message.
 		 */
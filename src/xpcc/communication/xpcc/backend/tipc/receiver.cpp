@@ -39,16 +39,23 @@
 
 // ----------------------------------------------------------------------------
 xpcc::tipc::Receiver::Receiver(
-		uint32_t ignoreTipcPortId) :
+		uint32_t ignoreTipcPortId, std::size_t queueSize) :
 	tipcReceiverSocket_(),
 	ignoreTipcPortId_(ignoreTipcPortId),
 	domainId_( tipc::Header::DOMAIN_ID_UNDEFINED ),
-	packetQueue_(),
+	packetQueue_(queueSize),
 	receiverThread_(),
 	receiverSocketLock_(),
-	packetQueueLock_(),
 	isAlive_(true)
 {
+	for (unsigned int i = 0; i < 256; ++i)
+	{
+		this->componentCounters_[i].delivered = 0;
+		this->componentCounters_[i].dropped = 0;
+		this->eventCounters_[i].delivered = 0;
+		this->eventCounters_[i].dropped = 0;
+	}
+
 	// The start of the thread has to be placed _after_ the initialization of isAlive_
 	this->receiverThread_.reset(new Thread(&Receiver::runReceiver, this));
 }
@@ -71,20 +78,35 @@ xpcc::tipc::Receiver::setDomainId( unsigned int domainId )
 void
 xpcc::tipc::Receiver::dropPacket()
 {
-	// Set the mutex guard for the packetQueue
-	MutexGuard packetQueueGuard(this->packetQueueLock_);
-
 	this->packetQueue_.pop();
 }
 
+// ----------------------------------------------------------------------------
+uint8_t
+xpcc::tipc::Receiver::readPackets(BackendInterface::Packet *packets, uint8_t maximum)
+{
+	uint8_t count = 0;
+	while (count < maximum && !this->packetQueue_.isEmpty())
+	{
+		packets[count].payload = this->packetQueue_.getFront();
+		this->packetQueue_.pop();
+		count++;
+	}
+	return count;
+}
+
 // ----------------------------------------------------------------------------
 bool
-xpcc::tipc::Receiver::hasPacket() const
+xpcc::tipc::Receiver::waitForPacket(uint16_t timeout) const
 {
-	// Set the mutex guard for the packetQueue
-	MutexGuard packetQueueGuard(this->packetQueueLock_);
+	return this->packetQueue_.waitForElement(timeout);
+}
 
-	return !this->packetQueue_.empty();
+// ----------------------------------------------------------------------------
+bool
+xpcc::tipc::Receiver::hasPacket() const
+{
+	return !this->packetQueue_.isEmpty();
 }
 
 // ----------------------------------------------------------------------------
@@ -100,8 +122,10 @@ xpcc::tipc::Receiver::runReceiver()
 {
 	while (this->isAlive())
 	{
-		this->update();
-		usleep(1000);
+		// the timeout bounds the time until the destructor is noticed
+		if (this->tipcReceiverSocket_.waitForPacket(100)) {
+			this->update();
+		}
 	}
 
 	XPCC_LOG_INFO << XPCC_FILE_INFO << "Thread terminates." << xpcc::flush;
@@ -114,47 +138,109 @@ void
 xpcc::tipc::Receiver::update()
 {
 	xpcc::tipc::Header tipcHeader;
+	xpcc::Header xpccHeader;
 	uint32_t tipcPortId;
 	// Set the mutex guard for the receiver socket
 	MutexGuard receiverSocketGuard( this->receiverSocketLock_ );
 
-	// Get the TIPC header (typeId and instanceRange) - call by reference
-	while( this->tipcReceiverSocket_.receiveHeader( tipcPortId, tipcHeader ) )
+	// Get the TIPC header and the xpcc header at the start of the payload
+	while( this->tipcReceiverSocket_.receiveHeader(
+			tipcPortId, tipcHeader, &xpccHeader, sizeof(xpccHeader) ) )
 	{
 		// ignore messages, that are send by the port, that shoud be ignored
-		if 		(tipcPortId != this->ignoreTipcPortId_ &&
-				(this->domainId_==Header::DOMAIN_ID_UNDEFINED || this->domainId_==tipcHeader.domainId) )
-		{
-			XPCC_LOG_DEBUG << XPCC_FILE_INFO << "Header available." << xpcc::flush;
+		// and invalid messages without a complete xpcc header
+		if (tipcPortId == this->ignoreTipcPortId_ || tipcHeader.size < sizeof(xpccHeader)) {
+			this->tipcReceiverSocket_.popPayload();
+			continue;
+		}
 
-			// Try to allocate memory for the packet
-			Payload payload ( tipcHeader.size );
+		Counter& counter = this->getCounter(xpccHeader);
 
-			// Get the payload by passing a void pointer by reference and the length
-			// of the payload to be read from the socket.
-			this->tipcReceiverSocket_.receivePayload(
-					payload.getPointer(),
-					tipcHeader.size);
+		// packets may still be queued in the socket after the subscription
+		// was withdrawn
+		if ((this->domainId_ != Header::DOMAIN_ID_UNDEFINED && this->domainId_ != tipcHeader.domainId) ||
+			!this->isSubscribed(xpccHeader))
+		{
+			counter.dropped++;
+			this->tipcReceiverSocket_.popPayload();
+			continue;
+		}
 
-			// Set the mutex guard for the packetQueue
-			MutexGuard packetQueueGuard( this->packetQueueLock_);
+		XPCC_LOG_DEBUG << XPCC_FILE_INFO << "Header available." << xpcc::flush;
 
-			// add the packet to the queue
-			this->packetQueue_.push( payload );
+		// Allocate the packet in its slot of the queue. A local copy would
+		// share the payload with the dispatcher thread after it was published.
+		Payload *payload = this->packetQueue_.reserve( tipcHeader.size );
+		if (payload == nullptr) {
+			counter.dropped++;
+			this->tipcReceiverSocket_.popPayload();
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Packet queue is full, dropping packet." << xpcc::flush;
+			continue;
 		}
-		// Clean the TIPC socket! ( That means removing the current data from the queue)
-		this->tipcReceiverSocket_.popPayload();
+
+		// Copy the payload directly into the packet and remove it from TIPC
+		if (!this->tipcReceiverSocket_.receivePacket(
+				payload->getPointer(),
+				tipcHeader.size))
+		{
+			this->packetQueue_.cancel();
+			counter.dropped++;
+			continue;
+		}
+
+		this->packetQueue_.commit();
+		counter.delivered++;
 	}
 }
+
+// ----------------------------------------------------------------------------
+xpcc::tipc::Receiver::Counter&
+xpcc::tipc::Receiver::getCounter(const xpcc::Header& header)
+{
+	// Events are sent to destination 0, everything else belongs to the
+	// destination component
+	if (header.destination == 0) {
+		return this->eventCounters_[header.packetIdentifier];
+	}
+	return this->componentCounters_[header.destination];
+}
+
+bool
+xpcc::tipc::Receiver::isSubscribed(const xpcc::Header& header) const
+{
+	if (header.destination == 0) {
+		return this->eventIds_.test(header.packetIdentifier);
+	}
+	return this->receiverIds_.test(header.destination);
+}
+
+// ----------------------------------------------------------------------------
+xpcc::tipc::Receiver::Statistics
+xpcc::tipc::Receiver::read(const Counter& counter)
+{
+	Statistics statistics;
+	statistics.delivered = counter.delivered;
+	statistics.dropped = counter.dropped;
+	return statistics;
+}
+
+xpcc::tipc::Receiver::Statistics
+xpcc::tipc::Receiver::getComponentStatistics(uint8_t id) const
+{
+	return read(this->componentCounters_[id]);
+}
+
+xpcc::tipc::Receiver::Statistics
+xpcc::tipc::Receiver::getEventStatistics(uint8_t id) const
+{
+	return read(this->eventCounters_[id]);
+}
 // ----------------------------------------------------------------------------
 const xpcc::SmartPointer&
 xpcc::tipc::Receiver::getPacket() const
 {
-	// Set the mutex guard for the packetQueue
-	MutexGuard packetQueueGuard( this->packetQueueLock_);
-
-	if (!this->packetQueue_.empty()) {
-		return this->packetQueue_.front();
+	if (!this->packetQueue_.isEmpty()) {
+		return this->packetQueue_.getFront();
 	}
 	else {
 		// No packet was available
@@ -170,7 +256,10 @@ xpcc::tipc::Receiver::addEventId(uint8_t id)
 	// Set the mutex guard for the receiver socket
 	MutexGuard receiverSocketGuard(this->receiverSocketLock_);
 
-	// TODO: Logging on which packet one is registered..
+	if (this->eventIds_.test(id)) {
+		return;
+	}
+	this->eventIds_.set(id);
 
 	// Ranges dürfen sich nicht überschneiden. Eine Range gilt fürs gesamte TIPC,
 	// daher ist es nicht möglich in die InstanceId auch die Komponenten ID
@@ -188,7 +277,10 @@ xpcc::tipc::Receiver::addReceiverId(uint8_t id)
 	// Set the mutex guard for the receiver socket
 	MutexGuard receiverSocketGuard(this->receiverSocketLock_);
 
-	// TODO: Logging on which packet one is registered..
+	if (this->receiverIds_.test(id)) {
+		return;
+	}
+	this->receiverIds_.set(id);
 
 	// Ranges dürfen sich nicht überschneiden. Eine Range gilt fürs gesamte TIPC,
 	// daher ist es nicht möglich in die InstanceId auch die Komponenten ID
@@ -198,3 +290,50 @@ xpcc::tipc::Receiver::addReceiverId(uint8_t id)
 												0x00,
 												0x00);
 }
+
+// ----------------------------------------------------------------------------
+void
+xpcc::tipc::Receiver::removeEventId(uint8_t id)
+{
+	MutexGuard receiverSocketGuard(this->receiverSocketLock_);
+
+	if (!this->eventIds_.test(id)) {
+		return;
+	}
+	this->eventIds_.reset(id);
+
+	this->tipcReceiverSocket_.unregisterOnPacket(	EVENT_OFFSET + id + TYPE_ID_OFFSET,
+													0x00,
+													0x00);
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::tipc::Receiver::removeReceiverId(uint8_t id)
+{
+	MutexGuard receiverSocketGuard(this->receiverSocketLock_);
+
+	if (!this->receiverIds_.test(id)) {
+		return;
+	}
+	this->receiverIds_.reset(id);
+
+	this->tipcReceiverSocket_.unregisterOnPacket(	REQUEST_OFFSET + id + TYPE_ID_OFFSET,
+													0x00,
+													0x00);
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::tipc::Receiver::hasEventId(uint8_t id) const
+{
+	MutexGuard receiverSocketGuard(this->receiverSocketLock_);
+	return this->eventIds_.test(id);
+}
+
+bool
+xpcc::tipc::Receiver::hasReceiverId(uint8_t id) const
+{
+	MutexGuard receiverSocketGuard(this->receiverSocketLock_);
+	return this->receiverIds_.test(id);
+}
@@ -31,13 +31,16 @@
 #ifndef XPCC_TIPC__RECEIVER_HPP
 #define XPCC_TIPC__RECEIVER_HPP
 
-#include <queue>
-
+#include <atomic>
+#include <bitset>
 #include <mutex>
 #include <thread>
 #include <memory>
 
 #include <xpcc/container/smart_pointer.hpp>
+#include <xpcc/container/spsc_queue.hpp>
+
+#include "../backend_interface.hpp"
 
 #include "receiver_socket.hpp"
 
@@ -49,6 +52,15 @@ namespace xpcc
 		 * \brief	Receive Packets over the TIPC and store them.
 		 *
 		 * In a separate thread the packets are taken from the TIPC and saved local.
+		 * The packets are handed to the thread calling the Dispatcher through
+		 * a lock-free single-producer/single-consumer queue. If the queue is
+		 * full new packets are dropped and counted, see getOverflows().
+		 *
+		 * Only the events and components added with addEventId() and
+		 * addReceiverId() are bound as TIPC name sequences, so the kernel
+		 * delivers relevant packets only. The receiver counts the delivered
+		 * and dropped packets per component and event, see
+		 * getComponentStatistics() and getEventStatistics().
 		 *
 		 * \ingroup	tipc
 		 * \author	Carsten Schmitt
@@ -56,12 +68,23 @@ namespace xpcc
 		class Receiver
 		{
 		public:
+			/// Packet counters of a component or event
+			struct Statistics
+			{
+				/// Packets handed to the queue
+				uint32_t delivered;
+				/// Packets of a foreign domain, withdrawn subscription or full queue
+				uint32_t dropped;
+			};
+
 			/**
 			 * \param ignoreTipcPortId from this port all messages will be ignored, use this to ignore own transmitted messanges
 			 *
+			 * \param queueSize capacity of the receive queue, rounded up to the next power of two
+			 *
 			 * \see TransmitterSocket::getPortId
 			 */
-			Receiver(uint32_t ignoreTipcPortId);
+			Receiver(uint32_t ignoreTipcPortId, std::size_t queueSize = 1024);
 
 			~Receiver();
 
@@ -74,6 +97,28 @@ namespace xpcc
 			void
 			addReceiverId(uint8_t id);
 
+			/// Withdraw the subscription of an event
+			void
+			removeEventId(uint8_t id);
+
+			/// Withdraw the subscription of a component
+			void
+			removeReceiverId(uint8_t id);
+
+			bool
+			hasEventId(uint8_t id) const;
+
+			bool
+			hasReceiverId(uint8_t id) const;
+
+			/// Counters of the packets addressed to component \p id
+			Statistics
+			getComponentStatistics(uint8_t id) const;
+
+			/// Counters of the event \p id
+			Statistics
+			getEventStatistics(uint8_t id) const;
+
 			/// Check if a new packet has arrived
 			bool
 			hasPacket() const;
@@ -94,6 +139,41 @@ namespace xpcc
 			void
 			dropPacket();
 
+			/// Block until a packet has arrived or \p timeout milliseconds have passed
+			bool
+			waitForPacket(uint16_t timeout) const;
+
+			/**
+			 * \brief	Move up to \p maximum packets out of the queue
+			 *
+			 * Only the payload of the packets is written, it contains
+			 * the xpcc header followed by the xpcc payload.
+			 *
+			 * \return	Number of packets read
+			 */
+			uint8_t
+			readPackets(BackendInterface::Packet *packets, uint8_t maximum);
+
+			/// Readable when a packet arrived, see SpscQueue::getNotificationDescriptor()
+			inline int
+			getNotificationDescriptor()
+			{
+				return this->packetQueue_.getNotificationDescriptor();
+			}
+
+			inline void
+			clearNotification()
+			{
+				this->packetQueue_.clearNotification();
+			}
+
+			/// Number of packets dropped because the queue was full
+			inline uint32_t
+			getOverflows() const
+			{
+				return this->packetQueue_.getOverflows();
+			}
+
 		private:
 			typedef xpcc::SmartPointer		Payload;
 			typedef std::mutex				Mutex;
@@ -109,18 +189,39 @@ namespace xpcc
 			void
 			update();
 
+			struct Counter
+			{
+				std::atomic<uint32_t> delivered;
+				std::atomic<uint32_t> dropped;
+			};
+
+			static Statistics
+			read(const Counter& counter);
+
+			/// Counter of the packet with the xpcc header \p header
+			Counter&
+			getCounter(const xpcc::Header& header);
+
+			bool
+			isSubscribed(const xpcc::Header& header) const;
+
 			ReceiverSocket tipcReceiverSocket_;
 			uint32_t ignoreTipcPortId_;	// the tipc port ID from that all messages will be ignored
 			unsigned int domainId_;
 
-			std::queue<Payload>	packetQueue_;
+			SpscQueue<Payload> packetQueue_;
 
 			std::unique_ptr<Thread> receiverThread_;
 			mutable Mutex receiverSocketLock_;
-			mutable Mutex packetQueueLock_;
 
 			bool isAlive_;
 
+			std::bitset<256> eventIds_;
+			std::bitset<256> receiverIds_;
+
+			Counter componentCounters_[256];
+			Counter eventCounters_[256];
+
 		};
 	}
 }
@@ -30,7 +30,9 @@
 #include "receiver_socket.hpp"
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <linux/tipc.h>
+#include <poll.h>
 #include <errno.h>
 #include <cstring>
 #include <unistd.h>
@@ -87,26 +89,75 @@ xpcc::tipc::ReceiverSocket::registerOnPacket(	unsigned int typeId,
 	}
 }
 // ----------------------------------------------------------------------------
+void
+xpcc::tipc::ReceiverSocket::unregisterOnPacket(	unsigned int typeId,
+												unsigned int lowerInstance,
+												unsigned int upperInstance)
+{
+	sockaddr_tipc fromAddress;
+
+	fromAddress.family				=	AF_TIPC;
+	fromAddress.addrtype			=	TIPC_ADDR_NAMESEQ;
+	fromAddress.addr.nameseq.type	=	typeId;
+	fromAddress.addr.nameseq.lower	=	lowerInstance;
+	fromAddress.addr.nameseq.upper	=	upperInstance;
+	// A negative scope withdraws the binding
+	fromAddress.scope				=	-TIPC_CLUSTER_SCOPE;
+
+	XPCC_LOG_INFO << XPCC_FILE_INFO << "withdraw (typeId, lowerBound, upperBound) = (" << typeId << ", " << lowerInstance << ", " << upperInstance << ")" << xpcc::flush;
+
+	if (0 != bind (	this->socketDescriptor_,
+					(struct sockaddr*)&fromAddress,
+					sizeof(sockaddr_tipc) ))
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Port {" << typeId << ", " << lowerInstance << ", " << upperInstance << "}  could not be withdrawn." << xpcc::flush;
+	}
+}
+// ----------------------------------------------------------------------------
+bool
+xpcc::tipc::ReceiverSocket::waitForPacket(int timeout)
+{
+	struct pollfd descriptor = { this->socketDescriptor_, POLLIN, 0 };
+	return (poll(&descriptor, 1, timeout) > 0);
+}
+// ----------------------------------------------------------------------------
 // This method gets the header of the current TIPC data in the queue.
 // It returns the true if a header was available - otherwise false.
 bool
 xpcc::tipc::ReceiverSocket::receiveHeader(
 		uint32_t& transmitterPort,
 		Header& tipcHeader )
+{
+	return this->receiveHeader(transmitterPort, tipcHeader, 0, 0);
+}
+
+bool
+xpcc::tipc::ReceiverSocket::receiveHeader(
+		uint32_t& transmitterPort,
+		Header& tipcHeader,
+		void* prefix,
+		std::size_t prefixLength )
 {
 	sockaddr_tipc fromAddress;
-	socklen_t addressLength = sizeof( struct sockaddr_tipc );
 	Header localTipcHeader;
   	int result = 0;
 
-	// First receive the tipc-header
-	result = recvfrom(
+	// First receive the tipc-header, and the start of the payload if requested
+	struct iovec parts[2] = {
+		{ &localTipcHeader, sizeof(Header) },
+		{ prefix, prefixLength },
+	};
+	struct msghdr message;
+	std::memset(&message, 0, sizeof(message));
+	message.msg_name = &fromAddress;
+	message.msg_namelen = sizeof( struct sockaddr_tipc );
+	message.msg_iov = parts;
+	message.msg_iovlen = (prefixLength > 0) ? 2 : 1;
+
+	result = recvmsg(
 			this->socketDescriptor_,
-			&localTipcHeader,
-			sizeof(Header),
-			MSG_PEEK | MSG_DONTWAIT,
-	        (sockaddr*) &fromAddress,
-	        &addressLength);
+			&message,
+			MSG_PEEK | MSG_DONTWAIT);
 
 	if( result > 0) {
 		// Make a copy of the received data
@@ -189,6 +240,34 @@ xpcc::tipc::ReceiverSocket::receivePayload(uint8_t* payloadPointer, size_t paylo
 	return false;
 }
 // ----------------------------------------------------------------------------
+bool
+xpcc::tipc::ReceiverSocket::receivePacket(uint8_t* payloadPointer, size_t payloadLength)
+{
+	Header tipcHeader;
+	struct iovec parts[2] = {
+		{ &tipcHeader, sizeof(Header) },
+		{ payloadPointer, payloadLength },
+	};
+	struct msghdr message;
+	std::memset(&message, 0, sizeof(message));
+	message.msg_iov = parts;
+	message.msg_iovlen = 2;
+
+	// Scatter the packet into header and payload and remove it from TIPC
+	int result = recvmsg(this->socketDescriptor_, &message, MSG_DONTWAIT);
+	if (result >= static_cast<int>(sizeof(Header) + payloadLength)) {
+		return true;
+	}
+
+	if (result < 0 and errno != EWOULDBLOCK) {
+		xpcc::log::error
+				<< XPCC_FILE_INFO
+				<< "Error while receiving data. errno=" << errno
+				<< xpcc::flush;
+	}
+	return false;
+}
+// ----------------------------------------------------------------------------
 // This method removes the current packet from the TIPC message queue.
 // If the method was successful (if a message could be removed) the
 // method returns true - otherwise false.
@@ -32,6 +32,7 @@
 
 #include "header.hpp"
 
+#include <cstddef>
 #include <stdint.h>
 
 namespace xpcc {
@@ -52,6 +53,20 @@ namespace xpcc {
 				registerOnPacket(	unsigned int typeId,
 									unsigned int lowerInstance,
 									unsigned int upperInstance);
+				
+				/// Withdraw a name sequence bound by registerOnPacket()
+				void 
+				unregisterOnPacket(	unsigned int typeId,
+									unsigned int lowerInstance,
+									unsigned int upperInstance);
+				
+				/**
+				 * \brief	Block until a packet is available
+				 * 
+				 * \return	\c false if \p timeout milliseconds passed
+				 */
+				bool 
+				waitForPacket(int timeout);
 		
 				/**
 				 * \param transmitterPortId the id of the tipc port, that transmitted the message is returned
@@ -62,6 +77,19 @@ namespace xpcc {
 						uint32_t & transmitterPortId,
 						tipc::Header & tipcHeader );
 				
+				/**
+				 * \brief	Additionally peek at the first \p prefixLength
+				 * 			bytes of the payload
+				 * 
+				 * The prefix is only valid if the payload is long enough.
+				 */
+				bool 
+				receiveHeader(
+						uint32_t & transmitterPortId,
+						tipc::Header & tipcHeader,
+						void* prefix,
+						std::size_t prefixLength );
+				
 				bool 
 				receivePayload(
 						uint8_t* payloadPointer,
@@ -69,6 +97,17 @@ namespace xpcc {
 				
 				bool 
 				popPayload();
+				
+				/**
+				 * \brief	Receive the payload and remove the packet
+				 * 
+				 * Copies the payload directly into \p payloadPointer, which
+				 * replaces receivePayload() followed by popPayload().
+				 */
+				bool 
+				receivePacket(
+						uint8_t* payloadPointer,
+						size_t payloadLength);
 		
 			private:
 				const int socketDescriptor_;
@@ -10,13 +10,18 @@
 
 #include "connector.hpp"
 
+#include <xpcc/architecture/driver/clock.hpp>
+
 namespace xpcc
 {
 
-ZeroMQConnector::ZeroMQConnector(std::string endpointIn, std::string endpointOut, Mode mode) :
+ZeroMQConnector::ZeroMQConnector(std::string endpointIn, std::string endpointOut, Mode mode,
+		std::size_t receiveQueueSize) :
 	socketIn (context, (mode == Mode::SubPush ? zmqpp::socket_type::sub  : zmqpp::socket_type::pull)),
 	socketOut(context, (mode == Mode::SubPush ? zmqpp::socket_type::push : zmqpp::socket_type::pub)),
-	reader(socketIn)
+	reader(socketIn, receiveQueueSize),
+	framing(Framing::Legacy), fields(0), sequence(0),
+	coalesce(false), maximumParts(64), pendingParts(0)
 {
 	switch(mode)
 	{
@@ -44,6 +49,7 @@ ZeroMQConnector::ZeroMQConnector(std::string endpointIn, std::string endpointOut
 // ----------------------------------------------------------------------------
 ZeroMQConnector::~ZeroMQConnector()
 {
+	this->flush();
 	this->reader.stop();
 
 	if(this->socketIn.type() == zmqpp::socket_type::sub) {
@@ -58,19 +64,62 @@ ZeroMQConnector::~ZeroMQConnector()
 void
 ZeroMQConnector::sendPacket(const Header &header, SmartPointer payload)
 {
-	// Publish the reassembled message with zeromq
-	zmqpp::message message;
+	this->appendPacket(header, payload);
+
+	if (not this->coalesce) {
+		this->flush();
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+ZeroMQConnector::sendPackets(const Packet *packets, uint8_t count)
+{
+	for (uint8_t i = 0; i < count; ++i) {
+		this->appendPacket(packets[i].header, packets[i].payload);
+
+		if (not this->coalesce) {
+			this->flush();
+		}
+	}
+	this->flush();
+}
+
+// ----------------------------------------------------------------------------
+void
+ZeroMQConnector::setFraming(Framing framing, uint8_t fields)
+{
+	this->flush();
 
-	// Manual serialisation of XPCC Header and Payload into a byte buffer
-	// The mapping of type, ack, dest, src and id into a uint32_t from
-	// CanConnectorBase is used.
+	this->framing = framing;
+	this->fields = fields;
+}
 
-	constexpr uint16_t headerSize = 5;
+// ----------------------------------------------------------------------------
+void
+ZeroMQConnector::setCoalescing(bool enable, uint8_t maximumParts)
+{
+	this->flush();
+
+	this->coalesce = enable;
+	this->maximumParts = (maximumParts > 0) ? maximumParts : 1;
+}
 
-	// Maximum valid size of xpcc::SmartPointer
-	constexpr uint16_t maxPayloadSize = 65529;
+// ----------------------------------------------------------------------------
+void
+ZeroMQConnector::flush()
+{
+	if (this->pendingParts > 0) {
+		this->sendPending(ZMQ_DONTWAIT);
+		this->pendingParts = 0;
+	}
+}
 
-	if(payload.getSize() > maxPayloadSize) {
+// ----------------------------------------------------------------------------
+void
+ZeroMQConnector::appendPacket(const Header &header, const SmartPointer& payload)
+{
+	if(payload.getSize() > ZeroMQFraming::maxPayloadSize) {
 		XPCC_LOG_ERROR << XPCC_FILE_INFO;
 		XPCC_LOG_ERROR << "Trying to send message with invalid size: ";
 		XPCC_LOG_ERROR << payload.getSize() << xpcc::endl;
@@ -78,30 +127,51 @@ ZeroMQConnector::sendPacket(const Header &header, SmartPointer payload)
 		return;
 	}
 
-	const std::size_t buf_size = headerSize + payload.getSize();
-	uint8_t buf[buf_size];
-
-	buf[0] = static_cast<uint8_t>(header.type);
-	buf[1] = header.isAcknowledge;
-	buf[2] = header.destination;
-	buf[3] = header.source;
-	buf[4] = header.packetIdentifier;
-
-	memcpy(buf + headerSize, payload.getPointer(), payload.getSize());
-
-#	if ZMQPP_VERSION_MAJOR >= 4
-	/**
-	* Breaking change in 4.1.1:
-	* Removed message::add(pointer, size_t) as there were situations it conflicts with the new easier 
-	* to use templated add. This has been replaced with a message::add_raw(pointer, size_t) method.
-	* https://github.com/zeromq/zmqpp/blob/develop/CHANGES.md
-	*/
-	message.add_raw(buf, buf_size);
-#	else
-	message.add(buf, buf_size);
-#	endif
-
-	socketOut.send(message, /* dont_block = */ true);
+	if (this->pendingParts >= this->maximumParts) {
+		this->flush();
+	}
+	else if (this->pendingParts > 0) {
+		// more parts follow, the message is only complete once a part
+		// without ZMQ_SNDMORE has been sent
+		this->sendPending(ZMQ_SNDMORE | ZMQ_DONTWAIT);
+	}
+
+	// Serialise header and payload directly into the buffer owned by the
+	// message, no intermediate copy is necessary.
+	const std::size_t headerSize = ZeroMQFraming::getHeaderSize(this->framing, this->fields);
+	if (zmq_msg_init_size(&this->pending, headerSize + payload.getSize()) != 0)
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO;
+		XPCC_LOG_ERROR << "Could not allocate message" << xpcc::endl;
+
+		// an already started multipart message still needs a last part,
+		// the receiver discards empty parts
+		zmq_msg_init(&this->pending);
+		this->pendingParts++;
+		return;
+	}
+
+	uint8_t *data = static_cast<uint8_t *>(zmq_msg_data(&this->pending));
+	uint32_t timestamp = 0;
+	if (this->fields & ZeroMQFraming::TIMESTAMP) {
+		timestamp = xpcc::Clock::now().getTime();
+	}
+	ZeroMQFraming::encodeHeader(data, this->framing, header,
+			this->fields, this->sequence++, timestamp);
+	std::memcpy(data + headerSize, payload.getPointer(), payload.getSize());
+
+	this->pendingParts++;
+}
+
+// ----------------------------------------------------------------------------
+void
+ZeroMQConnector::sendPending(int flags)
+{
+	// Packets are sent non-blocking. If the socket can't take the message
+	// it is dropped, just as with the previous single-part messages.
+	if (zmq_msg_send(&this->pending, static_cast<void *>(this->socketOut), flags) < 0) {
+		zmq_msg_close(&this->pending);
+	}
 }
 
 // ----------------------------------------------------------------------------
@@ -132,10 +202,26 @@ ZeroMQConnector::dropPacket()
 	this->reader.dropPacket();
 }
 
+// ----------------------------------------------------------------------------
+uint8_t
+ZeroMQConnector::receivePackets(Packet *packets, uint8_t maximum)
+{
+	return this->reader.readPackets(packets, maximum);
+}
+
+// ----------------------------------------------------------------------------
+bool
+ZeroMQConnector::waitForPacket(uint16_t timeout)
+{
+	return this->reader.waitForPacket(timeout);
+}
+
 // ----------------------------------------------------------------------------
 void
 ZeroMQConnector::update()
 {
+	this->reader.clearNotification();
+	this->flush();
 }
 
 } // xpcc namespace
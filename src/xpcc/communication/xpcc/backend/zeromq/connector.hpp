@@ -20,6 +20,7 @@
 #define	XPCC_LOG_LEVEL xpcc::log::ERROR
 
 #include "../backend_interface.hpp"
+#include "framing.hpp"
 #include "reader.hpp"
 
 namespace xpcc
@@ -32,11 +33,23 @@ public:
 		SubPush, /// In this mode the backend connects to a remote machine.
 		PubPull, /// Server mode in which the backend binds to two ports. The ports must be accessible.
 	};
+
+	using Framing = ZeroMQFraming::Format;
 };
 
 /**
  * @brief	ZeroMQ communication backend for hosted
  *
+ * Packets are sent in the legacy format of ZeroMQFraming by default, so
+ * that existing peers can still decode them. Use setFraming() to switch to
+ * the compact format once all peers understand it.
+ * Received frames are accepted in both formats.
+ *
+ * Each packet is serialised directly into the buffer of the ZeroMQ
+ * message. With setCoalescing() enabled, the packets passed to
+ * sendPackets() or sent with sendPacket() between two calls of update()
+ * are transmitted as the parts of a single multipart message.
+ *
  * @ingroup	backend
  *
  * @author	strongly-typed
@@ -46,7 +59,8 @@ class ZeroMQConnector : public ZeroMQConnectorBase, public BackendInterface
 {
 public:
 	ZeroMQConnector(std::string endpointIn, std::string endpointOut,
-					Mode mode = Mode::SubPush);
+					Mode mode = Mode::SubPush,
+					std::size_t receiveQueueSize = 1024);
 
 	virtual
 	~ZeroMQConnector() override;
@@ -54,6 +68,9 @@ public:
 	virtual void
 	sendPacket(const Header &header, SmartPointer payload) override;
 
+	virtual void
+	sendPackets(const Packet *packets, uint8_t count) override;
+
 	virtual bool
 	isPacketAvailable() const override;
 
@@ -66,15 +83,82 @@ public:
 	virtual void
 	dropPacket() override;
 
+	virtual uint8_t
+	receivePackets(Packet *packets, uint8_t maximum) override;
+
+	virtual bool
+	waitForPacket(uint16_t timeout) override;
+
 	virtual void
 	update() override;
 
+	/**
+	 * Descriptor which becomes readable when packets were received.
+	 *
+	 * Allows to wait for this connector together with other sources,
+	 * e.g. in xpcc::Gateway. The descriptor is reset by update(), which
+	 * has to be followed by reading all available packets.
+	 */
+	inline int
+	getFileDescriptor()
+	{
+		return this->reader.getNotificationDescriptor();
+	}
+
+	/// Number of received packets dropped because the receive queue was full
+	inline uint32_t
+	getDroppedPackets() const
+	{
+		return this->reader.getOverflows();
+	}
+
+	/**
+	 * Select the format of transmitted frames.
+	 *
+	 * @param	fields	Combination of ZeroMQFraming::SEQUENCE and
+	 * 					ZeroMQFraming::TIMESTAMP, only used by the compact
+	 * 					format.
+	 */
+	void
+	setFraming(Framing framing, uint8_t fields = 0);
+
+	/**
+	 * Combine packets into multipart messages.
+	 *
+	 * @param	maximumParts	Number of packets after which a message is
+	 * 							transmitted even without a flush
+	 */
+	void
+	setCoalescing(bool enable, uint8_t maximumParts = 64);
+
+	/// Transmit the pending multipart message
+	void
+	flush();
+
+protected:
+	void
+	appendPacket(const Header &header, const SmartPointer& payload);
+
+	void
+	sendPending(int flags);
+
 protected:
 	zmqpp::context context;
 	zmqpp::socket socketIn;
 	zmqpp::socket socketOut;
 
 	ZeroMQReader reader;
+
+	Framing framing;
+	uint8_t fields;
+	uint16_t sequence;
+
+	bool coalesce;
+	uint8_t maximumParts;
+
+	/// Last serialised packet, not yet handed to the socket
+	zmq_msg_t pending;
+	uint8_t pendingParts;
 };
 
 } // xpcc namespace
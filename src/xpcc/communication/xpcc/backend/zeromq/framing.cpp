@@ -0,0 +1,148 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "framing.hpp"
+
+namespace xpcc
+{
+
+constexpr std::size_t ZeroMQFraming::legacyHeaderSize;
+constexpr std::size_t ZeroMQFraming::compactHeaderSize;
+constexpr std::size_t ZeroMQFraming::maxPayloadSize;
+
+// ----------------------------------------------------------------------------
+std::size_t
+ZeroMQFraming::getHeaderSize(Format format, uint8_t fields)
+{
+	if (format == Format::Legacy) {
+		return legacyHeaderSize;
+	}
+
+	std::size_t size = compactHeaderSize;
+	if (fields & SEQUENCE) {
+		size += 2;
+	}
+	if (fields & TIMESTAMP) {
+		size += 4;
+	}
+	return size;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t
+ZeroMQFraming::encodeHeader(uint8_t *buffer, Format format, const Header& header,
+		uint8_t fields, uint16_t sequence, uint32_t timestamp)
+{
+	if (format == Format::Legacy)
+	{
+		buffer[0] = static_cast<uint8_t>(header.type);
+		buffer[1] = header.isAcknowledge;
+		buffer[2] = header.destination;
+		buffer[3] = header.source;
+		buffer[4] = header.packetIdentifier;
+		return legacyHeaderSize;
+	}
+
+	fields &= (SEQUENCE | TIMESTAMP);
+
+	uint8_t *ptr = buffer;
+	*ptr++ = compactMarker | fields |
+			(header.isAcknowledge ? acknowledgeFlag : 0) |
+			(static_cast<uint8_t>(header.type) & typeMask);
+	*ptr++ = header.destination;
+	*ptr++ = header.source;
+	*ptr++ = header.packetIdentifier;
+
+	if (fields & SEQUENCE)
+	{
+		*ptr++ = sequence;
+		*ptr++ = sequence >> 8;
+	}
+	if (fields & TIMESTAMP)
+	{
+		*ptr++ = timestamp;
+		*ptr++ = timestamp >> 8;
+		*ptr++ = timestamp >> 16;
+		*ptr++ = timestamp >> 24;
+	}
+	return ptr - buffer;
+}
+
+// ----------------------------------------------------------------------------
+bool
+ZeroMQFraming::decode(const uint8_t *data, std::size_t size, Frame& frame)
+{
+	if (size < 1) {
+		return false;
+	}
+
+	std::size_t headerSize;
+	if (data[0] & compactMarker)
+	{
+		frame.fields = data[0] & (SEQUENCE | TIMESTAMP);
+		if ((data[0] & ~(compactMarker | SEQUENCE | TIMESTAMP | acknowledgeFlag | typeMask)) or
+			(data[0] & typeMask) > static_cast<uint8_t>(Header::Type::NEGATIVE_RESPONSE))
+		{
+			return false;
+		}
+
+		headerSize = getHeaderSize(Format::Compact, frame.fields);
+		if (size < headerSize) {
+			return false;
+		}
+
+		frame.header = Header(
+				/* type = */ Header::Type(data[0] & typeMask),
+				/* ack  = */ data[0] & acknowledgeFlag,
+				/* dest = */ data[1],
+				/* src  = */ data[2],
+				/* id   = */ data[3]);
+
+		const uint8_t *ptr = data + compactHeaderSize;
+		frame.sequence = 0;
+		if (frame.fields & SEQUENCE)
+		{
+			frame.sequence = ptr[0] | (ptr[1] << 8);
+			ptr += 2;
+		}
+		frame.timestamp = 0;
+		if (frame.fields & TIMESTAMP)
+		{
+			frame.timestamp = uint32_t(ptr[0]) | (uint32_t(ptr[1]) << 8) |
+					(uint32_t(ptr[2]) << 16) | (uint32_t(ptr[3]) << 24);
+		}
+	}
+	else
+	{
+		headerSize = legacyHeaderSize;
+		if (size < headerSize) {
+			return false;
+		}
+
+		frame.header = Header(
+				/* type = */ Header::Type(data[0]),
+				/* ack  = */ data[1],
+				/* dest = */ data[2],
+				/* src  = */ data[3],
+				/* id   = */ data[4]);
+		frame.fields = 0;
+		frame.sequence = 0;
+		frame.timestamp = 0;
+	}
+
+	if (size - headerSize > maxPayloadSize) {
+		return false;
+	}
+
+	frame.payload = data + headerSize;
+	frame.payloadSize = size - headerSize;
+	return true;
+}
+
+} // xpcc namespace
@@ -0,0 +1,112 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__ZEROMQ_FRAMING_HPP
+#define	XPCC__ZEROMQ_FRAMING_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+#include "../header.hpp"
+
+namespace xpcc
+{
+
+/**
+ * @brief	Wire format of xpcc packets inside ZeroMQ message frames
+ *
+ * Every frame carries exactly one xpcc packet. Two formats are understood:
+ *
+ * Legacy (5 byte header):
+ * @code
+ * | type | ack | destination | source | identifier | payload ... |
+ * @endcode
+ *
+ * Compact (4 byte header plus optional fields):
+ * @code
+ * | flags | destination | source | identifier | [sequence] | [timestamp] | payload ... |
+ * @endcode
+ *
+ * The flags byte holds the type in bits 0..1, the acknowledge flag in
+ * bit 2, the presence of a 16-bit sequence number in bit 3 and the
+ * presence of a 32-bit timestamp in bit 4. Bit 7 is always set, which
+ * distinguishes compact frames from legacy frames (where the first byte
+ * is the type and therefore smaller than 3). Multi-byte fields are stored
+ * little-endian.
+ *
+ * @ingroup	backend
+ */
+class ZeroMQFraming
+{
+public:
+	enum class Format
+	{
+		Legacy,
+		Compact,
+	};
+
+	/// Optional fields of a compact frame
+	enum Field : uint8_t
+	{
+		SEQUENCE = 0x08,
+		TIMESTAMP = 0x10,
+	};
+
+	/// Decoded frame, payload points into the decoded buffer
+	struct Frame
+	{
+		Header header;
+		uint8_t fields;
+		uint16_t sequence;
+		uint32_t timestamp;
+
+		const uint8_t *payload;
+		std::size_t payloadSize;
+	};
+
+	static constexpr std::size_t legacyHeaderSize = 5;
+	static constexpr std::size_t compactHeaderSize = 4;
+
+	/// Maximum payload size of xpcc::SmartPointer
+	static constexpr std::size_t maxPayloadSize = 65529;
+
+	/// Number of bytes in front of the payload
+	static std::size_t
+	getHeaderSize(Format format, uint8_t fields);
+
+	/**
+	 * Write the frame header to \p buffer.
+	 *
+	 * The buffer must provide getHeaderSize() bytes, \p fields is
+	 * ignored for the legacy format.
+	 *
+	 * @return	Number of bytes written
+	 */
+	static std::size_t
+	encodeHeader(uint8_t *buffer, Format format, const Header& header,
+			uint8_t fields = 0, uint16_t sequence = 0, uint32_t timestamp = 0);
+
+	/**
+	 * Decode a frame in either format.
+	 *
+	 * @return	`false` if the frame is too short, too long or uses
+	 * 			unknown flags
+	 */
+	static bool
+	decode(const uint8_t *data, std::size_t size, Frame& frame);
+
+private:
+	static constexpr uint8_t compactMarker = 0x80;
+	static constexpr uint8_t typeMask = 0x03;
+	static constexpr uint8_t acknowledgeFlag = 0x04;
+};
+
+} // xpcc namespace
+
+#endif // XPCC__ZEROMQ_FRAMING_HPP
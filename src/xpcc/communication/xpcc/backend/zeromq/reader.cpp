@@ -17,7 +17,7 @@ namespace xpcc
 
 // ----------------------------------------------------------------------------
 ZeroMQReader::ZeroMQReader(zmqpp::socket& socketIn_, std::size_t maxQueueSize_) :
-	socketIn(socketIn_), maxQueueSize(maxQueueSize_), stopThread(false)
+	socketIn(socketIn_), queue(maxQueueSize_), stopThread(false)
 {
 }
 
@@ -53,27 +53,44 @@ ZeroMQReader::stop()
 bool
 ZeroMQReader::isPacketAvailable() const
 {
-	std::lock_guard<std::mutex> lock(this->queueMutex);
-	return not this->queue.empty();
+	return not this->queue.isEmpty();
 }
 
 // ----------------------------------------------------------------------------
 const ZeroMQReader::Packet&
 ZeroMQReader::getPacket() const
 {
-	std::lock_guard<std::mutex> lock(this->queueMutex);
-	return this->queue.front();
+	return this->queue.getFront();
 }
 
 // ----------------------------------------------------------------------------
 void
 ZeroMQReader::dropPacket()
 {
-	std::lock_guard<std::mutex> lock(this->queueMutex);
+	if(not this->queue.isEmpty()) {
+		this->queue.pop();
+	}
+}
+
+// ----------------------------------------------------------------------------
+bool
+ZeroMQReader::waitForPacket(uint16_t timeout) const
+{
+	return this->queue.waitForElement(timeout);
+}
 
-	if(not this->queue.empty()) {
-		this->queue.pop_front();
+// ----------------------------------------------------------------------------
+uint8_t
+ZeroMQReader::readPackets(BackendInterface::Packet *packets, uint8_t maximum)
+{
+	uint8_t count = 0;
+	while(count < maximum and not this->queue.isEmpty()) {
+		packets[count].header = this->queue.getFront().header;
+		packets[count].payload = this->queue.getFront().payload;
+		this->queue.pop();
+		count++;
 	}
+	return count;
 }
 
 // ----------------------------------------------------------------------------
@@ -104,43 +121,31 @@ ZeroMQReader::receiveThread()
 void
 ZeroMQReader::readPacket(const zmqpp::message& message)
 {
-	constexpr uint16_t headerSize = 5;
-
-	// Maximum payload size of xpcc::SmartPointer
-	constexpr uint16_t maxPayloadSize = 65529;
-
-	const auto size = message.size(0);
-
-	if(size >= headerSize && size <= (headerSize + maxPayloadSize)) {
-		const uint8_t* const data = static_cast<const uint8_t*>(message.raw_data());
-		const auto payloadSize = size - headerSize;
-
-		xpcc::Header header = xpcc::Header(
-			/* type = */ xpcc::Header::Type(data[0]),
-			/* ack  = */ data[1],
-			/* dest = */ data[2],
-			/* src  = */ data[3],
-			/* id   = */ data[4]);
-
-		{
-			std::lock_guard<std::mutex> lock(this->queueMutex);
-
-			if (this->queue.size() >= this->maxQueueSize) {
-				this->queue.pop_front();
-
-				XPCC_LOG_ERROR << XPCC_FILE_INFO;
-				XPCC_LOG_ERROR << "Receive queue is full, dropping packets" << xpcc::endl;
-			}
-
-			this->queue.emplace_back(payloadSize, header);
+	// Several packets might have been coalesced into one multipart message
+	for(std::size_t part = 0; part < message.parts(); ++part)
+	{
+		const auto size = message.size(part);
+		const uint8_t* const data = static_cast<const uint8_t*>(message.raw_data(part));
+
+		ZeroMQFraming::Frame frame;
+		if(not ZeroMQFraming::decode(data, size, frame)) {
+			XPCC_LOG_ERROR << XPCC_FILE_INFO;
+			XPCC_LOG_ERROR << "Invalid frame of length " << size << xpcc::endl;
+			continue;
+		}
 
-			// Copy received payload to packet
-			uint8_t* const payloadBuffer = this->queue.back().payload.getPointer();
-			std::copy_n(data + headerSize, payloadSize, payloadBuffer);
+		// The packet is filled in its slot, a local copy would share the
+		// payload with the dispatcher thread after it was published.
+		Packet *packet = this->queue.reserve(frame.payloadSize, frame.header);
+		if(packet == nullptr) {
+			XPCC_LOG_ERROR << XPCC_FILE_INFO;
+			XPCC_LOG_ERROR << "Receive queue is full, dropping packets" << xpcc::endl;
+			continue;
 		}
-	} else {
-		XPCC_LOG_ERROR << XPCC_FILE_INFO;
-		XPCC_LOG_ERROR << "Invalid message length: " << size << xpcc::endl;
+
+		// Copy received payload to packet
+		std::copy_n(frame.payload, frame.payloadSize, packet->payload.getPointer());
+		this->queue.commit();
 	}
 }
 
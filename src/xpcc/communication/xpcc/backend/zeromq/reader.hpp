@@ -12,13 +12,14 @@
 #define	XPCC__ZEROMQ_READER_HPP
 
 #include <thread>
-#include <mutex>
 #include <atomic>
-#include <deque>
 
 #include <zmqpp/zmqpp.hpp>
 
-#include "../header.hpp"
+#include <xpcc/container/spsc_queue.hpp>
+
+#include "../backend_interface.hpp"
+#include "framing.hpp"
 
 #include <xpcc/debug/logger.hpp>
 #undef XPCC_LOG_LEVEL
@@ -30,6 +31,10 @@ namespace xpcc
 /**
  * @brief	Reads packets from a zmqpp socket in a background thread
  *
+ * Received packets are handed to the thread calling the Dispatcher through
+ * a lock-free single-producer/single-consumer queue. If the queue is full
+ * new packets are dropped and counted, see getOverflows().
+ *
  * @ingroup	backend
  *
  * @author	Christopher Durand <christopher.durand@rwth-aachen.de>
@@ -49,7 +54,12 @@ public:
 		xpcc::SmartPointer payload;
 	};
 
-	ZeroMQReader(zmqpp::socket& socketIn_, std::size_t maxQueueSize_ = 1000);
+	/**
+	 * @param	socketIn_		Socket to read from
+	 * @param	maxQueueSize_	Capacity of the receive queue, rounded up
+	 * 							to the next power of two
+	 */
+	ZeroMQReader(zmqpp::socket& socketIn_, std::size_t maxQueueSize_ = 1024);
 
 	~ZeroMQReader();
 
@@ -71,6 +81,34 @@ public:
 	void
 	dropPacket();
 
+	/// Block until a packet is available or \p timeout milliseconds have passed
+	bool
+	waitForPacket(uint16_t timeout) const;
+
+	/// Move up to \p maximum packets out of the queue
+	uint8_t
+	readPackets(BackendInterface::Packet *packets, uint8_t maximum);
+
+	/// Readable when a packet arrived, see SpscQueue::getNotificationDescriptor()
+	inline int
+	getNotificationDescriptor()
+	{
+		return this->queue.getNotificationDescriptor();
+	}
+
+	inline void
+	clearNotification()
+	{
+		this->queue.clearNotification();
+	}
+
+	/// Number of packets dropped because the receive queue was full
+	inline uint32_t
+	getOverflows() const
+	{
+		return this->queue.getOverflows();
+	}
+
 private:
 	void
 	receiveThread();
@@ -81,9 +119,7 @@ private:
 private:
 	zmqpp::socket& socketIn;
 
-	std::deque<Packet> queue;
-	mutable std::mutex queueMutex;
-	const std::size_t maxQueueSize;
+	SpscQueue<Packet> queue;
 
 	std::thread thread;
 	std::atomic<bool> stopThread;
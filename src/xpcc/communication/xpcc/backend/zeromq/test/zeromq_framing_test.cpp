@@ -0,0 +1,117 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/communication/xpcc/backend/zeromq/framing.hpp>
+
+#include "zeromq_framing_test.hpp"
+
+using xpcc::ZeroMQFraming;
+
+void
+ZeromqFramingTest::testLegacy()
+{
+	xpcc::Header header(xpcc::Header::Type::RESPONSE, true, 0x12, 0x34, 0x56);
+	
+	uint8_t buffer[8] = { 0, 0, 0, 0, 0, 0xaa, 0xbb, 0xcc };
+	TEST_ASSERT_EQUALS(ZeroMQFraming::getHeaderSize(ZeroMQFraming::Format::Legacy,
+			ZeroMQFraming::SEQUENCE), 5U);
+	TEST_ASSERT_EQUALS(ZeroMQFraming::encodeHeader(buffer,
+			ZeroMQFraming::Format::Legacy, header, ZeroMQFraming::SEQUENCE), 5U);
+	
+	const uint8_t expected[5] = { 0x01, 0x01, 0x12, 0x34, 0x56 };
+	TEST_ASSERT_EQUALS_ARRAY(buffer, expected, 5);
+	
+	ZeroMQFraming::Frame frame;
+	TEST_ASSERT_TRUE(ZeroMQFraming::decode(buffer, sizeof(buffer), frame));
+	TEST_ASSERT_EQUALS(frame.header, header);
+	TEST_ASSERT_EQUALS(frame.fields, 0);
+	TEST_ASSERT_EQUALS(frame.payloadSize, 3U);
+	TEST_ASSERT_TRUE(frame.payload == buffer + 5);
+}
+
+void
+ZeromqFramingTest::testCompact()
+{
+	xpcc::Header header(xpcc::Header::Type::NEGATIVE_RESPONSE, true, 0x12, 0x34, 0x56);
+	
+	uint8_t buffer[6] = { 0, 0, 0, 0, 0xaa, 0xbb };
+	TEST_ASSERT_EQUALS(ZeroMQFraming::getHeaderSize(ZeroMQFraming::Format::Compact, 0), 4U);
+	TEST_ASSERT_EQUALS(ZeroMQFraming::encodeHeader(buffer,
+			ZeroMQFraming::Format::Compact, header), 4U);
+	
+	const uint8_t expected[4] = { 0x86, 0x12, 0x34, 0x56 };
+	TEST_ASSERT_EQUALS_ARRAY(buffer, expected, 4);
+	
+	ZeroMQFraming::Frame frame;
+	TEST_ASSERT_TRUE(ZeroMQFraming::decode(buffer, sizeof(buffer), frame));
+	TEST_ASSERT_EQUALS(frame.header, header);
+	TEST_ASSERT_EQUALS(frame.payloadSize, 2U);
+	TEST_ASSERT_TRUE(frame.payload == buffer + 4);
+	
+	// empty payload
+	header = xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x00, 0x01, 0x02);
+	ZeroMQFraming::encodeHeader(buffer, ZeroMQFraming::Format::Compact, header);
+	TEST_ASSERT_EQUALS(buffer[0], 0x80);
+	TEST_ASSERT_TRUE(ZeroMQFraming::decode(buffer, 4, frame));
+	TEST_ASSERT_EQUALS(frame.header, header);
+	TEST_ASSERT_EQUALS(frame.payloadSize, 0U);
+}
+
+void
+ZeromqFramingTest::testOptionalFields()
+{
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x56);
+	const uint8_t fields = ZeroMQFraming::SEQUENCE | ZeroMQFraming::TIMESTAMP;
+	
+	uint8_t buffer[11];
+	TEST_ASSERT_EQUALS(ZeroMQFraming::getHeaderSize(ZeroMQFraming::Format::Compact, fields), 10U);
+	TEST_ASSERT_EQUALS(ZeroMQFraming::encodeHeader(buffer, ZeroMQFraming::Format::Compact,
+			header, fields, 0xabcd, 0x01020304), 10U);
+	buffer[10] = 0x42;
+	
+	const uint8_t expected[10] = { 0x98, 0x12, 0x34, 0x56, 0xcd, 0xab, 0x04, 0x03, 0x02, 0x01 };
+	TEST_ASSERT_EQUALS_ARRAY(buffer, expected, 10);
+	
+	ZeroMQFraming::Frame frame;
+	TEST_ASSERT_TRUE(ZeroMQFraming::decode(buffer, sizeof(buffer), frame));
+	TEST_ASSERT_EQUALS(frame.header, header);
+	TEST_ASSERT_EQUALS(frame.fields, fields);
+	TEST_ASSERT_EQUALS(frame.sequence, 0xabcd);
+	TEST_ASSERT_EQUALS(frame.timestamp, 0x01020304U);
+	TEST_ASSERT_EQUALS(frame.payloadSize, 1U);
+	TEST_ASSERT_EQUALS(frame.payload[0], 0x42);
+	
+	// timestamp only
+	TEST_ASSERT_EQUALS(ZeroMQFraming::encodeHeader(buffer, ZeroMQFraming::Format::Compact,
+			header, ZeroMQFraming::TIMESTAMP, 0xabcd, 0x01020304), 8U);
+	TEST_ASSERT_TRUE(ZeroMQFraming::decode(buffer, 8, frame));
+	TEST_ASSERT_EQUALS(frame.sequence, 0);
+	TEST_ASSERT_EQUALS(frame.timestamp, 0x01020304U);
+	TEST_ASSERT_EQUALS(frame.payloadSize, 0U);
+}
+
+void
+ZeromqFramingTest::testInvalidFrames()
+{
+	ZeroMQFraming::Frame frame;
+	
+	const uint8_t legacy[4] = { 0x00, 0x00, 0x01, 0x02 };
+	TEST_ASSERT_FALSE(ZeroMQFraming::decode(legacy, 0, frame));
+	TEST_ASSERT_FALSE(ZeroMQFraming::decode(legacy, sizeof(legacy), frame));
+	
+	// header announces a sequence number which is missing
+	const uint8_t truncated[5] = { 0x88, 0x00, 0x01, 0x02, 0x03 };
+	TEST_ASSERT_FALSE(ZeroMQFraming::decode(truncated, sizeof(truncated), frame));
+	
+	// unknown flag and invalid type
+	const uint8_t reserved[4] = { 0xa0, 0x00, 0x01, 0x02 };
+	TEST_ASSERT_FALSE(ZeroMQFraming::decode(reserved, sizeof(reserved), frame));
+	const uint8_t type[4] = { 0x83, 0x00, 0x01, 0x02 };
+	TEST_ASSERT_FALSE(ZeroMQFraming::decode(type, sizeof(type), frame));
+}
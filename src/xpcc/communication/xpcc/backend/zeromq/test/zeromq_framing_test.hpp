@@ -0,0 +1,31 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef ZEROMQ_FRAMING_TEST_HPP
+#define ZEROMQ_FRAMING_TEST_HPP
+
+#include <unittest/testsuite.hpp>
+
+class ZeromqFramingTest : public unittest::TestSuite
+{
+public:
+	void
+	testLegacy();
+	
+	void
+	testCompact();
+	
+	void
+	testOptionalFields();
+	
+	void
+	testInvalidFrames();
+};
+
+#endif // ZEROMQ_FRAMING_TEST_HPP
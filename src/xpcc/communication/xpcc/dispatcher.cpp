@@ -30,14 +30,54 @@
 
 #include "dispatcher.hpp"
 
+#include <new>
+
 #include <xpcc/debug/logger/logger.hpp>
 // set the Loglevel
 #undef  XPCC_LOG_LEVEL
 #define XPCC_LOG_LEVEL xpcc::log::INFO
 
 xpcc::Dispatcher::Dispatcher(BackendInterface *backend_, Postman* postman_) :
-	backend(backend_), postman(postman_)
+	backend(backend_), postman(postman_),
+	numberOfPending(0), maximumPending(maximumPendingMessages),
+	currentResponseTimeout(responseTimeout),
+	mirroring(Mirroring::All), mirrorInterval(1), mirrorCounter(0),
+	tapBackend(nullptr),
+	freeEntries(nullptr), transmitCount(0)
 {
+#if XPCC_COMMUNICATION_STATISTICS
+	this->resetStatistics();
+	this->statisticsSource = 0;
+	this->statisticsEvent = 0;
+	this->statisticsInterval = 0;
+#endif
+}
+
+xpcc::Dispatcher::~Dispatcher()
+{
+	// every entry is part of exactly one of the queues
+	while (!this->responseTransmissionQueue.isEmpty()) {
+		this->removeEntry(this->responseTransmissionQueue.getFront());
+	}
+	while (!this->requestTransmissionQueue.isEmpty()) {
+		this->removeEntry(this->requestTransmissionQueue.getFront());
+	}
+	while (!this->eventTransmissionQueue.isEmpty()) {
+		this->removeEntry(this->eventTransmissionQueue.getFront());
+	}
+	while (!this->acknowledgeQueue.isEmpty()) {
+		this->removeEntry(this->acknowledgeQueue.getFront());
+	}
+	while (!this->responseQueue.isEmpty()) {
+		this->removeEntry(this->responseQueue.getFront());
+	}
+
+	while (this->freeEntries != nullptr)
+	{
+		FreeEntry *next = this->freeEntries->next;
+		::operator delete(this->freeEntries);
+		this->freeEntries = next;
+	}
 }
 
 // ----------------------------------------------------------------------------
@@ -45,33 +85,116 @@ void
 xpcc::Dispatcher::update()
 {
 	this->backend->update();
+	if (this->tapBackend != nullptr) {
+		this->tapBackend->update();
+	}
 	
-	//Check if a new packet was received by the backend
-	while (this->backend->isPacketAvailable())
-	{
-		const Header& header = this->backend->getPacketHeader();
-		const SmartPointer& payload = this->backend->getPacketPayload();
-		
-		if (header.type == Header::Type::REQUEST && !header.isAcknowledge)
-		{
-			this->handleActionCall(header, payload);
-		}
-		else
+	//Check if new packets were received by the backend
+	uint8_t count;
+	do {
+		count = this->backend->receivePackets(this->receiveBuffer, packetBatchSize);
+#if XPCC_COMMUNICATION_STATISTICS
+		this->statistics.receivedPackets += count;
+#endif
+		for (uint8_t i = 0; i < count; ++i)
 		{
-			this->handlePacket(header, payload);
-			if (!header.isAcknowledge && header.destination != 0)
+			const Header& header = this->receiveBuffer[i].header;
+			const SmartPointer& payload = this->receiveBuffer[i].payload;
+			
+			if (header.type == Header::Type::REQUEST && !header.isAcknowledge)
 			{
-				if (postman->isComponentAvailable(header.destination)) {
-					this->sendAcknowledge(header);
+				this->handleActionCall(header, payload);
+			}
+			else
+			{
+				this->handlePacket(header, payload);
+				if (!header.isAcknowledge && header.destination != 0)
+				{
+					if (postman->isComponentAvailable(header.destination)) {
+						this->sendAcknowledge(header);
+					}
 				}
 			}
 		}
-		
-		this->backend->dropPacket();
 	}
+	while (count == packetBatchSize);
+
+#if XPCC_COMMUNICATION_STATISTICS
+	if (this->statisticsInterval > 0 && this->statisticsTimer.isExpired())
+	{
+		this->statisticsTimer.restart(this->statisticsInterval);
+		this->publishStatistics(this->statisticsSource, this->statisticsEvent);
+	}
+#endif
 
 	// check if there are packets to send
 	this->handleWaitingMessages();
+
+	this->flushPackets();
+}
+
+void
+xpcc::Dispatcher::setMirroring(Mirroring mode, uint16_t interval)
+{
+	this->mirroring = mode;
+	this->mirrorInterval = (interval > 0) ? interval : 1;
+	this->mirrorCounter = 0;
+}
+
+void
+xpcc::Dispatcher::setTapBackend(BackendInterface *tap)
+{
+	this->tapBackend = tap;
+	this->mirroring = (tap != nullptr) ? Mirroring::Tap : Mirroring::None;
+}
+
+bool
+xpcc::Dispatcher::waitForActivity(uint16_t timeout)
+{
+	if (!this->responseTransmissionQueue.isEmpty() ||
+		!this->requestTransmissionQueue.isEmpty() ||
+		!this->eventTransmissionQueue.isEmpty()) {
+		return true;
+	}
+
+	// wake up in time for the next retransmission or timeout
+	const EntryQueue *timeoutQueues[] = { &this->acknowledgeQueue, &this->responseQueue };
+	for (const EntryQueue *queue : timeoutQueues)
+	{
+		if (!queue->isEmpty())
+		{
+			int32_t remaining = queue->getFront()->time.remaining();
+			if (remaining <= 0) {
+				return true;
+			}
+			if (remaining < timeout) {
+				timeout = remaining;
+			}
+		}
+	}
+
+#if XPCC_COMMUNICATION_STATISTICS
+	// and in time for the next statistics report
+	if (this->statisticsInterval > 0)
+	{
+		int32_t remaining = this->statisticsTimer.remaining();
+		if (remaining <= 0) {
+			return true;
+		}
+		if (remaining < timeout) {
+			timeout = remaining;
+		}
+	}
+#endif
+
+	return this->backend->waitForPacket(timeout);
+}
+
+void
+xpcc::Dispatcher::run(uint16_t timeout)
+{
+	this->waitForActivity(timeout);
+	this->update();
 }
 
 void
@@ -80,6 +203,10 @@ xpcc::Dispatcher::handleActionCall(const Header& header,
 {
 	xpcc::Postman::DeliverInfo result = postman->deliverPacket(header, payload);
 	
+	if (result == Postman::OK) {
+		this->countMessage(header.destination, &ComponentStatistics::received);
+	}
+
 	if (result == Postman::OK && header.destination != 0)
 	{
 		// transmit ACK:
@@ -100,7 +227,62 @@ xpcc::Dispatcher::sendAcknowledge(const Header& header)
 			header.source, header.destination,
 			header.packetIdentifier);
 	
-	this->backend->sendPacket(ackHeader);
+	this->sendPacket(ackHeader, SmartPointer());
+}
+
+void
+xpcc::Dispatcher::sendPacket(const Header& header, const SmartPointer& payload)
+{
+	BackendInterface::Packet& packet = this->transmitBuffer[this->transmitCount];
+	packet.header = header;
+	packet.payload = payload;
+#if XPCC_COMMUNICATION_STATISTICS
+	this->statistics.sentPackets++;
+#endif
+
+	this->transmitCount++;
+	if (this->transmitCount == packetBatchSize) {
+		this->flushPackets();
+	}
+}
+
+void
+xpcc::Dispatcher::flushPackets()
+{
+	if (this->transmitCount > 0)
+	{
+		this->backend->sendPackets(this->transmitBuffer, this->transmitCount);
+		this->transmitCount = 0;
+	}
+}
+
+void
+xpcc::Dispatcher::mirrorPacket(const Header& header, const SmartPointer& payload)
+{
+	switch (this->mirroring)
+	{
+		case Mirroring::All:
+			this->sendPacket(header, payload);
+			break;
+
+		case Mirroring::None:
+			break;
+
+		case Mirroring::Sampled:
+			this->mirrorCounter++;
+			if (this->mirrorCounter >= this->mirrorInterval)
+			{
+				this->mirrorCounter = 0;
+				this->sendPacket(header, payload);
+			}
+			break;
+
+		case Mirroring::Tap:
+			if (this->tapBackend != nullptr) {
+				this->tapBackend->sendPacket(header, payload);
+			}
+			break;
+	}
 }
 
 bool
@@ -115,74 +297,84 @@ void
 xpcc::Dispatcher::handlePacket(const Header& header,
 		const SmartPointer& payload)
 {
-	auto entry = this->entries.begin();
-	while(entry != this->entries.end())
+	Entry *entry = this->pendingTable.find(header);
+	if (entry == nullptr) {
+		return;
+	}
+	this->recordLatency(entry, header);
+
+	if (entry->type == Entry::Type::Default)
+	{
+		// waiting for ack, no response can be handled
+		this->removeEntry(entry);
+	}
+	else if (entry->type == Entry::Type::Callback)
 	{
-		if (entry->type == Entry::Type::Default)
+		// entry actual has to be marked acknowledged if acknowleded
+		// request
+		if (header.type == Header::Type::REQUEST)
 		{
-			// waiting for ack, no response can be handled
-			if (entry->headerFits(header))
+			// Must be an acknowledge otherwise there is an error in
+			// communication, cause no requests can be handled here
+			if (header.isAcknowledge && entry->state == Entry::State::WaitForACK)
 			{
-				entry = this->entries.remove(entry);
-				return;
+				// make sure no requests passed here
+				this->acknowledgeQueue.remove(*entry);
+				entry->state = Entry::State::WaitForResponse;
+				this->waitForResponse(entry);
 			}
 		}
-		else if (entry->type == Entry::Type::Callback)
+		else
 		{
-			if (entry->headerFits(header))
-			{
-				// entry actual has to be marked acknowledged if acknowleded
-				// request
-				if (header.type == Header::Type::REQUEST)
-				{
-					// Must be an acknowledge otherwise there is an error in
-					// communication, cause no requests can be handled here
-					if (header.isAcknowledge)
-					{
-						// make sure no requests passed here
-						entry->state = Entry::State::WaitForResponse;
-					}
-				}
-				else
-				{
-					// response or negative response
-					if (!header.isAcknowledge) {
-						entry->callbackResponse(header, payload);
-					} else {
-						// cannot happen, since responses with callbacks are
-						// not possible
-					}
-					entry = this->entries.remove(entry);
-				}
-				return;
+			// response or negative response
+			if (!header.isAcknowledge) {
+				this->countMessage(header.destination, &ComponentStatistics::received);
+				entry->callbackResponse(header, payload);
+			} else {
+				// cannot happen, since responses with callbacks are
+				// not possible
 			}
+			this->removeEntry(entry);
 		}
-		++entry;
 	}
 }
 
-xpcc::Dispatcher::EntryIterator
-xpcc::Dispatcher::sendMessageToInnerComponent(EntryIterator entry)
+xpcc::Dispatcher::Entry *
+xpcc::Dispatcher::sendMessageToInnerComponent(Entry *entry)
 {
 	// to one component on board inner component
 	// send message also out, so it is possible to log
 	// communication externally
-	backend->sendPacket(entry->header, entry->payload);
+	this->mirrorPacket(entry->header, entry->payload);
+#if XPCC_COMMUNICATION_STATISTICS
+	this->statistics.localMessages++;
+#endif
 	
 	if (entry->header.type == Header::Type::REQUEST)
 	{
-		postman->deliverPacket(entry->header, entry->payload);
+		if (postman->deliverPacket(entry->header, entry->payload) == Postman::OK) {
+			this->countMessage(entry->header.destination, &ComponentStatistics::received);
+		}
 		// TODO handle postman errors?
 		
 		if (entry->type == Entry::Type::Callback)
 		{
-			// TODO timer for RESPONSES not handeled yet
+			this->reservePendingEntry();
+			this->markTransmitted(entry);
+
+			Entry *next = EntryQueue::getNext(entry);
+			this->requestTransmissionQueue.remove(*entry);
+
 			entry->state = Entry::State::WaitForResponse;
-			entry->time.restart(responseTimeout);
-			return entry;
+			this->waitForResponse(entry);
+			this->addPendingEntry(entry);
+			return next;
 		}
-		else {
-			return this->entries.remove(entry);
+		else
+		{
+			Entry *next = EntryQueue::getNext(entry);
+			this->removeEntry(entry);
+			return next;
 		}
 	}
 	else
@@ -191,129 +383,440 @@ xpcc::Dispatcher::sendMessageToInnerComponent(EntryIterator entry)
 		//
 		// we need to find the coresponding REQUEST and delete it as well
 		// as the RESPONSE
-		//
-		// responses are inserted at front, requests at end,
-		// thus we only need to search after the RESPONSE
-
-		auto req = entry;
-		for (++req; req != this->entries.end(); ++req)
+		Entry *req = this->pendingTable.find(entry->header);
+		if (req != nullptr and
+			req->header.type == Header::Type::REQUEST)
 		{
-			if (req->header.type == Header::Type::REQUEST and
-			    // must be State::WaitForResponse
-			    req->state != Entry::State::TransmissionPending and
-			    req->headerFits(entry->header))
+			this->recordLatency(req, entry->header);
+			if (req->type == Entry::Type::Callback)
 			{
-				if (req->type == Entry::Type::Callback)
-				{
-					req->callbackResponse(entry->header, entry->payload);
-				}
-				this->entries.remove(req);
-				break;
+				this->countMessage(entry->header.destination, &ComponentStatistics::received);
+				req->callbackResponse(entry->header, entry->payload);
 			}
+			this->removeEntry(req);
 		}
 		
-		return this->entries.remove(entry);
+		Entry *next = EntryQueue::getNext(entry);
+		this->removeEntry(entry);
+		return next;
+	}
+}
+
+void
+xpcc::Dispatcher::recordLatency(const Entry *entry, const Header& header)
+{
+#if XPCC_COMMUNICATION_STATISTICS
+	uint16_t latency = (xpcc::Clock::nowShort() - entry->transmitTime).getTime();
+	if (!header.isAcknowledge) {
+		this->statistics.responseLatency.record(latency);
+	}
+	else if (entry->state == Entry::State::WaitForACK) {
+		this->statistics.acknowledgeLatency.record(latency);
+	}
+#else
+	(void) entry;
+	(void) header;
+#endif
+}
+
+void
+xpcc::Dispatcher::removeEntry(Entry *entry)
+{
+	switch (entry->state)
+	{
+		case Entry::State::TransmissionPending:
+			this->getTransmissionQueue(entry->header).remove(*entry);
+			break;
+
+		case Entry::State::WaitForACK:
+			this->acknowledgeQueue.remove(*entry);
+			this->pendingTable.remove(entry);
+			this->numberOfPending--;
+			break;
+
+		case Entry::State::WaitForResponse:
+			this->responseQueue.remove(*entry);
+			this->pendingTable.remove(entry);
+			this->numberOfPending--;
+			break;
+	}
+
+	entry->~Entry();
+	this->freeEntries = new (entry) FreeEntry { this->freeEntries };
+}
+
+void *
+xpcc::Dispatcher::allocateEntry()
+{
+	if (this->freeEntries == nullptr) {
+		return ::operator new(sizeof(Entry));
+	}
+
+	FreeEntry *storage = this->freeEntries;
+	this->freeEntries = storage->next;
+	return storage;
+}
+
+void
+xpcc::Dispatcher::addPendingEntry(Entry *entry)
+{
+	this->pendingTable.insert(entry);
+	this->numberOfPending++;
+#if XPCC_COMMUNICATION_STATISTICS
+	if (this->numberOfPending > this->statistics.peakPendingMessages) {
+		this->statistics.peakPendingMessages = this->numberOfPending;
+	}
+#endif
+}
+
+void
+xpcc::Dispatcher::waitForResponse(Entry *entry)
+{
+	entry->time.restart(this->currentResponseTimeout);
+
+	// The response timeout may have been reduced in the meantime, so the
+	// entry isn't necessarily the last one to expire.
+	Entry *position = this->responseQueue.getBack();
+	while (position != nullptr and
+			position->time.remaining() > entry->time.remaining()) {
+		position = EntryQueue::getPrevious(position);
+	}
+
+	if (position == nullptr) {
+		this->responseQueue.prepend(*entry);
+	} else {
+		this->responseQueue.insertAfter(*position, *entry);
+	}
+}
+
+void
+xpcc::Dispatcher::reservePendingEntry()
+{
+	if (this->numberOfPending < this->maximumPending) {
+		return;
+	}
+
+	// Entries waiting for a response are evicted first, they have
+	// already been delivered to their destination.
+	Entry *entry = this->responseQueue.getFront();
+	if (entry == nullptr) {
+		entry = this->acknowledgeQueue.getFront();
+	}
+
+	if (entry != nullptr)
+	{
+		this->statistics.evictedMessages++;
+		this->countMessage(entry->header.source, &ComponentStatistics::dropped);
+		this->notifyTimeout(entry);
+		this->removeEntry(entry);
+	}
+}
+
+void
+xpcc::Dispatcher::notifyTimeout(const Entry *entry)
+{
+	if (entry->type == Entry::Type::Callback)
+	{
+		Header header(Header::Type::NEGATIVE_RESPONSE, false,
+				entry->header.source,
+				entry->header.destination,
+				entry->header.packetIdentifier);
+
+		entry->callbackResponse(header, SmartPointer());
 	}
-	
-	return entry;
 }
 
 void
 xpcc::Dispatcher::handleWaitingMessages()
 {
-	auto entry = this->entries.begin();
-	while(entry != this->entries.end())
+	// Responses are sent first. Only the responses queued before this call
+	// are handled. Since it is possible to give a response while an action
+	// is handled and call an action while a response is handled, one
+	// component calling an action on another component on the same board
+	// and handling its response in the same callback-function would
+	// otherwise cause an endless loop.
+	Entry *last = this->responseTransmissionQueue.getBack();
+	Entry *entry = this->responseTransmissionQueue.getFront();
+	while (entry != nullptr)
 	{
-		if (entry->state == Entry::State::TransmissionPending)
-		{
-			if (entry->header.destination == 0)
-			{
-				// event
-				postman->deliverPacket(entry->header, entry->payload);
-				backend->sendPacket(entry->header, entry->payload);
+		bool isLast = (entry == last);
+		entry = this->transmitEntry(entry);
+		if (isLast) {
+			break;
+		}
+	}
 
-				entry = this->entries.remove(entry);
-				continue;
-			}
-			else
-			{
-				// action or response
-				if (postman->isComponentAvailable(entry->header.destination))
-				{
-					entry = sendMessageToInnerComponent(entry);
-					continue;
-				}
-				else
-				{
-					// destination not on board, message has to be sent
-					// out to the backend
-					backend->sendPacket(entry->header, entry->payload);
+	// Requests and events queued while delivering messages to components
+	// on this board are still handled in this call.
+	entry = this->requestTransmissionQueue.getFront();
+	while (entry != nullptr) {
+		entry = this->transmitEntry(entry);
+	}
 
-					entry->state = Entry::State::WaitForACK;
-					entry->time.restart(acknowledgeTimeout);
+	entry = this->eventTransmissionQueue.getFront();
+	while (entry != nullptr) {
+		entry = this->transmitEntry(entry);
+	}
 
-					++entry;
-				}
-			}
+	this->handleAcknowledgeTimeouts();
+	this->handleResponseTimeouts();
+}
+
+xpcc::Dispatcher::Entry *
+xpcc::Dispatcher::transmitEntry(Entry *entry)
+{
+	this->countMessage(entry->header.source, &ComponentStatistics::sent);
+
+	if (entry->header.destination == 0)
+	{
+		// event
+		if (postman->deliverPacket(entry->header, entry->payload) == Postman::OK) {
+			this->countMessage(0, &ComponentStatistics::received);
 		}
-		else if (entry->state == Entry::State::WaitForACK)
-		{
-			if (entry->time.isExpired())
-			{
-				if (entry->tries >= 2)
-				{
-					// TODO do sth to notify the user
-					entry = this->entries.remove(entry);
-					continue;
-				}
-				else
-				{
-					backend->sendPacket(entry->header, entry->payload);
+		this->sendPacket(entry->header, entry->payload);
 
-					entry->tries++;
-					entry->time.restart(acknowledgeTimeout);
-				}
-			}
+		Entry *next = EntryQueue::getNext(entry);
+		this->removeEntry(entry);
+		return next;
+	}
+	else if (postman->isComponentAvailable(entry->header.destination))
+	{
+		// action or response
+		return this->sendMessageToInnerComponent(entry);
+	}
+	else
+	{
+		// destination not on board, message has to be sent
+		// out to the backend
+		this->sendPacket(entry->header, entry->payload);
+		this->reservePendingEntry();
+		this->markTransmitted(entry);
+
+		Entry *next = EntryQueue::getNext(entry);
+		this->getTransmissionQueue(entry->header).remove(*entry);
+
+		entry->state = Entry::State::WaitForACK;
+		entry->time.restart(acknowledgeTimeout);
+		this->acknowledgeQueue.append(*entry);
+		this->addPendingEntry(entry);
+
+		return next;
+	}
+}
+
+xpcc::Dispatcher::EntryQueue&
+xpcc::Dispatcher::getTransmissionQueue(const Header& header)
+{
+	if (header.type != Header::Type::REQUEST) {
+		return this->responseTransmissionQueue;
+	}
+	else if (header.destination == 0) {
+		return this->eventTransmissionQueue;
+	}
+	else {
+		return this->requestTransmissionQueue;
+	}
+}
 
-			++entry;
+void
+xpcc::Dispatcher::handleAcknowledgeTimeouts()
+{
+	// All entries use the same timeout, so the queue is sorted by the time
+	// of expiration. Retransmitted entries are appended again.
+	Entry *entry = this->acknowledgeQueue.getFront();
+	while (entry != nullptr && entry->time.isExpired())
+	{
+		if (entry->tries >= 2)
+		{
+			this->statistics.acknowledgeTimeouts++;
+			this->countMessage(entry->header.source, &ComponentStatistics::dropped);
+			this->notifyTimeout(entry);
+			this->removeEntry(entry);
 		}
-		else 
+		else
 		{
-			// WAIT_FOR_RESPONSE
-			// Responses stay in the queue for ever if no response ever
-			// comes. This may have to be changed.
-			++entry;
+			this->sendPacket(entry->header, entry->payload);
+			this->markTransmitted(entry);
+#if XPCC_COMMUNICATION_STATISTICS
+			this->statistics.retransmissions++;
+#endif
+			this->countMessage(entry->header.source, &ComponentStatistics::retransmissions);
+
+			entry->tries++;
+			entry->time.restart(acknowledgeTimeout);
+			this->acknowledgeQueue.remove(*entry);
+			this->acknowledgeQueue.append(*entry);
 		}
+		entry = this->acknowledgeQueue.getFront();
+	}
+}
+
+void
+xpcc::Dispatcher::handleResponseTimeouts()
+{
+	Entry *entry = this->responseQueue.getFront();
+	while (entry != nullptr && entry->time.isExpired())
+	{
+		this->statistics.responseTimeouts++;
+		this->countMessage(entry->header.source, &ComponentStatistics::dropped);
+		this->notifyTimeout(entry);
+		this->removeEntry(entry);
+
+		entry = this->responseQueue.getFront();
+	}
+}
+
+// ----------------------------------------------------------------------------
+#if XPCC_COMMUNICATION_STATISTICS
+xpcc::Dispatcher::ComponentStatistics *
+xpcc::Dispatcher::getComponentCounters(uint8_t component)
+{
+	uint8_t index = this->componentIndex[component];
+	if (index == 0)
+	{
+		if (this->trackedComponents >= statisticsComponents) {
+			return nullptr;
+		}
+		index = ++this->trackedComponents;
+		this->componentIndex[component] = index;
+	}
+	return &this->componentStatistics[index - 1];
+}
+
+xpcc::Dispatcher::ComponentStatistics
+xpcc::Dispatcher::getComponentStatistics(uint8_t id) const
+{
+	uint8_t index = this->componentIndex[id];
+	if (index == 0) {
+		return ComponentStatistics();
+	}
+	return this->componentStatistics[index - 1];
+}
+
+void
+xpcc::Dispatcher::resetStatistics()
+{
+	this->statistics = Statistics();
+
+	for (uint8_t& index : this->componentIndex) {
+		index = 0;
+	}
+	for (ComponentStatistics& counters : this->componentStatistics) {
+		counters = ComponentStatistics();
+	}
+	this->trackedComponents = 0;
+}
+
+xpcc::Dispatcher::StatisticsReport
+xpcc::Dispatcher::getStatisticsReport() const
+{
+	StatisticsReport report;
+	report.sentPackets = this->statistics.sentPackets;
+	report.receivedPackets = this->statistics.receivedPackets;
+	report.localMessages = this->statistics.localMessages;
+	report.retransmissions = this->statistics.retransmissions;
+	report.acknowledgeTimeouts = this->statistics.acknowledgeTimeouts;
+	report.responseTimeouts = this->statistics.responseTimeouts;
+	report.evictedMessages = this->statistics.evictedMessages;
+	report.pendingMessages = this->numberOfPending;
+	report.peakPendingMessages = this->statistics.peakPendingMessages;
+	report.acknowledgeLatencyAverage = this->statistics.acknowledgeLatency.getAverage();
+	report.acknowledgeLatencyMaximum = this->statistics.acknowledgeLatency.getMaximum();
+	report.responseLatencyAverage = this->statistics.responseLatency.getAverage();
+	report.responseLatencyMaximum = this->statistics.responseLatency.getMaximum();
+	return report;
+}
+
+void
+xpcc::Dispatcher::setStatisticsEvent(uint8_t source, uint8_t event, uint16_t interval)
+{
+	this->statisticsSource = source;
+	this->statisticsEvent = event;
+	this->statisticsInterval = interval;
+	if (interval > 0) {
+		this->statisticsTimer.restart(interval);
+	}
+	else {
+		this->statisticsTimer.stop();
 	}
 }
 
+void
+xpcc::Dispatcher::publishStatistics(uint8_t source, uint8_t event)
+{
+	const StatisticsReport report = this->getStatisticsReport();
+
+	Header header(Header::Type::REQUEST, false, 0, source, event);
+	SmartPointer payload(&report);
+	this->addMessage(header, payload);
+}
+#endif
+
 // ----------------------------------------------------------------------------
 void
 xpcc::Dispatcher::addMessage(const Header& header,
 		SmartPointer& smartPayload)
 {
-	this->entries.append(Entry(header, smartPayload));
+	this->getTransmissionQueue(header).append(*new (this->allocateEntry()) Entry(header, smartPayload));
 }
 
 void
 xpcc::Dispatcher::addMessage(const Header& header,
 		SmartPointer& smartPayload, ResponseCallback& responseCallback)
 {
-	this->entries.append(Entry(header, smartPayload, responseCallback));
+	this->requestTransmissionQueue.append(*new (this->allocateEntry()) Entry(header, smartPayload, responseCallback));
 }
 
 void
 xpcc::Dispatcher::addResponse(const Header& header,
 		SmartPointer& smartPayload)
 {
-	// it makes response more important, than requests
-	// it prevents intern loops. Since it is possible to give a response while 
-	// an action is handled and call an action while response is handled
-	// one component calling one action on another component on same board
-	// handling its response in the same callback-function would cause a loop
-	// if responses and actions both are appended at the tail of the list.
-	// but now responses are handled in reverse order that's not good
-	// what to do? a separator between responses and requests possible?
+	this->responseTransmissionQueue.append(*new (this->allocateEntry()) Entry(header, smartPayload));
+}
+
+// ----------------------------------------------------------------------------
+xpcc::Dispatcher::PendingTable::PendingTable()
+{
+	for (uint_fast16_t i = 0; i < pendingTableSize; ++i) {
+		this->buckets[i] = nullptr;
+	}
+}
 
-	this->entries.prepend(Entry(header, smartPayload));
+void
+xpcc::Dispatcher::PendingTable::insert(Entry *entry)
+{
+	entry->nextPending = nullptr;
+
+	Entry **slot = &this->buckets[getBucket(entry->header.destination,
+			entry->header.source, entry->header.packetIdentifier)];
+	while (*slot != nullptr) {
+		slot = &(*slot)->nextPending;
+	}
+	*slot = entry;
+}
+
+void
+xpcc::Dispatcher::PendingTable::remove(Entry *entry)
+{
+	Entry **slot = &this->buckets[getBucket(entry->header.destination,
+			entry->header.source, entry->header.packetIdentifier)];
+	while (*slot != nullptr)
+	{
+		if (*slot == entry) {
+			*slot = entry->nextPending;
+			return;
+		}
+		slot = &(*slot)->nextPending;
+	}
+}
+
+xpcc::Dispatcher::Entry *
+xpcc::Dispatcher::PendingTable::find(const Header& header) const
+{
+	Entry *entry = this->buckets[getBucket(header.source,
+			header.destination, header.packetIdentifier)];
+	while (entry != nullptr && !entry->headerFits(header)) {
+		entry = entry->nextPending;
+	}
+	return entry;
 }
@@ -31,19 +31,61 @@
 #ifndef	XPCC__DISPATCHER_HPP
 #define	XPCC__DISPATCHER_HPP
 
+#include <xpcc/architecture/detect.hpp>
+#include <xpcc/architecture/utils.hpp>
+#include <xpcc/container/intrusive_doubly_linked_list.hpp>
 #include <xpcc/processing/timer.hpp>
-#include <xpcc/container/linked_list.hpp>
 
 #include "backend/backend_interface.hpp"
 #include "postman/postman.hpp"
 
 #include "response_callback.hpp"
+#include "statistics.hpp"
 
 namespace xpcc
 {
 	/**
 	 * \brief
 	 *
+	 * Messages waiting for transmission are kept in one FIFO per message
+	 * class. Responses are sent before requests, requests before events.
+	 * Acknowledges are not queued at all, they are sent as soon as the
+	 * message is received. Once a message
+	 * has been sent it is moved to a table of pending messages, which is
+	 * indexed by (destination, source, packetIdentifier) so incoming
+	 * acknowledges and responses are matched without walking all
+	 * outstanding messages.
+	 *
+	 * Messages waiting for an acknowledge are additionally kept in a
+	 * separate timeout queue. As every entry uses the same
+	 * acknowledgeTimeout the queue is always sorted by expiration time,
+	 * so only its front has to be checked for retries.
+	 *
+	 * Requests with a response callback wait for the response up to the
+	 * response timeout after they were acknowledged (or delivered to a
+	 * component on this board). If no response arrives in time, or if the
+	 * request is never acknowledged, the callback is called with a
+	 * NEGATIVE_RESPONSE header and an empty payload.
+	 *
+	 * The number of sent messages waiting for an acknowledge or a response
+	 * is bounded. When the bound is reached the oldest message waiting for
+	 * a response (or, if there is none, the oldest message waiting for an
+	 * acknowledge) is evicted and its callback is notified the same way.
+	 *
+	 * Messages between components on this board are delivered directly.
+	 * By default they are also sent to the backend, so the communication
+	 * can be logged externally. See setMirroring() to send only every
+	 * n-th of them, none at all or to hand them to a separate backend.
+	 * Events are always sent to the backend, because components on other
+	 * boards may listen to them.
+	 *
+	 * With XPCC_COMMUNICATION_STATISTICS enabled the dispatcher counts
+	 * the transmitted, retransmitted and dropped messages, in total and
+	 * per component, and records the latency of acknowledges and
+	 * responses, see getStatistics() and getComponentStatistics(). The
+	 * statistics can also be published as an event, see
+	 * setStatisticsEvent().
+	 *
 	 * \todo	Documentation
 	 *
 	 * \author	Georgi Grinshpun
@@ -53,15 +95,259 @@ namespace xpcc
 	{
 	public:
 		static const uint16_t acknowledgeTimeout = 500;
-		static const uint16_t responseTimeout = 100;
+
+		/// Default time to wait for a response after a request was acknowledged
+		static const uint16_t responseTimeout = 1000;
+
+		/// Default bound for messages waiting for an acknowledge or a response
+#ifdef XPCC__OS_HOSTED
+		static const uint16_t maximumPendingMessages = 1000;
+#else
+		static const uint16_t maximumPendingMessages = 16;
+#endif
+
+		/// Number of buckets of the pending message table is 2^pendingTableBits
+#ifdef XPCC__OS_HOSTED
+		static const uint8_t pendingTableBits = 10;
+#else
+		static const uint8_t pendingTableBits = 4;
+#endif
+		static const uint16_t pendingTableSize = (1 << pendingTableBits);
+
+		/// Maximum number of packets exchanged with the backend per call
+#ifdef XPCC__OS_HOSTED
+		static const uint8_t packetBatchSize = 16;
+#else
+		static const uint8_t packetBatchSize = 4;
+#endif
+
+		/// Number of components with their own statistics
+#ifdef XPCC__OS_HOSTED
+		static const uint8_t statisticsComponents = 32;
+#else
+		static const uint8_t statisticsComponents = 8;
+#endif
+
+		/// What happens to messages between components on this board
+		enum class Mirroring : uint8_t
+		{
+			/// Every message is sent to the backend as well
+			All,
+			/// Messages are only delivered locally
+			None,
+			/// Only every n-th message is sent to the backend
+			Sampled,
+			/// Messages are sent to the tap backend instead
+			Tap,
+		};
 
 	public:
 		Dispatcher(BackendInterface *backend, Postman* postman);
 
+		~Dispatcher();
+
 		void
 		update();
 
+		/**
+		 * \brief	Wait until the dispatcher has something to do
+		 *
+		 * Returns right away if messages are waiting for transmission.
+		 * Otherwise blocks in BackendInterface::waitForPacket() until a
+		 * packet arrives, the next acknowledge or response timeout
+		 * expires or \p timeout milliseconds have passed. Backends which
+		 * are not able to block return immediately.
+		 *
+		 * \return	\c true if update() has work to do
+		 */
+		bool
+		waitForActivity(uint16_t timeout);
+
+		/**
+		 * \brief	Wait for activity and update the dispatcher
+		 *
+		 * Replaces calling update() in a tight loop:
+		 * \code
+		 * while (true)
+		 * {
+		 *     dispatcher.run(100);
+		 *     component.update();
+		 * }
+		 * \endcode
+		 *
+		 * \param	timeout	Maximum time to wait in milliseconds
+		 */
+		void
+		run(uint16_t timeout);
+
+		/**
+		 * \brief	Change the time to wait for a response
+		 *
+		 * Only affects requests which are acknowledged afterwards. Pending
+		 * requests keep their expiration.
+		 */
+		inline void
+		setResponseTimeout(uint16_t timeout)
+		{
+			this->currentResponseTimeout = timeout;
+		}
+
+		/// Change the bound for messages waiting for an acknowledge or a response
+		inline void
+		setMaximumPendingMessages(uint16_t maximum)
+		{
+			this->maximumPending = (maximum > 0) ? maximum : 1;
+		}
+
+		/**
+		 * \brief	Select how messages between components on this board
+		 * 			are mirrored
+		 *
+		 * \param	interval	Every \p interval-th message is mirrored with
+		 * 						Mirroring::Sampled
+		 */
+		void
+		setMirroring(Mirroring mode, uint16_t interval = 1);
+
+		/**
+		 * \brief	Mirror messages between components on this board to a
+		 * 			separate backend
+		 *
+		 * Packets received by the tap backend are ignored, its update()
+		 * method is called by update(). Selects Mirroring::Tap, or
+		 * Mirroring::None if \p tap is \c nullptr.
+		 */
+		void
+		setTapBackend(BackendInterface *tap);
+
+		inline Mirroring
+		getMirroring() const
+		{
+			return this->mirroring;
+		}
+
+		/// Number of messages waiting for an acknowledge or a response
+		inline uint16_t
+		getNumberOfPendingMessages() const
+		{
+			return this->numberOfPending;
+		}
+
+		struct Statistics
+		{
+			/// Messages dropped because all retransmissions were unacknowledged
+			uint32_t acknowledgeTimeouts = 0;
+
+			/// Requests for which no response arrived in time
+			uint32_t responseTimeouts = 0;
+
+			/// Messages dropped because maximumPendingMessages was reached
+			uint32_t evictedMessages = 0;
+
+#if XPCC_COMMUNICATION_STATISTICS
+			/// Packets handed to the backend, including acknowledges and retransmissions
+			uint32_t sentPackets = 0;
+
+			/// Packets received from the backend
+			uint32_t receivedPackets = 0;
+
+			/// Messages delivered to components on this board without the backend
+			uint32_t localMessages = 0;
+
+			/// Messages sent again because no acknowledge arrived in time
+			uint32_t retransmissions = 0;
+
+			/// Highest number of messages waiting for an acknowledge or a response
+			uint16_t peakPendingMessages = 0;
+
+			/// Time from the (last) transmission of a message to its acknowledge
+			LatencyHistogram acknowledgeLatency;
+
+			/// Time from the (last) transmission of a request to its response
+			LatencyHistogram responseLatency;
+#endif
+		};
+
+		/// Message counters of one component
+		struct ComponentStatistics
+		{
+			/// Messages sent by the component
+			uint32_t sent = 0;
+
+			/// Messages delivered to the component, events count for component 0
+			uint32_t received = 0;
+
+			/// Messages of the component sent again
+			uint32_t retransmissions = 0;
+
+			/// Messages of the component dropped after a timeout or eviction
+			uint32_t dropped = 0;
+		};
+
+		/// Payload of the statistics event, see setStatisticsEvent()
+		struct StatisticsReport
+		{
+			uint32_t sentPackets;
+			uint32_t receivedPackets;
+			uint32_t localMessages;
+			uint32_t retransmissions;
+			uint32_t acknowledgeTimeouts;
+			uint32_t responseTimeouts;
+			uint32_t evictedMessages;
+			uint16_t pendingMessages;
+			uint16_t peakPendingMessages;
+			uint16_t acknowledgeLatencyAverage;
+			uint16_t acknowledgeLatencyMaximum;
+			uint16_t responseLatencyAverage;
+			uint16_t responseLatencyMaximum;
+		} xpcc_packed;
+
+		inline const Statistics&
+		getStatistics() const
+		{
+			return this->statistics;
+		}
+
+#if XPCC_COMMUNICATION_STATISTICS
+		/**
+		 * \brief	Counters of component \p id
+		 *
+		 * The first statisticsComponents components which send or receive
+		 * a message are tracked, the counters of all other components
+		 * stay zero.
+		 */
+		ComponentStatistics
+		getComponentStatistics(uint8_t id) const;
+
+		/// Reset all counters and histograms
+		void
+		resetStatistics();
+
+		/// Current statistics in the format of the statistics event
+		StatisticsReport
+		getStatisticsReport() const;
+
+		/**
+		 * \brief	Publish the statistics as event
+		 *
+		 * Every \p interval milliseconds update() queues the event
+		 * \p event from component \p source with a StatisticsReport as
+		 * payload. An interval of zero stops publishing.
+		 */
+		void
+		setStatisticsEvent(uint8_t source, uint8_t event, uint16_t interval);
+
+		/// Queue the statistics event once
+		void
+		publishStatistics(uint8_t source, uint8_t event);
+#endif
+
 	private:
+		Dispatcher(const Dispatcher&);
+
+		Dispatcher&
+		operator = (const Dispatcher&);
+
 		/// Does not handle requests which are not acknowledge.
 		void
 		handlePacket(const Header& header, const SmartPointer& payload);
@@ -74,7 +360,7 @@ namespace xpcc
 		 * \brief 	This class holds information about a Message being send.
 		 * 			This is the superclass of all entries.
 		 */
-		class Entry
+		class Entry : public IntrusiveDoublyLinkedListHook<>
 		{
 		public:
 			enum class Type
@@ -94,12 +380,10 @@ namespace xpcc
 		public:
 			/**
 			 * \brief 	Creates one Entry with given header.
-			 * 			this->next is initially set Null
 			 *
-			 * Creates one Entry with given header. this->next is initially
-			 * set Null. The const member this->typeInfo is set to typeInfo
-			 * and never else changed. this->typeInfo replaces runtime
-			 * information needed by handling of messages.
+			 * The const member this->type is set to type and never else
+			 * changed. this->type replaces runtime information needed by
+			 * handling of messages.
 			 */
 			Entry(Type type, const Header& inHeader, SmartPointer& inPayload) :
 				type(type),
@@ -144,8 +428,72 @@ namespace xpcc
 			State state = State::TransmissionPending;
 			ShortTimeout time;
 			uint8_t tries = 0;
+
+#if XPCC_COMMUNICATION_STATISTICS
+			/// Time of the last transmission
+			ShortTimestamp transmitTime;
+#endif
+
 		private:
+			friend class Dispatcher;
+
+			Entry(const Entry&);
+
+			Entry&
+			operator = (const Entry&);
+
 			ResponseCallback callback;
+
+			// hook for the bucket of the pending message table
+			Entry *nextPending = nullptr;
+		};
+
+		/**
+		 * \brief	FIFO of entries
+		 *
+		 * The links are stored inside the entries, so appending and
+		 * removing an entry never allocates memory and is O(1).
+		 * An entry can only be part of one queue at a time.
+		 */
+		typedef IntrusiveDoublyLinkedList<Entry> EntryQueue;
+
+		/**
+		 * \brief	Entries which were sent and wait for an acknowledge or
+		 * 			a response.
+		 *
+		 * Entries are hashed by (destination, source, packetIdentifier) of
+		 * the sent message. Within one bucket entries are kept in the
+		 * order of insertion, so if several entries fit to one incoming
+		 * message the oldest is found first.
+		 */
+		class PendingTable
+		{
+		public:
+			PendingTable();
+
+			void
+			insert(Entry *entry);
+
+			void
+			remove(Entry *entry);
+
+			/// Find the oldest entry the given acknowledge or response fits to.
+			Entry *
+			find(const Header& header) const;
+
+		private:
+			static inline uint16_t
+			getBucket(uint8_t destination, uint8_t source, uint8_t identifier)
+			{
+				// symmetric in destination and source, so a sent message and
+				// its reply end up in the same bucket
+				uint16_t key = (static_cast<uint16_t>(destination ^ source) << 8) | identifier;
+
+				// multiplicative (Fibonacci) hashing, uses the upper bits
+				return static_cast<uint16_t>(key * 40503U) >> (16 - pendingTableBits);
+			}
+
+			Entry *buckets[pendingTableSize];
 		};
 
 		void
@@ -164,16 +512,171 @@ namespace xpcc
 		void
 		sendAcknowledge(const Header& header);
 
-		using EntryList = LinkedList<Entry>;
-		using EntryIterator = EntryList::iterator;
+		/**
+		 * \brief	Queue a packet for the backend
+		 *
+		 * The packets are handed to the backend in batches, at the latest
+		 * at the end of update().
+		 */
+		void
+		sendPacket(const Header& header, const SmartPointer& payload);
+
+		/// Hand all queued packets to the backend
+		void
+		flushPackets();
+
+		/// Mirror a message to a component on this board, see setMirroring()
+		void
+		mirrorPacket(const Header& header, const SmartPointer& payload);
+
+		/**
+		 * \brief	Deliver a message to a component on this board.
+		 *
+		 * The entry is removed from the transmission queue and either
+		 * destroyed or moved to the pending message table.
+		 *
+		 * \return	Entry following in the transmission queue
+		 */
+		Entry *
+		sendMessageToInnerComponent(Entry *entry);
+
+		/**
+		 * \brief	Send a message waiting in one of the transmission queues
+		 *
+		 * \return	Entry following in the same transmission queue
+		 */
+		Entry *
+		transmitEntry(Entry *entry);
+
+		/// Transmission queue for messages with the given header
+		EntryQueue&
+		getTransmissionQueue(const Header& header);
 
-		EntryIterator
-		sendMessageToInnerComponent(EntryIterator entry);
+		/// Storage for a new entry, reuses the storage of removed entries
+		void *
+		allocateEntry();
+
+		/// Unlink an entry from all containers and destroy it
+		void
+		removeEntry(Entry *entry);
+
+		/// Add a sent entry to the pending message table
+		void
+		addPendingEntry(Entry *entry);
+
+		/// Start the response timeout of an entry and add it to the
+		/// responseQueue, sorted by expiration
+		void
+		waitForResponse(Entry *entry);
+
+		/**
+		 * \brief	Make room for one more entry in the pending message table
+		 *
+		 * Evicts the oldest entry if the bound is already reached. Must be
+		 * called before the entry is added, because the callback of the
+		 * evicted entry may queue new messages.
+		 */
+		void
+		reservePendingEntry();
+
+		/// Call the response callback of an entry with a NEGATIVE_RESPONSE
+		void
+		notifyTimeout(const Entry *entry);
+
+		/// Count a message for a component, see ComponentStatistics
+		inline void
+		countMessage(uint8_t component, uint32_t ComponentStatistics::*counter)
+		{
+#if XPCC_COMMUNICATION_STATISTICS
+			ComponentStatistics *counters = this->getComponentCounters(component);
+			if (counters != nullptr) {
+				(counters->*counter)++;
+			}
+#else
+			(void) component;
+			(void) counter;
+#endif
+		}
+
+		/// Remember when an entry was transmitted or delivered
+		inline void
+		markTransmitted(Entry *entry)
+		{
+#if XPCC_COMMUNICATION_STATISTICS
+			entry->transmitTime = xpcc::Clock::nowShort();
+#else
+			(void) entry;
+#endif
+		}
+
+		/// Record the latency of an acknowledge or response for \p entry
+		void
+		recordLatency(const Entry *entry, const Header& header);
+
+#if XPCC_COMMUNICATION_STATISTICS
+		/// Counters of a component, \c nullptr if the table is full
+		ComponentStatistics *
+		getComponentCounters(uint8_t component);
+#endif
+
+		/// Retransmit or drop all messages for which no acknowledge was received
+		void
+		handleAcknowledgeTimeouts();
+
+		/// Drop all requests for which no response was received
+		void
+		handleResponseTimeouts();
 
 		BackendInterface * const backend;
 		Postman * const postman;
 
-		EntryList entries;
+		/// Messages waiting to be sent
+		EntryQueue responseTransmissionQueue;
+		EntryQueue requestTransmissionQueue;
+		EntryQueue eventTransmissionQueue;
+
+		/// Sent messages waiting for an acknowledge, sorted by expiration
+		EntryQueue acknowledgeQueue;
+
+		/// Sent messages waiting for a response, sorted by expiration
+		EntryQueue responseQueue;
+
+		/// Sent messages waiting for an acknowledge or a response
+		PendingTable pendingTable;
+
+		uint16_t numberOfPending;
+		uint16_t maximumPending;
+		uint16_t currentResponseTimeout;
+
+		Statistics statistics;
+
+#if XPCC_COMMUNICATION_STATISTICS
+		/// Index + 1 into componentStatistics, zero if not tracked
+		uint8_t componentIndex[256];
+		ComponentStatistics componentStatistics[statisticsComponents];
+		uint8_t trackedComponents;
+
+		uint8_t statisticsSource;
+		uint8_t statisticsEvent;
+		uint16_t statisticsInterval;
+		ShortTimeout statisticsTimer;
+#endif
+
+		Mirroring mirroring;
+		uint16_t mirrorInterval;
+		uint16_t mirrorCounter;
+		BackendInterface *tapBackend;
+
+		/// Storage of removed entries, kept to avoid heap allocations
+		struct FreeEntry
+		{
+			FreeEntry *next;
+		};
+		FreeEntry *freeEntries;
+
+		BackendInterface::Packet receiveBuffer[packetBatchSize];
+		BackendInterface::Packet transmitBuffer[packetBatchSize];
+		uint8_t transmitCount;
 
 	private:
 		friend class Communicator;
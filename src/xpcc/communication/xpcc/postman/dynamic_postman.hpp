@@ -15,8 +15,9 @@
 #include "../backend/header.hpp"
 #include "../response_handle.hpp"
 
-#include <map>
-#include <functional>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 namespace xpcc
 {
@@ -29,6 +30,11 @@ namespace xpcc
  *
  * On hosted however, this class allows for much easier registering of callbacks.
  *
+ * Handlers are stored in tables directly indexed by the 8-bit identifiers.
+ * Action handlers are kept in one page of 256 entries per component, which
+ * is allocated when the first action of the component is registered.
+ * Delivering a packet therefore takes constant time and never allocates.
+ *
  * @ingroup	xpcc_comm
  * @author	Niklas Hauser
  */
@@ -43,6 +49,9 @@ public:
 	bool
 	isComponentAvailable(uint8_t component) const override;
 
+	bool
+	isEventSubscribed(uint8_t event) const override;
+
 public:
 	template< class C >
 	bool
@@ -65,51 +74,116 @@ public:
 						  void (C::*memberFunction)(const ResponseHandle&, const P&));
 
 private:
-	typedef std::function<void (const Header&, const uint8_t&)> EventCallback;
-	typedef std::function<void (const Header&)> EventCallbackSimple;
-
-	typedef std::function<void (const ResponseHandle&, const uint8_t&)> ActionCallback;
-	typedef std::function<void (const ResponseHandle&)> ActionCallbackSimple;
-
-	class EventListener
+	/**
+	 * Pointer to a member function together with its object.
+	 *
+	 * The object is stored as a void pointer and the member function in
+	 * a buffer of a common member function pointer type. The trampoline
+	 * of the original class restores both before calling.
+	 */
+	template< typename Argument >
+	class Delegate
 	{
-		EventCallback call;
-		EventCallbackSimple callSimple;
-		int8_t hasPayload;
-
 	public:
-		EventListener();
-		EventListener(EventCallback call);
-		EventListener(EventCallbackSimple call);
-
-		void operator()(const Header& header, const SmartPointer& payload) const;
+		Delegate() :
+			component(nullptr), trampoline(nullptr)
+		{
+		}
+
+		template< class C, typename P >
+		Delegate(C *componentObject, void (C::*memberFunction)(const Argument&, const P&)) :
+			component(componentObject),
+			trampoline(&Delegate::callWithPayload<C, P>)
+		{
+			store(memberFunction);
+		}
+
+		template< class C >
+		Delegate(C *componentObject, void (C::*memberFunction)(const Argument&)) :
+			component(componentObject),
+			trampoline(&Delegate::call<C>)
+		{
+			store(memberFunction);
+		}
+
+		inline bool
+		isCallable() const
+		{
+			return (component != nullptr);
+		}
+
+		inline void
+		operator()(const Argument& argument, const SmartPointer& payload) const
+		{
+			trampoline(*this, argument, payload);
+		}
+
+	private:
+		typedef void (Delegate::*Function)();
+		typedef void (*Trampoline)(const Delegate&, const Argument&, const SmartPointer&);
+
+		template< typename F >
+		inline void
+		store(F memberFunction)
+		{
+			static_assert(sizeof(F) == sizeof(Function),
+					"Unsupported size of member function pointer!");
+			std::memcpy(&function, &memberFunction, sizeof(F));
+		}
+
+		template< typename F >
+		inline F
+		load() const
+		{
+			F memberFunction;
+			std::memcpy(&memberFunction, &function, sizeof(F));
+			return memberFunction;
+		}
+
+		template< class C, typename P >
+		static void
+		callWithPayload(const Delegate& delegate, const Argument& argument, const SmartPointer& payload)
+		{
+			typedef void (C::*MemberFunction)(const Argument&, const P&);
+			(static_cast<C *>(delegate.component)->*delegate.template load<MemberFunction>())(
+					argument, *reinterpret_cast<const P *>(payload.getPointer()));
+		}
+
+		template< class C >
+		static void
+		call(const Delegate& delegate, const Argument& argument, const SmartPointer&)
+		{
+			typedef void (C::*MemberFunction)(const Argument&);
+			(static_cast<C *>(delegate.component)->*delegate.template load<MemberFunction>())(
+					argument);
+		}
+
+		void *component;
+		Trampoline trampoline;
+		Function function;
 	};
 
-	class ActionHandler
-	{
-		ActionCallback call;
-		ActionCallbackSimple callSimple;
-		int8_t hasPayload;
-
-	public:
-		ActionHandler();
-		ActionHandler(ActionCallback call);
-		ActionHandler(ActionCallbackSimple call);
+	typedef Delegate<Header> EventListener;
+	typedef Delegate<ResponseHandle> ActionHandler;
 
-		void operator()(const ResponseHandle& response, const SmartPointer& payload) const;
+	/// actionId -> handler
+	struct ActionPage
+	{
+		ActionHandler handlers[256];
 	};
 
-	/// packetIdentifier -> callback
-	typedef std::multimap<uint8_t, EventListener> EventMap;
+	void
+	addEventListener(uint8_t eventId, const EventListener& listener);
 
-	/// packetIdentifier -> callback
-	typedef std::map<uint8_t, ActionHandler > CallbackMap;
-	///< destination -> callbackMap
-	typedef std::map<uint8_t, CallbackMap > ActionMap;
+	void
+	setActionHandler(uint8_t componentId, uint8_t actionId, const ActionHandler& handler);
 
 private:
-	EventMap eventMap;
-	ActionMap actionMap;
+	/// eventId -> listeners, in order of registration
+	std::vector<EventListener> eventListeners[256];
+
+	/// componentId -> handlers of the component
+	std::unique_ptr<ActionPage> actionPages[256];
 };
 
 }	// namespace xpcc
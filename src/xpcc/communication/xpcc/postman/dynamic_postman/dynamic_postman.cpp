@@ -21,38 +21,35 @@ xpcc::DynamicPostman::deliverPacket(const Header &header, const SmartPointer& pa
 	if (header.destination == 0)
 	{
 		// EVENT
-		EventMap::const_iterator lowerBound(this->eventMap.lower_bound(header.packetIdentifier));
-		EventMap::const_iterator upperBound(this->eventMap.upper_bound(header.packetIdentifier));
-		if (lowerBound != upperBound) {
-			do {
-				lowerBound->second(header, payload);
-				lowerBound++;
-			}
-			while (lowerBound != upperBound);
-			return OK;
+		const std::vector<EventListener>& listeners =
+				this->eventListeners[header.packetIdentifier];
+		if (listeners.empty()) {
+			return NO_EVENT;
 		}
-		return NO_EVENT;
+
+		// listeners may register further listeners, which reallocates
+		for (std::size_t i = 0; i < listeners.size(); ++i) {
+			EventListener listener = listeners[i];
+			listener(header, payload);
+		}
+		return OK;
 	}
 	else
 	{
 		// REQUEST
-		ActionMap::const_iterator iterDestination(this->actionMap.find(header.destination));
-		if (iterDestination != this->actionMap.end())
-		{
-			CallbackMap::const_iterator iterCallback(iterDestination->second.find(header.packetIdentifier));
-			if (iterCallback != iterDestination->second.end())
-			{
-				xpcc::ResponseHandle response(header);
-				iterCallback->second(response, payload);
-				return OK;
-			}
-			else {
-				return NO_ACTION;
-			}
-		}
-		else {
+		const ActionPage *page = this->actionPages[header.destination].get();
+		if (page == nullptr) {
 			return NO_COMPONENT;
 		}
+
+		const ActionHandler& handler = page->handlers[header.packetIdentifier];
+		if (!handler.isCallable()) {
+			return NO_ACTION;
+		}
+
+		xpcc::ResponseHandle response(header);
+		handler(response, payload);
+		return OK;
 	}
 }
 
@@ -60,61 +57,29 @@ xpcc::DynamicPostman::deliverPacket(const Header &header, const SmartPointer& pa
 bool
 xpcc::DynamicPostman::isComponentAvailable(uint8_t component) const
 {
-	return (this->actionMap.find(component) != this->actionMap.end());
-}
-
-// ----------------------------------------------------------------------------
-xpcc::DynamicPostman::EventListener::EventListener() :
-		hasPayload(-1)
-{
-}
-
-xpcc::DynamicPostman::EventListener::EventListener(EventCallback call) :
-		call(call), hasPayload(1)
-{
+	return (this->actionPages[component] != nullptr);
 }
 
-xpcc::DynamicPostman::EventListener::EventListener(EventCallbackSimple call) :
-		callSimple(call), hasPayload(0)
-{
-}
-
-void
-xpcc::DynamicPostman::EventListener::operator()(
-		const Header& header,
-		const SmartPointer& payload) const
+bool
+xpcc::DynamicPostman::isEventSubscribed(uint8_t event) const
 {
-	if (hasPayload > 0) {
-		call(header, *(payload.getPointer()));
-	} else if (hasPayload == 0) {
-		callSimple(header);
-	}
+	return not this->eventListeners[event].empty();
 }
 
 // ----------------------------------------------------------------------------
-xpcc::DynamicPostman::ActionHandler::ActionHandler() :
-		hasPayload(-1)
-{
-}
-
-xpcc::DynamicPostman::ActionHandler::ActionHandler(ActionCallback call) :
-		call(call), hasPayload(1)
-{
-}
-
-xpcc::DynamicPostman::ActionHandler::ActionHandler(ActionCallbackSimple call) :
-		callSimple(call), hasPayload(0)
+void
+xpcc::DynamicPostman::addEventListener(uint8_t eventId, const EventListener& listener)
 {
+	this->eventListeners[eventId].push_back(listener);
 }
 
 void
-xpcc::DynamicPostman::ActionHandler::operator()(
-		const ResponseHandle& response,
-		const SmartPointer& payload) const
+xpcc::DynamicPostman::setActionHandler(uint8_t componentId, uint8_t actionId,
+		const ActionHandler& handler)
 {
-	if (hasPayload > 0) {
-		call(response, *(payload.getPointer()));
-	} else if (hasPayload == 0) {
-		callSimple(response);
+	std::unique_ptr<ActionPage>& page = this->actionPages[componentId];
+	if (page == nullptr) {
+		page.reset(new ActionPage());
 	}
+	page->handlers[actionId] = handler;
 }
@@ -17,20 +17,7 @@ xpcc::DynamicPostman::registerEventListener(const uint8_t eventId,
 		C *componentObject,
 		void (C::*memberFunction)(const Header&))
 {
-	using namespace std::placeholders;
-
-	eventMap.insert(
-			std::pair<uint8_t, EventListener>(
-					eventId,
-					EventListener(static_cast<EventCallbackSimple>(
-							std::bind(
-									memberFunction,
-									componentObject,
-									_1)
-					))
-			)
-	);
-
+	addEventListener(eventId, EventListener(componentObject, memberFunction));
 	return true;
 }
 
@@ -40,21 +27,7 @@ xpcc::DynamicPostman::registerEventListener(const uint8_t eventId,
 		C *componentObject,
 		void (C::*memberFunction)(const Header&, const P&))
 {
-	using namespace std::placeholders;
-	typedef void (C::*Function)(const Header&, const uint8_t&);
-
-	eventMap.insert(
-			std::pair<uint8_t, EventListener>(
-					eventId,
-					EventListener(
-							std::bind(
-									reinterpret_cast<Function>(memberFunction),
-									componentObject,
-									_1, _2)
-					)
-			)
-	);
-
+	addEventListener(eventId, EventListener(componentObject, memberFunction));
 	return true;
 }
 
@@ -65,15 +38,7 @@ xpcc::DynamicPostman::registerActionHandler(const uint8_t componentId,
 		C *componentObject,
 		void (C::*memberFunction)(const ResponseHandle&))
 {
-	using namespace std::placeholders;
-
-	actionMap[componentId][actionId] = ActionHandler(static_cast<ActionCallbackSimple>(
-			std::bind(
-					memberFunction,
-					componentObject,
-					_1)
-	));
-
+	setActionHandler(componentId, actionId, ActionHandler(componentObject, memberFunction));
 	return true;
 }
 
@@ -84,15 +49,6 @@ xpcc::DynamicPostman::registerActionHandler(const uint8_t componentId,
 		C *componentObject,
 		void (C::*memberFunction)(const ResponseHandle&, const P&))
 {
-	using namespace std::placeholders;
-	typedef void (C::*Function)(const ResponseHandle&, const uint8_t&);
-
-	actionMap[componentId][actionId] = ActionHandler(
-			std::bind(
-					reinterpret_cast<Function>(memberFunction),
-					componentObject,
-					_1, _2)
-	);
-
+	setActionHandler(componentId, actionId, ActionHandler(componentObject, memberFunction));
 	return true;
 }
@@ -72,6 +72,22 @@ namespace xpcc
 		 */
 		virtual bool
 		isComponentAvailable(uint8_t component) const = 0;
+
+		/**
+		 * \brief	Check if a component on this board listens to an event
+		 *
+		 * Used to configure the acceptance filters of a backend. The
+		 * default implementation accepts all events.
+		 *
+		 * \param	event	Id of the event
+		 * \return	\c true if events with this id have to be received,
+		 * 			\c false otherwise.
+		 */
+		virtual bool
+		isEventSubscribed(uint8_t /* event */) const
+		{
+			return true;
+		}
 	};
 }
 
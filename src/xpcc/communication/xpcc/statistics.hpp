@@ -0,0 +1,153 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC__COMMUNICATION_STATISTICS_HPP
+#define XPCC__COMMUNICATION_STATISTICS_HPP
+
+#include <stdint.h>
+
+#include <xpcc/architecture/detect.hpp>
+
+#ifdef __DOXYGEN__
+
+/**
+ * Collect message counters and latency histograms in the Dispatcher and
+ * the backends.
+ *
+ * Enabled by default, except on AVRs where the additional RAM and cycles
+ * per message hurt most. Override it in your `project.cfg`:
+ *
+@verbatim
+[defines]
+XPCC_COMMUNICATION_STATISTICS = 0
+@endverbatim
+ *
+ * @ingroup	xpcc_comm
+ */
+#define XPCC_COMMUNICATION_STATISTICS	1
+
+#else
+#	ifndef XPCC_COMMUNICATION_STATISTICS
+#		ifdef XPCC__CPU_AVR
+#			define XPCC_COMMUNICATION_STATISTICS	0
+#		else
+#			define XPCC_COMMUNICATION_STATISTICS	1
+#		endif
+#	endif
+#endif
+
+namespace xpcc
+{
+
+/**
+ * @brief	Histogram of latencies in milliseconds
+ *
+ * Bucket 0 counts latencies below 1 ms, bucket `i` latencies from
+ * `2^(i-1)` to `2^i - 1` ms. The last bucket also counts everything
+ * above. Recording a value takes a few cycles and no division.
+ *
+ * @ingroup	xpcc_comm
+ */
+class LatencyHistogram
+{
+public:
+	static constexpr uint8_t bucketCount = 12;
+
+	LatencyHistogram()
+	{
+		this->reset();
+	}
+
+	void
+	reset()
+	{
+		for (uint32_t& bucket : this->buckets) {
+			bucket = 0;
+		}
+		this->count = 0;
+		this->sum = 0;
+		this->weight = 0;
+		this->maximum = 0;
+	}
+
+	void
+	record(uint16_t milliseconds)
+	{
+		uint8_t bucket = 0;
+		uint16_t value = milliseconds;
+		while (value > 0 and bucket < bucketCount - 1)
+		{
+			value >>= 1;
+			bucket++;
+		}
+		this->buckets[bucket]++;
+
+		this->count++;
+		if (this->sum > UINT32_MAX - milliseconds)
+		{
+			// keeps the average, older latencies just weigh less
+			this->sum >>= 1;
+			this->weight >>= 1;
+		}
+		this->sum += milliseconds;
+		this->weight++;
+		if (milliseconds > this->maximum) {
+			this->maximum = milliseconds;
+		}
+	}
+
+	/// Number of latencies in bucket \p index
+	inline uint32_t
+	getBucket(uint8_t index) const
+	{
+		return this->buckets[index];
+	}
+
+	/// Smallest latency counted in bucket \p index
+	static inline uint16_t
+	getBucketStart(uint8_t index)
+	{
+		return (index == 0) ? 0 : (uint16_t(1) << (index - 1));
+	}
+
+	inline uint32_t
+	getCount() const
+	{
+		return this->count;
+	}
+
+	inline uint16_t
+	getMaximum() const
+	{
+		return this->maximum;
+	}
+
+	/**
+	 * Average latency in milliseconds, rounded down.
+	 *
+	 * The sum is kept in 32 bits to avoid a 64-bit division. Once it
+	 * would overflow, the latencies recorded so far count half.
+	 */
+	inline uint16_t
+	getAverage() const
+	{
+		return (this->weight > 0) ? (this->sum / this->weight) : 0;
+	}
+
+private:
+	uint32_t buckets[bucketCount];
+	uint32_t count;
+	uint32_t sum;
+	uint32_t weight;
+	uint16_t maximum;
+};
+
+} // xpcc namespace
+
+#endif // XPCC__COMMUNICATION_STATISTICS_HPP
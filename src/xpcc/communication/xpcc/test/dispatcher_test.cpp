@@ -193,7 +193,7 @@ DispatcherTest::testInternalActionCallNoParameter()
 	TEST_ASSERT_EQUALS(timeline->events.getFront().source, 2);
 	TEST_ASSERT_EQUALS(timeline->events.getFront().payload.getSize(), 0U);
 	
-	// TODO should it be possible to disable this behavior
+	// mirrored to the backend by default, see testMirroringNone()
 	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 1U);
 }
 
@@ -215,7 +215,7 @@ DispatcherTest::testInternalActionCallUnit16()
 			timeline->events.getFront().payload.get<uint16_t>(),
 			0x1234U);
 	
-	// TODO should it be possible to disable this behavior
+	// mirrored to the backend by default, see testMirroringNone()
 	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 1U);
 }
 
@@ -243,7 +243,7 @@ DispatcherTest::testInternalActionCallDirectResponse()
 	TEST_ASSERT_EQUALS(timeline->events.getFront().source, 1);
 	TEST_ASSERT_EQUALS(timeline->events.getFront().payload.getSize(), 0U);
 	
-	// TODO should it be possible to disable this behavior
+	// mirrored to the backend by default, see testMirroringNone()
 	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
 }
 
@@ -278,7 +278,7 @@ DispatcherTest::testInternalActionCallDelayedResponse()
 	TEST_ASSERT_EQUALS(timeline->events.getFront().source, 1);
 	TEST_ASSERT_EQUALS(timeline->events.getFront().payload.getSize(), 0U);
 	
-	// TODO should it be possible to disable this behavior
+	// mirrored to the backend by default, see testMirroringNone()
 	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
 }
 
@@ -312,7 +312,7 @@ DispatcherTest::testInternalActionCallWithRecall()
 			timeline->events.getFront().payload.get<uint16_t>(),
 			0x4321U);
 	
-	// TODO should it be possible to disable this behavior
+	// mirrored to the backend by default, see testMirroringNone()
 	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
 }
 
@@ -394,7 +394,7 @@ DispatcherTest::testInternalActionBackAndForth()
 	TEST_ASSERT_EQUALS(timeline->events.getFront().source, 1);
 	TEST_ASSERT_EQUALS(timeline->events.getFront().payload.getSize(), 0U);
 	
-	// TODO should it be possible to disable this behavior
+	// mirrored to the backend by default, see testMirroringNone()
 	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 7U);
 }
 
@@ -544,3 +544,616 @@ DispatcherTest::testResponseRetransmission()
 	
 	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 0U);
 }
+
+// ----------------------------------------------------------------------------
+void
+DispatcherTest::testAcknowledgeOutOfOrder()
+{
+	component1->callAction(10, 0xf0);
+	component1->callAction(10, 0xf1);
+	component1->callAction(11, 0xf1);
+	component1->callAction(10, 0xf2);
+	
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 4U);
+	backend->messagesSend.removeAll();
+	
+	// acknowledge only the second and the last request
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 1, 10, 0xf1),
+					xpcc::SmartPointer()));
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 1, 10, 0xf2),
+					xpcc::SmartPointer()));
+	
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 0U);
+	
+	// remaining requests are retransmitted in their original order
+	TestingClock::time += 500;
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 10, 1, 0xf0));
+	TEST_ASSERT_EQUALS(backend->messagesSend.getBack().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 11, 1, 0xf1));
+}
+
+void
+DispatcherTest::testExternalActionCallResponse()
+{
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(10, 0x12, callback);
+	component2->callAction(10, 0x13, callback);
+	
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
+	backend->messagesSend.removeAll();
+	
+	// ACK for the first request
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 2, 10, 0x12),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	
+	// the acknowledged request must not be retransmitted
+	TestingClock::time += 500;
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 1U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 10, 2, 0x13));
+	backend->messagesSend.removeAll();
+	
+	// responses for both requests, the second one without a previous ACK
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::RESPONSE, false, 2, 10, 0x13),
+					xpcc::SmartPointer()));
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::RESPONSE, false, 2, 10, 0x12),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 2U);
+	TEST_ASSERT_TRUE(timeline->events.getFront().type == Timeline::RESPONSE);
+	TEST_ASSERT_EQUALS(timeline->events.getFront().source, 10);
+	
+	// both responses are acknowledged
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
+	backend->messagesSend.removeAll();
+	
+	// nothing is left to be retransmitted
+	TestingClock::time += 500;
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 0U);
+}
+
+// ----------------------------------------------------------------------------
+void
+DispatcherTest::testResponseTimeout()
+{
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(10, 0x12, callback);
+	
+	dispatcher->update();
+	
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 2, 10, 0x12),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 1U);
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 0U);
+	
+	TestingClock::time += xpcc::Dispatcher::responseTimeout - 1;
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 0U);
+	
+	TestingClock::time += 1;
+	dispatcher->update();
+	
+	// callback was notified
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 1U);
+	TEST_ASSERT_TRUE(timeline->events.getFront().type == Timeline::RESPONSE);
+	TEST_ASSERT_EQUALS(timeline->events.getFront().source, 10);
+	
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 0U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().responseTimeouts, 1U);
+	
+	// a late response is ignored
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::RESPONSE, false, 2, 10, 0x12),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 1U);
+}
+
+void
+DispatcherTest::testInternalResponseTimeout()
+{
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(1, 0x13, callback);
+	
+	dispatcher->setResponseTimeout(200);
+	dispatcher->update();
+	
+	// action was delivered, response is delayed
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 1U);
+	timeline->events.removeFront();
+	
+	TestingClock::time += 200;
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 1U);
+	TEST_ASSERT_TRUE(timeline->events.getFront().type == Timeline::RESPONSE);
+	TEST_ASSERT_EQUALS(timeline->events.getFront().source, 1);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().responseTimeouts, 1U);
+}
+
+void
+DispatcherTest::testReducedResponseTimeout()
+{
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(1, 0x13, callback);
+	dispatcher->update();
+	
+	// the second request expires before the first one
+	dispatcher->setResponseTimeout(200);
+	component2->callAction(1, 0x13, callback);
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 2U);
+	timeline->events.removeAll();
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 2U);
+	
+	TestingClock::time += 200;
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 1U);
+	TEST_ASSERT_TRUE(timeline->events.getFront().type == Timeline::RESPONSE);
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 1U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().responseTimeouts, 1U);
+	
+	TestingClock::time += xpcc::Dispatcher::responseTimeout - 200;
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 2U);
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 0U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().responseTimeouts, 2U);
+}
+
+void
+DispatcherTest::testAcknowledgeTimeoutNotification()
+{
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(10, 0x12, callback);
+	
+	dispatcher->update();
+	
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		TEST_ASSERT_EQUALS(timeline->events.getSize(), 0U);
+		
+		TestingClock::time += 500;
+		dispatcher->update();
+	}
+	
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 1U);
+	TEST_ASSERT_EQUALS(timeline->events.getFront().source, 10);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().acknowledgeTimeouts, 1U);
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 0U);
+}
+
+void
+DispatcherTest::testPendingMessageEviction()
+{
+	dispatcher->setMaximumPendingMessages(2);
+	
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(10, 0x12, callback);
+	component2->callAction(11, 0x12, callback);
+	component2->callAction(12, 0x12, callback);
+	
+	dispatcher->update();
+	
+	// all requests are sent, but the oldest one was evicted
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 3U);
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 2U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().evictedMessages, 1U);
+	
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 1U);
+	TEST_ASSERT_EQUALS(timeline->events.getFront().source, 10);
+	
+	// the request to 11 is acknowledged, so it is evicted before the
+	// request to 12 which still waits for the ACK
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 2, 11, 0x12),
+					xpcc::SmartPointer()));
+	component2->callAction(13, 0x12, callback);
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 2U);
+	TEST_ASSERT_EQUALS(timeline->events.getBack().source, 11);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().evictedMessages, 2U);
+}
+
+// ----------------------------------------------------------------------------
+void
+DispatcherTest::testTransmissionOrder()
+{
+	component2->publishEvent(0x20);
+	component2->callAction(10, 0x10);
+	
+	// both requests are answered directly by component 1
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, false, 1, 10, 0x12),
+					xpcc::SmartPointer()));
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, false, 1, 11, 0x12),
+					xpcc::SmartPointer()));
+	
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 6U);
+	
+	// ACKs are sent immediately
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, true, 10, 1, 0x12));
+	backend->messagesSend.removeFront();
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, true, 11, 1, 0x12));
+	backend->messagesSend.removeFront();
+	
+	// followed by the responses in the order they were given
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::RESPONSE, false, 10, 1, 0x12));
+	backend->messagesSend.removeFront();
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::RESPONSE, false, 11, 1, 0x12));
+	backend->messagesSend.removeFront();
+	
+	// requests are sent before events
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 10, 2, 0x10));
+	backend->messagesSend.removeFront();
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 2, 0x20));
+}
+
+void
+DispatcherTest::testManyPacketsPerUpdate()
+{
+	// more packets than are exchanged with the backend in one batch
+	const uint8_t count = 3 * xpcc::Dispatcher::packetBatchSize + 1;
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		backend->messagesToReceive.append(
+				Message(xpcc::Header(xpcc::Header::Type::REQUEST, false, 1, 10, 0x12),
+						xpcc::SmartPointer()));
+	}
+	
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesToReceive.getSize(), 0U);
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), count);
+	
+	// all acknowledges are sent before the responses
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U * count);
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		TEST_ASSERT_TRUE(backend->messagesSend.getFront().header.isAcknowledge);
+		backend->messagesSend.removeFront();
+	}
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+				xpcc::Header(xpcc::Header::Type::RESPONSE, false, 10, 1, 0x12));
+		backend->messagesSend.removeFront();
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+DispatcherTest::testWaitForActivity()
+{
+	// nothing to do, the whole timeout is passed to the backend
+	TEST_ASSERT_FALSE(dispatcher->waitForActivity(1000));
+	TEST_ASSERT_EQUALS(backend->waitTimeout, 1000U);
+	
+	// messages waiting for transmission are handled right away
+	backend->waitTimeout = 0;
+	component2->callAction(10, 0x10);
+	TEST_ASSERT_TRUE(dispatcher->waitForActivity(1000));
+	TEST_ASSERT_EQUALS(backend->waitTimeout, 0U);
+	
+	// wake up for the retransmission
+	dispatcher->update();
+	backend->messagesSend.removeAll();
+	
+	TestingClock::time += 200;
+	TEST_ASSERT_FALSE(dispatcher->waitForActivity(1000));
+	TEST_ASSERT_EQUALS(backend->waitTimeout, 300U);
+	
+	TEST_ASSERT_FALSE(dispatcher->waitForActivity(100));
+	TEST_ASSERT_EQUALS(backend->waitTimeout, 100U);
+	
+	TestingClock::time += 300;
+	TEST_ASSERT_TRUE(dispatcher->waitForActivity(1000));
+	
+	dispatcher->run(1000);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 1U);
+	
+	// received packets
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 2, 10, 0x10),
+					xpcc::SmartPointer()));
+	TEST_ASSERT_TRUE(dispatcher->waitForActivity(1000));
+	
+	dispatcher->run(1000);
+	TEST_ASSERT_FALSE(dispatcher->waitForActivity(1000));
+	TEST_ASSERT_EQUALS(backend->waitTimeout, 1000U);
+}
+
+// ----------------------------------------------------------------------------
+void
+DispatcherTest::testMirroringNone()
+{
+	dispatcher->setMirroring(xpcc::Dispatcher::Mirroring::None);
+	TEST_ASSERT_TRUE(dispatcher->getMirroring() == xpcc::Dispatcher::Mirroring::None);
+	
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(1, 0x12, callback);
+	
+	dispatcher->update();
+	dispatcher->update();
+	
+	// action and response were delivered without using the backend
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 2U);
+	TEST_ASSERT_TRUE(backend->messagesSend.isEmpty());
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 0U);
+	
+	// events are still sent for other boards
+	component2->publishEvent(0x21, uint32_t(0x12345678));
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 3U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 1U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header.destination, 0);
+	
+	// messages for other boards are not affected
+	component2->callAction(10, 0x10);
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
+}
+
+void
+DispatcherTest::testMirroringSampled()
+{
+	dispatcher->setMirroring(xpcc::Dispatcher::Mirroring::Sampled, 3);
+	
+	for (uint8_t i = 0; i < 7; ++i)
+	{
+		component2->callAction(1, 0x10);
+		dispatcher->update();
+	}
+	
+	// every third action is mirrored
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 7U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 1, 2, 0x10));
+	
+	dispatcher->setMirroring(xpcc::Dispatcher::Mirroring::All);
+	component2->callAction(1, 0x10);
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 3U);
+}
+
+void
+DispatcherTest::testMirroringTap()
+{
+	FakeBackend tap;
+	dispatcher->setTapBackend(&tap);
+	TEST_ASSERT_TRUE(dispatcher->getMirroring() == xpcc::Dispatcher::Mirroring::Tap);
+	
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(1, 0x12, callback);
+	dispatcher->update();
+	dispatcher->update();
+	
+	// local messages only go to the tap
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 2U);
+	TEST_ASSERT_TRUE(backend->messagesSend.isEmpty());
+	TEST_ASSERT_EQUALS(tap.messagesSend.getSize(), 2U);
+	TEST_ASSERT_EQUALS(tap.messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 1, 2, 0x12));
+	
+	// packets received by the tap are ignored
+	tap.messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, false, 1, 10, 0x10),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 2U);
+	
+	dispatcher->setTapBackend(nullptr);
+	TEST_ASSERT_TRUE(dispatcher->getMirroring() == xpcc::Dispatcher::Mirroring::None);
+	component2->callAction(1, 0x10);
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(tap.messagesSend.getSize(), 2U);
+	TEST_ASSERT_TRUE(backend->messagesSend.isEmpty());
+}
+
+// ----------------------------------------------------------------------------
+void
+DispatcherTest::testStatisticsCounters()
+{
+#if XPCC_COMMUNICATION_STATISTICS
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(10, 0x12, callback);
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().sentPackets, 1U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().peakPendingMessages, 1U);
+	TEST_ASSERT_EQUALS(dispatcher->getComponentStatistics(2).sent, 1U);
+	
+	TestingClock::time += 20;
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 2, 10, 0x12),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	
+	TestingClock::time += 30;
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::RESPONSE, false, 2, 10, 0x12),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 1U);
+	
+	const xpcc::Dispatcher::Statistics& statistics = dispatcher->getStatistics();
+	TEST_ASSERT_EQUALS(statistics.receivedPackets, 2U);
+	// request and the acknowledge of the response
+	TEST_ASSERT_EQUALS(statistics.sentPackets, 2U);
+	TEST_ASSERT_EQUALS(statistics.retransmissions, 0U);
+	
+	TEST_ASSERT_EQUALS(statistics.acknowledgeLatency.getCount(), 1U);
+	TEST_ASSERT_EQUALS(statistics.acknowledgeLatency.getMaximum(), 20U);
+	TEST_ASSERT_EQUALS(statistics.acknowledgeLatency.getBucket(5), 1U);
+	TEST_ASSERT_EQUALS(statistics.responseLatency.getCount(), 1U);
+	TEST_ASSERT_EQUALS(statistics.responseLatency.getAverage(), 50U);
+	
+	TEST_ASSERT_EQUALS(dispatcher->getComponentStatistics(2).received, 1U);
+	TEST_ASSERT_EQUALS(dispatcher->getComponentStatistics(2).dropped, 0U);
+	
+	// never seen
+	TEST_ASSERT_EQUALS(dispatcher->getComponentStatistics(7).sent, 0U);
+	
+	dispatcher->resetStatistics();
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().sentPackets, 0U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().responseLatency.getCount(), 0U);
+	TEST_ASSERT_EQUALS(dispatcher->getComponentStatistics(2).sent, 0U);
+#endif
+}
+
+void
+DispatcherTest::testStatisticsRetransmission()
+{
+#if XPCC_COMMUNICATION_STATISTICS
+	component1->callAction(10, 0xf3);
+	dispatcher->update();
+	
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		TestingClock::time += 500;
+		dispatcher->update();
+	}
+	
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().sentPackets, 3U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().retransmissions, 2U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().acknowledgeTimeouts, 1U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().acknowledgeLatency.getCount(), 0U);
+	
+	xpcc::Dispatcher::ComponentStatistics counters = dispatcher->getComponentStatistics(1);
+	TEST_ASSERT_EQUALS(counters.sent, 1U);
+	TEST_ASSERT_EQUALS(counters.retransmissions, 2U);
+	TEST_ASSERT_EQUALS(counters.dropped, 1U);
+#endif
+}
+
+void
+DispatcherTest::testStatisticsLocalMessages()
+{
+#if XPCC_COMMUNICATION_STATISTICS
+	dispatcher->setMirroring(xpcc::Dispatcher::Mirroring::None);
+	
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(1, 0x13, callback);
+	dispatcher->update();
+	
+	TestingClock::time += 40;
+	component1->update();
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 2U);
+	
+	const xpcc::Dispatcher::Statistics& statistics = dispatcher->getStatistics();
+	TEST_ASSERT_EQUALS(statistics.sentPackets, 0U);
+	TEST_ASSERT_EQUALS(statistics.localMessages, 2U);
+	TEST_ASSERT_EQUALS(statistics.responseLatency.getCount(), 1U);
+	TEST_ASSERT_EQUALS(statistics.responseLatency.getMaximum(), 40U);
+	
+	TEST_ASSERT_EQUALS(dispatcher->getComponentStatistics(1).received, 1U);
+	TEST_ASSERT_EQUALS(dispatcher->getComponentStatistics(1).sent, 1U);
+	TEST_ASSERT_EQUALS(dispatcher->getComponentStatistics(2).received, 1U);
+	TEST_ASSERT_EQUALS(dispatcher->getComponentStatistics(2).sent, 1U);
+#endif
+}
+
+void
+DispatcherTest::testStatisticsEvent()
+{
+#if XPCC_COMMUNICATION_STATISTICS
+	dispatcher->setStatisticsEvent(1, 0x40, 1000);
+	
+	dispatcher->update();
+	TEST_ASSERT_TRUE(backend->messagesSend.isEmpty());
+	
+	// an idle dispatcher wakes up in time for the report
+	TestingClock::time += 400;
+	TEST_ASSERT_FALSE(dispatcher->waitForActivity(5000));
+	TEST_ASSERT_EQUALS(backend->waitTimeout, 600U);
+	
+	TestingClock::time += 600;
+	TEST_ASSERT_TRUE(dispatcher->waitForActivity(5000));
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 1U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 1, 0x40));
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().payload.getSize(),
+			sizeof(xpcc::Dispatcher::StatisticsReport));
+	
+	// the report is created before the event itself is sent
+	xpcc::Dispatcher::StatisticsReport report =
+			backend->messagesSend.getFront().payload.get<xpcc::Dispatcher::StatisticsReport>();
+	uint32_t sentPackets = report.sentPackets;
+	TEST_ASSERT_EQUALS(sentPackets, 0U);
+	TEST_ASSERT_EQUALS(dispatcher->getStatistics().sentPackets, 1U);
+	backend->messagesSend.removeAll();
+	
+	TestingClock::time += 1000;
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 1U);
+	report = backend->messagesSend.getFront().payload.get<xpcc::Dispatcher::StatisticsReport>();
+	sentPackets = report.sentPackets;
+	TEST_ASSERT_EQUALS(sentPackets, 1U);
+	backend->messagesSend.removeAll();
+	
+	dispatcher->setStatisticsEvent(1, 0x40, 0);
+	TestingClock::time += 1000;
+	dispatcher->update();
+	TEST_ASSERT_TRUE(backend->messagesSend.isEmpty());
+#endif
+}
+
+void
+DispatcherTest::testLatencyAverage()
+{
+#if XPCC_COMMUNICATION_STATISTICS
+	xpcc::LatencyHistogram histogram;
+	TEST_ASSERT_EQUALS(histogram.getAverage(), 0U);
+	
+	histogram.record(10);
+	histogram.record(21);
+	TEST_ASSERT_EQUALS(histogram.getAverage(), 15U);
+	
+	// the sum of the latencies exceeds 32 bits
+	histogram.reset();
+	for (uint32_t i = 0; i < 100000; ++i) {
+		histogram.record(60000);
+	}
+	TEST_ASSERT_EQUALS(histogram.getCount(), 100000U);
+	TEST_ASSERT_EQUALS(histogram.getAverage(), 60000U);
+	TEST_ASSERT_EQUALS(histogram.getMaximum(), 60000U);
+	TEST_ASSERT_EQUALS(histogram.getBucket(xpcc::LatencyHistogram::bucketCount - 1), 100000U);
+#endif
+}
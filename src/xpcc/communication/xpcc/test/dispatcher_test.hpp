@@ -127,6 +127,84 @@ public:
 	void
 	testResponseRetransmission();
 	
+	/*
+	 * Step 5:
+	 * Check matching of ACKs and responses with many outstanding messages
+	 */
+	void
+	testAcknowledgeOutOfOrder();
+	
+	void
+	testExternalActionCallResponse();
+	
+	/*
+	 * Step 6:
+	 * Check timeouts and eviction of requests waiting for a response
+	 */
+	void
+	testResponseTimeout();
+	
+	void
+	testInternalResponseTimeout();
+	
+	void
+	testReducedResponseTimeout();
+	
+	void
+	testAcknowledgeTimeoutNotification();
+	
+	void
+	testPendingMessageEviction();
+	
+	/*
+	 * Step 7:
+	 * Check the transmission order of the different message classes
+	 */
+	void
+	testTransmissionOrder();
+	
+	void
+	testManyPacketsPerUpdate();
+	
+	/*
+	 * Step 8:
+	 * Check waiting for activity
+	 */
+	void
+	testWaitForActivity();
+	
+	/*
+	 * Step 9:
+	 * Check mirroring of messages between local components
+	 */
+	void
+	testMirroringNone();
+	
+	void
+	testMirroringSampled();
+	
+	void
+	testMirroringTap();
+	
+	/*
+	 * Step 10:
+	 * Check the message statistics
+	 */
+	void
+	testStatisticsCounters();
+	
+	void
+	testStatisticsRetransmission();
+	
+	void
+	testStatisticsLocalMessages();
+	
+	void
+	testStatisticsEvent();
+	
+	void
+	testLatencyAverage();
+	
 private:
 	xpcc::Dispatcher *dispatcher;
 	FakeBackend *backend;
@@ -0,0 +1,202 @@
+// coding: utf-8
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/architecture/detect.hpp>
+
+#include "dynamic_postman_test.hpp"
+
+// The DynamicPostman is only available on hosted targets
+#ifdef XPCC__OS_HOSTED
+
+#include <xpcc/communication/xpcc/postman/dynamic_postman.hpp>
+
+namespace
+{
+	class Receiver : public xpcc::Communicatable
+	{
+	public:
+		void
+		event(const xpcc::Header& header)
+		{
+			events++;
+			lastIdentifier = header.packetIdentifier;
+		}
+
+		void
+		eventUint16(const xpcc::Header& header, const uint16_t& value)
+		{
+			events++;
+			lastIdentifier = header.packetIdentifier;
+			lastValue = value;
+		}
+
+		void
+		action(const xpcc::ResponseHandle& handle)
+		{
+			actions++;
+			lastSource = handle.getDestination();
+		}
+
+		void
+		actionUint16(const xpcc::ResponseHandle& handle, const uint16_t& value)
+		{
+			actions++;
+			lastSource = handle.getDestination();
+			lastValue = value;
+		}
+
+		uint8_t events = 0;
+		uint8_t actions = 0;
+		uint8_t lastIdentifier = 0;
+		uint8_t lastSource = 0;
+		uint16_t lastValue = 0;
+	};
+
+	// callback objects need not be components
+	class Registrar
+	{
+	public:
+		Registrar(xpcc::DynamicPostman& postman, Receiver& receiver) :
+			postman(postman), receiver(receiver)
+		{
+		}
+
+		void
+		event(const xpcc::Header&)
+		{
+			if (calls++ == 0)
+			{
+				for (uint8_t i = 0; i < 16; ++i) {
+					postman.registerEventListener(0x20, &receiver, &Receiver::event);
+				}
+			}
+		}
+
+		xpcc::DynamicPostman& postman;
+		Receiver& receiver;
+		uint8_t calls = 0;
+	};
+}
+
+#endif
+
+void
+DynamicPostmanTest::testEvents()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::DynamicPostman postman;
+	Receiver first;
+	Receiver second;
+	
+	postman.registerEventListener(0x20, &first, &Receiver::event);
+	postman.registerEventListener(0x20, &second, &Receiver::event);
+	postman.registerEventListener(0x21, &second, &Receiver::eventUint16);
+	
+	TEST_ASSERT_TRUE(postman.isEventSubscribed(0x20));
+	TEST_ASSERT_TRUE(postman.isEventSubscribed(0x21));
+	TEST_ASSERT_FALSE(postman.isEventSubscribed(0x22));
+	
+	TEST_ASSERT_EQUALS(postman.deliverPacket(
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 10, 0x20),
+			xpcc::SmartPointer()), xpcc::Postman::OK);
+	
+	// all listeners of an event are called
+	TEST_ASSERT_EQUALS(first.events, 1);
+	TEST_ASSERT_EQUALS(second.events, 1);
+	TEST_ASSERT_EQUALS(second.lastIdentifier, 0x20);
+	
+	uint16_t value = 0x1234;
+	TEST_ASSERT_EQUALS(postman.deliverPacket(
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 10, 0x21),
+			xpcc::SmartPointer(&value)), xpcc::Postman::OK);
+	
+	TEST_ASSERT_EQUALS(first.events, 1);
+	TEST_ASSERT_EQUALS(second.events, 2);
+	TEST_ASSERT_EQUALS(second.lastIdentifier, 0x21);
+	TEST_ASSERT_EQUALS(second.lastValue, 0x1234);
+	
+	TEST_ASSERT_EQUALS(postman.deliverPacket(
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 10, 0x22),
+			xpcc::SmartPointer()), xpcc::Postman::NO_EVENT);
+#endif
+}
+
+void
+DynamicPostmanTest::testActions()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::DynamicPostman postman;
+	Receiver receiver;
+	
+	postman.registerActionHandler(1, 0x10, &receiver, &Receiver::action);
+	postman.registerActionHandler(1, 0x11, &receiver, &Receiver::actionUint16);
+	
+	TEST_ASSERT_TRUE(postman.isComponentAvailable(1));
+	TEST_ASSERT_FALSE(postman.isComponentAvailable(2));
+	
+	TEST_ASSERT_EQUALS(postman.deliverPacket(
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 1, 10, 0x10),
+			xpcc::SmartPointer()), xpcc::Postman::OK);
+	TEST_ASSERT_EQUALS(receiver.actions, 1);
+	TEST_ASSERT_EQUALS(receiver.lastSource, 10);
+	
+	uint16_t value = 0x4321;
+	TEST_ASSERT_EQUALS(postman.deliverPacket(
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 1, 11, 0x11),
+			xpcc::SmartPointer(&value)), xpcc::Postman::OK);
+	TEST_ASSERT_EQUALS(receiver.actions, 2);
+	TEST_ASSERT_EQUALS(receiver.lastSource, 11);
+	TEST_ASSERT_EQUALS(receiver.lastValue, 0x4321);
+	
+	TEST_ASSERT_EQUALS(postman.deliverPacket(
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 1, 10, 0x12),
+			xpcc::SmartPointer()), xpcc::Postman::NO_ACTION);
+	TEST_ASSERT_EQUALS(receiver.actions, 2);
+#endif
+}
+
+void
+DynamicPostmanTest::testUnknownDestination()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::DynamicPostman postman;
+	
+	TEST_ASSERT_FALSE(postman.isComponentAvailable(0));
+	TEST_ASSERT_FALSE(postman.isComponentAvailable(255));
+	
+	TEST_ASSERT_EQUALS(postman.deliverPacket(
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 255, 10, 0x10),
+			xpcc::SmartPointer()), xpcc::Postman::NO_COMPONENT);
+#endif
+}
+
+void
+DynamicPostmanTest::testRegisterWhileDelivering()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::DynamicPostman postman;
+	Receiver receiver;
+	Registrar registrar(postman, receiver);
+	
+	postman.registerEventListener(0x20, &registrar, &Registrar::event);
+	
+	// the listeners registered by the first one are called as well
+	TEST_ASSERT_EQUALS(postman.deliverPacket(
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 10, 0x20),
+			xpcc::SmartPointer()), xpcc::Postman::OK);
+	TEST_ASSERT_EQUALS(registrar.calls, 1);
+	TEST_ASSERT_EQUALS(receiver.events, 16);
+	
+	TEST_ASSERT_EQUALS(postman.deliverPacket(
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 10, 0x20),
+			xpcc::SmartPointer()), xpcc::Postman::OK);
+	TEST_ASSERT_EQUALS(registrar.calls, 2);
+	TEST_ASSERT_EQUALS(receiver.events, 32);
+#endif
+}
@@ -0,0 +1,31 @@
+// coding: utf-8
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef DYNAMIC_POSTMAN_TEST_HPP
+#define DYNAMIC_POSTMAN_TEST_HPP
+
+#include <unittest/testsuite.hpp>
+
+class DynamicPostmanTest : public unittest::TestSuite
+{
+public:
+	void
+	testEvents();
+	
+	void
+	testActions();
+	
+	void
+	testUnknownDestination();
+	
+	void
+	testRegisterWhileDelivering();
+};
+
+#endif // DYNAMIC_POSTMAN_TEST_HPP
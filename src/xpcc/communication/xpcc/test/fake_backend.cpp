@@ -67,3 +67,10 @@ FakeBackend::dropPacket()
 {
 	this->messagesToReceive.removeFront();
 }
+
+bool
+FakeBackend::waitForPacket(uint16_t timeout)
+{
+	this->waitTimeout = timeout;
+	return this->isPacketAvailable();
+}
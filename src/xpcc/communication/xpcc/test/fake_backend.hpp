@@ -58,14 +58,26 @@ public:
 	
 	virtual void
 	dropPacket();
+	
+	virtual bool
+	waitForPacket(uint16_t timeout);
 
 public:
+	FakeBackend() :
+		waitTimeout(0)
+	{
+	}
+	
+
 	/// Messages send by the dispatcher via sendPacket
 	xpcc::LinkedList<Message> messagesSend;
 	
 	/// Messages which should be received. isPacketAvailable(), getPacketHeader(),
 	/// getPacketPayload() and dropPacket() operate on this list.
 	xpcc::LinkedList<Message> messagesToReceive;
+	
+	/// Timeout given to the last call of waitForPacket()
+	uint16_t waitTimeout;
 };
 
 #endif
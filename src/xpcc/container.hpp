@@ -56,6 +56,11 @@ Sequence containers:
  - xpcc::DoublyLinkedList
  - xpcc::BoundedDeque
 
+Intrusive containers, which link objects containing their own hook instead of
+allocating a node and copying the object:
+ - xpcc::IntrusiveLinkedList
+ - xpcc::IntrusiveDoublyLinkedList
+
 Container adaptors:
  - xpcc::Queue
  - xpcc::Stack
@@ -116,6 +121,8 @@ every one of it, only a subset which is sufficient for the container.
 
 #include "container/linked_list.hpp"
 #include "container/doubly_linked_list.hpp"
+#include "container/intrusive_linked_list.hpp"
+#include "container/intrusive_doubly_linked_list.hpp"
 
 #include "container/dynamic_array.hpp"
 
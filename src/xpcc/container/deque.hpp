@@ -32,6 +32,7 @@
 #define	XPCC__DEQUE_HPP
 
 #include <cstddef>
+#include <algorithm>
 
 #include <stdint.h>
 #include <xpcc/utils/template_metaprogramming.hpp>
@@ -199,6 +200,70 @@ namespace xpcc
 		
 		void
 		removeFront();
+		
+		/**
+		 * \brief	Append up to \p count items to the back
+		 * 
+		 * The items are copied in at most two blocks instead of one by one.
+		 * 
+		 * \return	Number of appended items, less than \p count if the
+		 * 			deque became full
+		 */
+		std::size_t
+		append(const T* values, std::size_t count);
+		
+		/**
+		 * \brief	Copy up to \p count items from the front to \p values
+		 * 			and remove them
+		 * 
+		 * \return	Number of removed items
+		 */
+		std::size_t
+		removeFront(T* values, std::size_t count);
+		
+		/**
+		 * \brief	Largest block of items starting at the front, which are
+		 * 			stored contiguously
+		 * 
+		 * Together with commitRead() the items can be processed in place,
+		 * for example with memcpy() or by a DMA transfer:
+		 * 
+		 * \code
+		 * std::size_t length;
+		 * const uint8_t *data = deque.getReadSpan(length);
+		 * length = Uart::write(data, length);
+		 * deque.commitRead(length);
+		 * \endcode
+		 * 
+		 * The span ends at the end of the internal buffer, the remaining
+		 * items are available by a second call after commitRead().
+		 * 
+		 * \param[out]	length	Number of items in the span, zero if empty
+		 */
+		inline T*
+		getReadSpan(std::size_t& length);
+		
+		inline const T*
+		getReadSpan(std::size_t& length) const;
+		
+		/// Remove \p count items from the front, at most the length of the read span
+		void
+		commitRead(std::size_t count);
+		
+		/**
+		 * \brief	Largest block of free space behind the back, which is
+		 * 			stored contiguously
+		 * 
+		 * Fill the span and call commitWrite() to append the items.
+		 * 
+		 * \param[out]	length	Number of free items in the span, zero if full
+		 */
+		inline T*
+		getWriteSpan(std::size_t& length);
+		
+		/// Append \p count items written to the write span
+		void
+		commitWrite(std::size_t count);
 	
 	public:
 		/**
@@ -308,6 +308,98 @@ xpcc::BoundedDeque<T, N>::removeFront()
 
 // ----------------------------------------------------------------------------
 
+template<typename T, std::size_t N>
+std::size_t
+xpcc::BoundedDeque<T, N>::append(const T* values, std::size_t count)
+{
+	std::size_t appended = 0;
+	std::size_t length;
+	// at most twice: up to the end of the buffer and from its start
+	while (appended < count)
+	{
+		T *span = this->getWriteSpan(length);
+		if (length == 0) {
+			break;
+		}
+		length = std::min(length, count - appended);
+		std::copy(values + appended, values + appended + length, span);
+		this->commitWrite(length);
+		appended += length;
+	}
+	return appended;
+}
+
+template<typename T, std::size_t N>
+std::size_t
+xpcc::BoundedDeque<T, N>::removeFront(T* values, std::size_t count)
+{
+	std::size_t removed = 0;
+	std::size_t length;
+	while (removed < count)
+	{
+		const T *span = this->getReadSpan(length);
+		if (length == 0) {
+			break;
+		}
+		length = std::min(length, count - removed);
+		std::copy(span, span + length, values + removed);
+		this->commitRead(length);
+		removed += length;
+	}
+	return removed;
+}
+
+template<typename T, std::size_t N>
+T*
+xpcc::BoundedDeque<T, N>::getReadSpan(std::size_t& length)
+{
+	return const_cast<T*>(static_cast<const BoundedDeque*>(this)->getReadSpan(length));
+}
+
+template<typename T, std::size_t N>
+const T*
+xpcc::BoundedDeque<T, N>::getReadSpan(std::size_t& length) const
+{
+	length = std::min<std::size_t>(this->size, N - this->tail);
+	return &this->buffer[this->tail];
+}
+
+template<typename T, std::size_t N>
+void
+xpcc::BoundedDeque<T, N>::commitRead(std::size_t count)
+{
+	std::size_t tail = this->tail + count;
+	if (tail >= N) {
+		tail -= N;
+	}
+	this->tail = tail;
+	this->size -= count;
+}
+
+template<typename T, std::size_t N>
+T*
+xpcc::BoundedDeque<T, N>::getWriteSpan(std::size_t& length)
+{
+	// the head points to the last item, the free space starts behind it
+	const std::size_t start = (this->head >= (N - 1)) ? 0 : (this->head + 1);
+	length = std::min<std::size_t>(N - this->size, N - start);
+	return &this->buffer[start];
+}
+
+template<typename T, std::size_t N>
+void
+xpcc::BoundedDeque<T, N>::commitWrite(std::size_t count)
+{
+	std::size_t head = this->head + count;
+	if (head >= N) {
+		head -= N;
+	}
+	this->head = head;
+	this->size += count;
+}
+
+// ----------------------------------------------------------------------------
+
 template<typename T, std::size_t N>
 xpcc::BoundedDeque<T, N>::const_iterator::const_iterator() :
 	index(0), parent(0), count(0)
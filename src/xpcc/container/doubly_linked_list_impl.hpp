@@ -77,6 +77,10 @@ xpcc::DoublyLinkedList<T, Allocator>::prepend(const T& value)
 {
 	// allocate memory for the new node and copy the value into it
 	Node *node = this->nodeAllocator.allocate(1);
+	if (node == nullptr) {
+		// the allocator is exhausted
+		return false;
+	}
 	Allocator::construct(&node->value, value);
 	
 	// hook the node into the list
@@ -97,11 +101,15 @@ xpcc::DoublyLinkedList<T, Allocator>::prepend(const T& value)
 }
 
 template <typename T, typename Allocator>
-void
+bool
 xpcc::DoublyLinkedList<T, Allocator>::append(const T& value)
 {
 	// allocate memory for the new node and copy the value into it
 	Node *node = this->nodeAllocator.allocate(1);
+	if (node == nullptr) {
+		// the allocator is exhausted
+		return false;
+	}
 	Allocator::construct(&node->value, value);
 	
 	// hook the node into the list
@@ -117,6 +125,8 @@ xpcc::DoublyLinkedList<T, Allocator>::append(const T& value)
 		this->back->next = node;
 	}
 	this->back = node;
+	
+	return true;
 }
 
 // ----------------------------------------------------------------------------
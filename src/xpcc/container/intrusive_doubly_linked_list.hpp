@@ -0,0 +1,238 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__INTRUSIVE_DOUBLY_LINKED_LIST_HPP
+#define	XPCC__INTRUSIVE_DOUBLY_LINKED_LIST_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace xpcc
+{
+	/**
+	 * \brief	Links of an object in an IntrusiveDoublyLinkedList
+	 *
+	 * See IntrusiveLinkedListHook, copying or moving an object doesn't
+	 * copy its links.
+	 *
+	 * \ingroup	container
+	 */
+	template <typename Tag = void>
+	class IntrusiveDoublyLinkedListHook
+	{
+	public:
+		IntrusiveDoublyLinkedListHook() :
+			next(nullptr), previous(nullptr)
+		{
+		}
+
+		IntrusiveDoublyLinkedListHook(const IntrusiveDoublyLinkedListHook&) :
+			next(nullptr), previous(nullptr)
+		{
+		}
+
+		IntrusiveDoublyLinkedListHook&
+		operator = (const IntrusiveDoublyLinkedListHook&)
+		{
+			return *this;
+		}
+
+	private:
+		template <typename T, typename U>
+		friend class IntrusiveDoublyLinkedList;
+
+		IntrusiveDoublyLinkedListHook *next;
+		IntrusiveDoublyLinkedListHook *previous;
+	};
+
+	/**
+	 * \brief	Doubly-linked list of objects which contain their own links
+	 *
+	 * Like xpcc::IntrusiveLinkedList, but every object can be removed
+	 * in constant time by reference, no matter where it is in the list:
+	 *
+	 * @code
+	 * struct Request : public xpcc::IntrusiveDoublyLinkedListHook<>
+	 * {
+	 *     uint8_t id;
+	 * };
+	 *
+	 * xpcc::IntrusiveDoublyLinkedList<Request> pending;
+	 * pending.append(request);
+	 * ...
+	 * pending.remove(request);
+	 * @endcode
+	 *
+	 * \tparam	T	type of list entries, derived from IntrusiveDoublyLinkedListHook<Tag>
+	 *
+	 * \ingroup	container
+	 */
+	template <typename T, typename Tag = void>
+	class IntrusiveDoublyLinkedList
+	{
+	public:
+		typedef IntrusiveDoublyLinkedListHook<Tag> Hook;
+		typedef std::size_t Size;
+
+	public:
+		IntrusiveDoublyLinkedList();
+
+		/// Take over all objects of \p other, which is empty afterwards
+		IntrusiveDoublyLinkedList(IntrusiveDoublyLinkedList&& other);
+
+		IntrusiveDoublyLinkedList&
+		operator = (IntrusiveDoublyLinkedList&& other);
+
+		IntrusiveDoublyLinkedList(const IntrusiveDoublyLinkedList&) = delete;
+
+		IntrusiveDoublyLinkedList&
+		operator = (const IntrusiveDoublyLinkedList&) = delete;
+
+		inline bool
+		isEmpty() const;
+
+		/// Number of objects in the list, takes constant time
+		inline Size
+		getSize() const;
+
+		/// Insert in front
+		void
+		prepend(T& item);
+
+		/// Insert at the end of the list
+		void
+		append(T& item);
+
+		/// Insert \p item behind \p position, which must be part of the list
+		void
+		insertAfter(T& position, T& item);
+
+		/// Insert \p item in front of \p position, which must be part of the list
+		void
+		insertBefore(T& position, T& item);
+
+		/// Remove \p item, which must be part of the list
+		void
+		remove(T& item);
+
+		/// Remove and return the first object, \c nullptr if the list is empty
+		T*
+		removeFront();
+
+		/// Remove and return the last object, \c nullptr if the list is empty
+		T*
+		removeBack();
+
+		/// Unlink all objects
+		void
+		removeAll();
+
+		/// First object, \c nullptr if the list is empty
+		inline T*
+		getFront() const;
+
+		/// Last object, \c nullptr if the list is empty
+		inline T*
+		getBack() const;
+
+		/// Object behind \p item, \c nullptr if \p item is the last one
+		static inline T*
+		getNext(const T* item);
+
+		/// Object in front of \p item, \c nullptr if \p item is the first one
+		static inline T*
+		getPrevious(const T* item);
+
+	public:
+		/// Bidirectional iterator
+		class iterator
+		{
+			friend class IntrusiveDoublyLinkedList;
+
+		public:
+			iterator() :
+				node(nullptr)
+			{
+			}
+
+			iterator&
+			operator ++ ()
+			{
+				this->node = this->node->next;
+				return *this;
+			}
+
+			iterator&
+			operator -- ()
+			{
+				this->node = this->node->previous;
+				return *this;
+			}
+
+			bool
+			operator == (const iterator& other) const
+			{
+				return (this->node == other.node);
+			}
+
+			bool
+			operator != (const iterator& other) const
+			{
+				return (this->node != other.node);
+			}
+
+			T&
+			operator * () const
+			{
+				return *static_cast<T *>(this->node);
+			}
+
+			T*
+			operator -> () const
+			{
+				return static_cast<T *>(this->node);
+			}
+
+		private:
+			iterator(Hook *node) :
+				node(node)
+			{
+			}
+
+			Hook *node;
+		};
+
+		inline iterator
+		begin() const
+		{
+			return iterator(this->front);
+		}
+
+		inline iterator
+		end() const
+		{
+			return iterator(nullptr);
+		}
+
+	private:
+		static inline T*
+		toItem(Hook *node)
+		{
+			return static_cast<T *>(node);
+		}
+
+		Hook *front;
+		Hook *back;
+		Size size;
+	};
+}
+
+#include "intrusive_doubly_linked_list_impl.hpp"
+
+#endif	// XPCC__INTRUSIVE_DOUBLY_LINKED_LIST_HPP
@@ -0,0 +1,215 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__INTRUSIVE_DOUBLY_LINKED_LIST_HPP
+	#error	"Don't include this file directly, use 'intrusive_doubly_linked_list.hpp' instead"
+#endif
+
+// ----------------------------------------------------------------------------
+template <typename T, typename Tag>
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::IntrusiveDoublyLinkedList() :
+	front(nullptr), back(nullptr), size(0)
+{
+}
+
+template <typename T, typename Tag>
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::IntrusiveDoublyLinkedList(
+		IntrusiveDoublyLinkedList&& other) :
+	front(other.front), back(other.back), size(other.size)
+{
+	other.removeAll();
+}
+
+template <typename T, typename Tag>
+xpcc::IntrusiveDoublyLinkedList<T, Tag>&
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::operator = (IntrusiveDoublyLinkedList&& other)
+{
+	if (this != &other)
+	{
+		this->front = other.front;
+		this->back = other.back;
+		this->size = other.size;
+		other.removeAll();
+	}
+	return *this;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, typename Tag>
+bool
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::isEmpty() const
+{
+	return (this->front == nullptr);
+}
+
+template <typename T, typename Tag>
+typename xpcc::IntrusiveDoublyLinkedList<T, Tag>::Size
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::getSize() const
+{
+	return this->size;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::prepend(T& item)
+{
+	Hook *node = &item;
+	node->next = this->front;
+	node->previous = nullptr;
+	if (this->front == nullptr) {
+		// first entry in the list
+		this->back = node;
+	}
+	else {
+		this->front->previous = node;
+	}
+	this->front = node;
+	this->size++;
+}
+
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::append(T& item)
+{
+	Hook *node = &item;
+	node->next = nullptr;
+	node->previous = this->back;
+	if (this->back == nullptr) {
+		// first entry in the list
+		this->front = node;
+	}
+	else {
+		this->back->next = node;
+	}
+	this->back = node;
+	this->size++;
+}
+
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::insertAfter(T& position, T& item)
+{
+	Hook *previous = &position;
+	Hook *node = &item;
+	node->previous = previous;
+	node->next = previous->next;
+	if (previous->next == nullptr) {
+		this->back = node;
+	}
+	else {
+		previous->next->previous = node;
+	}
+	previous->next = node;
+	this->size++;
+}
+
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::insertBefore(T& position, T& item)
+{
+	Hook *next = &position;
+	Hook *node = &item;
+	node->next = next;
+	node->previous = next->previous;
+	if (next->previous == nullptr) {
+		this->front = node;
+	}
+	else {
+		next->previous->next = node;
+	}
+	next->previous = node;
+	this->size++;
+}
+
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::remove(T& item)
+{
+	Hook *node = &item;
+	if (node->previous == nullptr) {
+		this->front = node->next;
+	}
+	else {
+		node->previous->next = node->next;
+	}
+
+	if (node->next == nullptr) {
+		this->back = node->previous;
+	}
+	else {
+		node->next->previous = node->previous;
+	}
+
+	node->next = nullptr;
+	node->previous = nullptr;
+	this->size--;
+}
+
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::removeFront()
+{
+	T *item = this->getFront();
+	if (item != nullptr) {
+		this->remove(*item);
+	}
+	return item;
+}
+
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::removeBack()
+{
+	T *item = this->getBack();
+	if (item != nullptr) {
+		this->remove(*item);
+	}
+	return item;
+}
+
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::removeAll()
+{
+	this->front = nullptr;
+	this->back = nullptr;
+	this->size = 0;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::getFront() const
+{
+	return (this->front != nullptr) ? toItem(this->front) : nullptr;
+}
+
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::getBack() const
+{
+	return (this->back != nullptr) ? toItem(this->back) : nullptr;
+}
+
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::getNext(const T* item)
+{
+	Hook *next = static_cast<const Hook *>(item)->next;
+	return (next != nullptr) ? toItem(next) : nullptr;
+}
+
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveDoublyLinkedList<T, Tag>::getPrevious(const T* item)
+{
+	Hook *previous = static_cast<const Hook *>(item)->previous;
+	return (previous != nullptr) ? toItem(previous) : nullptr;
+}
@@ -0,0 +1,226 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__INTRUSIVE_LINKED_LIST_HPP
+#define	XPCC__INTRUSIVE_LINKED_LIST_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace xpcc
+{
+	/**
+	 * \brief	Link of an object in an IntrusiveLinkedList
+	 *
+	 * Derive from the hook to make objects storable in an
+	 * IntrusiveLinkedList. Objects which have to be part of several lists
+	 * at the same time derive from one hook per list, distinguished by
+	 * \p Tag.
+	 *
+	 * Copying or moving an object doesn't copy its link, the new object is
+	 * not part of any list.
+	 *
+	 * \ingroup	container
+	 */
+	template <typename Tag = void>
+	class IntrusiveLinkedListHook
+	{
+	public:
+		IntrusiveLinkedListHook() :
+			next(nullptr)
+		{
+		}
+
+		IntrusiveLinkedListHook(const IntrusiveLinkedListHook&) :
+			next(nullptr)
+		{
+		}
+
+		IntrusiveLinkedListHook&
+		operator = (const IntrusiveLinkedListHook&)
+		{
+			return *this;
+		}
+
+	private:
+		template <typename T, typename U>
+		friend class IntrusiveLinkedList;
+
+		IntrusiveLinkedListHook *next;
+	};
+
+	/**
+	 * \brief	Singly-linked list of objects which contain their own link
+	 *
+	 * Unlike xpcc::LinkedList the list neither allocates nodes nor copies
+	 * the objects, it only links objects which derive from
+	 * IntrusiveLinkedListHook. Appending, prepending and removing the
+	 * front take constant time and can't fail. The caller keeps the
+	 * ownership of the objects and has to remove them from the list before
+	 * destroying them.
+	 *
+	 * @code
+	 * struct Message : public xpcc::IntrusiveLinkedListHook<>
+	 * {
+	 *     uint8_t data[8];
+	 * };
+	 *
+	 * Message message;
+	 * xpcc::IntrusiveLinkedList<Message> queue;
+	 * queue.append(message);
+	 * @endcode
+	 *
+	 * The list can be moved but not copied. Use
+	 * xpcc::IntrusiveDoublyLinkedList to remove objects from the middle
+	 * of a list in constant time.
+	 *
+	 * \tparam	T	type of list entries, derived from IntrusiveLinkedListHook<Tag>
+	 *
+	 * \ingroup	container
+	 */
+	template <typename T, typename Tag = void>
+	class IntrusiveLinkedList
+	{
+	public:
+		typedef IntrusiveLinkedListHook<Tag> Hook;
+		typedef std::size_t Size;
+
+	public:
+		IntrusiveLinkedList();
+
+		/// Take over all objects of \p other, which is empty afterwards
+		IntrusiveLinkedList(IntrusiveLinkedList&& other);
+
+		IntrusiveLinkedList&
+		operator = (IntrusiveLinkedList&& other);
+
+		IntrusiveLinkedList(const IntrusiveLinkedList&) = delete;
+
+		IntrusiveLinkedList&
+		operator = (const IntrusiveLinkedList&) = delete;
+
+		inline bool
+		isEmpty() const;
+
+		/// Number of objects in the list, takes constant time
+		inline Size
+		getSize() const;
+
+		/// Insert in front
+		void
+		prepend(T& item);
+
+		/// Insert at the end of the list
+		void
+		append(T& item);
+
+		/// Insert \p item behind \p position, which must be part of the list
+		void
+		insertAfter(T& position, T& item);
+
+		/// Remove and return the first object, \c nullptr if the list is empty
+		T*
+		removeFront();
+
+		/// Unlink all objects
+		void
+		removeAll();
+
+		/// First object, \c nullptr if the list is empty
+		inline T*
+		getFront() const;
+
+		/// Last object, \c nullptr if the list is empty
+		inline T*
+		getBack() const;
+
+		/// Object behind \p item, \c nullptr if \p item is the last one
+		static inline T*
+		getNext(const T* item);
+
+	public:
+		/// Forward iterator
+		class iterator
+		{
+			friend class IntrusiveLinkedList;
+
+		public:
+			iterator() :
+				node(nullptr)
+			{
+			}
+
+			iterator&
+			operator ++ ()
+			{
+				this->node = this->node->next;
+				return *this;
+			}
+
+			bool
+			operator == (const iterator& other) const
+			{
+				return (this->node == other.node);
+			}
+
+			bool
+			operator != (const iterator& other) const
+			{
+				return (this->node != other.node);
+			}
+
+			T&
+			operator * () const
+			{
+				return *static_cast<T *>(this->node);
+			}
+
+			T*
+			operator -> () const
+			{
+				return static_cast<T *>(this->node);
+			}
+
+		private:
+			iterator(Hook *node) :
+				node(node)
+			{
+			}
+
+			Hook *node;
+		};
+
+		inline iterator
+		begin() const
+		{
+			return iterator(this->front);
+		}
+
+		inline iterator
+		end() const
+		{
+			return iterator(nullptr);
+		}
+
+	private:
+		static inline T*
+		toItem(Hook *node)
+		{
+			return static_cast<T *>(node);
+		}
+
+		Hook *front;
+		Hook *back;
+		Size size;
+	};
+}
+
+#include "intrusive_linked_list_impl.hpp"
+
+#endif	// XPCC__INTRUSIVE_LINKED_LIST_HPP
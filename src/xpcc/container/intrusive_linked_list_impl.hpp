@@ -0,0 +1,152 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__INTRUSIVE_LINKED_LIST_HPP
+	#error	"Don't include this file directly, use 'intrusive_linked_list.hpp' instead"
+#endif
+
+// ----------------------------------------------------------------------------
+template <typename T, typename Tag>
+xpcc::IntrusiveLinkedList<T, Tag>::IntrusiveLinkedList() :
+	front(nullptr), back(nullptr), size(0)
+{
+}
+
+template <typename T, typename Tag>
+xpcc::IntrusiveLinkedList<T, Tag>::IntrusiveLinkedList(IntrusiveLinkedList&& other) :
+	front(other.front), back(other.back), size(other.size)
+{
+	other.removeAll();
+}
+
+template <typename T, typename Tag>
+xpcc::IntrusiveLinkedList<T, Tag>&
+xpcc::IntrusiveLinkedList<T, Tag>::operator = (IntrusiveLinkedList&& other)
+{
+	if (this != &other)
+	{
+		this->front = other.front;
+		this->back = other.back;
+		this->size = other.size;
+		other.removeAll();
+	}
+	return *this;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, typename Tag>
+bool
+xpcc::IntrusiveLinkedList<T, Tag>::isEmpty() const
+{
+	return (this->front == nullptr);
+}
+
+template <typename T, typename Tag>
+typename xpcc::IntrusiveLinkedList<T, Tag>::Size
+xpcc::IntrusiveLinkedList<T, Tag>::getSize() const
+{
+	return this->size;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveLinkedList<T, Tag>::prepend(T& item)
+{
+	Hook *node = &item;
+	node->next = this->front;
+	this->front = node;
+	if (this->back == nullptr) {
+		// first entry in the list
+		this->back = node;
+	}
+	this->size++;
+}
+
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveLinkedList<T, Tag>::append(T& item)
+{
+	Hook *node = &item;
+	node->next = nullptr;
+	if (this->back == nullptr) {
+		// first entry in the list
+		this->front = node;
+	}
+	else {
+		this->back->next = node;
+	}
+	this->back = node;
+	this->size++;
+}
+
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveLinkedList<T, Tag>::insertAfter(T& position, T& item)
+{
+	Hook *previous = &position;
+	Hook *node = &item;
+	node->next = previous->next;
+	previous->next = node;
+	if (this->back == previous) {
+		this->back = node;
+	}
+	this->size++;
+}
+
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveLinkedList<T, Tag>::removeFront()
+{
+	Hook *node = this->front;
+	if (node != nullptr)
+	{
+		this->front = node->next;
+		if (this->front == nullptr) {
+			// last entry in the list
+			this->back = nullptr;
+		}
+		node->next = nullptr;
+		this->size--;
+		return toItem(node);
+	}
+	return nullptr;
+}
+
+template <typename T, typename Tag>
+void
+xpcc::IntrusiveLinkedList<T, Tag>::removeAll()
+{
+	this->front = nullptr;
+	this->back = nullptr;
+	this->size = 0;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveLinkedList<T, Tag>::getFront() const
+{
+	return (this->front != nullptr) ? toItem(this->front) : nullptr;
+}
+
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveLinkedList<T, Tag>::getBack() const
+{
+	return (this->back != nullptr) ? toItem(this->back) : nullptr;
+}
+
+template <typename T, typename Tag>
+T*
+xpcc::IntrusiveLinkedList<T, Tag>::getNext(const T* item)
+{
+	Hook *next = static_cast<const Hook *>(item)->next;
+	return (next != nullptr) ? toItem(next) : nullptr;
+}
@@ -116,6 +116,56 @@ namespace xpcc
 		{
 			c.removeFront();
 		}
+		
+		/// Append up to \p count elements, returns the number of appended elements
+		inline std::size_t
+		push(const T* values, std::size_t count)
+		{
+			return c.append(values, count);
+		}
+		
+		/// Remove up to \p count elements, returns the number of removed elements
+		inline std::size_t
+		pop(T* values, std::size_t count)
+		{
+			return c.removeFront(values, count);
+		}
+		
+		/**
+		 * \brief	Contiguous block of the oldest elements
+		 * 
+		 * \see	BoundedDeque::getReadSpan()
+		 */
+		inline const T*
+		getReadSpan(std::size_t& length) const
+		{
+			return c.getReadSpan(length);
+		}
+		
+		/// Remove \p count elements of the read span
+		inline void
+		commitRead(std::size_t count)
+		{
+			c.commitRead(count);
+		}
+		
+		/**
+		 * \brief	Contiguous block of free space for new elements
+		 * 
+		 * \see	BoundedDeque::getWriteSpan()
+		 */
+		inline T*
+		getWriteSpan(std::size_t& length)
+		{
+			return c.getWriteSpan(length);
+		}
+		
+		/// Append \p count elements written to the write span
+		inline void
+		commitWrite(std::size_t count)
+		{
+			c.commitWrite(count);
+		}
 
 	protected:
 		Container c;
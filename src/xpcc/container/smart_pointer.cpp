@@ -30,15 +30,136 @@
 
 #include "smart_pointer.hpp"
 
+#include <xpcc/architecture/detect.hpp>
+
+#if defined(XPCC__OS_HOSTED)
+#	include <mutex>
+#else
+#	include <xpcc/architecture/driver/atomic/lock.hpp>
+#endif
+
+// ----------------------------------------------------------------------------
+// Buffer layout:
+//   [0]    reference counter
+//   [1]    size class of the buffer, or heapClass if it is not pooled
+//   [2..3] size of the payload
+//   [4..]  payload
+//
+// While a buffer is stored in a free list its first bytes are used to
+// link to the next free buffer of the same size class.
+namespace
+{
+#if defined(XPCC__OS_HOSTED)
+	const uint16_t classSizes[] = { 8, 16, 32, 64, 128, 256, 512 };
+	const uint16_t maximumCachedBuffers = 1024;
+#else
+	const uint16_t classSizes[] = { 8, 16, 32, 64 };
+	const uint16_t maximumCachedBuffers = 8;
+#endif
+
+	const uint8_t numberOfClasses = sizeof(classSizes) / sizeof(classSizes[0]);
+	const uint8_t heapClass = 0xff;
+
+	struct FreeList
+	{
+		uint8_t *front;
+		uint16_t count;
+	};
+
+	FreeList freeLists[numberOfClasses];
+
+#if defined(XPCC__OS_HOSTED)
+	// Payloads are created by the receiver threads of some backends
+	std::mutex poolMutex;
+#endif
+
+	class PoolLock
+	{
+#if defined(XPCC__OS_HOSTED)
+	public:
+		PoolLock() :
+			lock(poolMutex)
+		{
+		}
+
+	private:
+		std::lock_guard<std::mutex> lock;
+#else
+	private:
+		xpcc::atomic::Lock lock;
+#endif
+	};
+
+	inline uint8_t *&
+	nextFree(uint8_t *buffer)
+	{
+		return *reinterpret_cast<uint8_t **>(buffer);
+	}
+}
+
+uint8_t *
+xpcc::SmartPointer::allocate(uint16_t size)
+{
+	uint8_t *buffer = nullptr;
+	uint8_t sizeClass = 0;
+	while (sizeClass < numberOfClasses && size > classSizes[sizeClass]) {
+		sizeClass++;
+	}
+
+	if (sizeClass < numberOfClasses)
+	{
+		{
+			PoolLock lock;
+			FreeList& list = freeLists[sizeClass];
+			if (list.front != nullptr)
+			{
+				buffer = list.front;
+				list.front = nextFree(buffer);
+				list.count--;
+			}
+		}
+
+		if (buffer == nullptr) {
+			buffer = new uint8_t[classSizes[sizeClass] + headerSize];
+		}
+	}
+	else
+	{
+		sizeClass = heapClass;
+		buffer = new uint8_t[size + headerSize];
+	}
+
+	buffer[0] = 1;
+	buffer[1] = sizeClass;
+	*reinterpret_cast<uint16_t*>(buffer + 2) = size;
+
+	return buffer;
+}
+
+void
+xpcc::SmartPointer::release(uint8_t *buffer)
+{
+	uint8_t sizeClass = buffer[1];
+	if (sizeClass < numberOfClasses)
+	{
+		PoolLock lock;
+		FreeList& list = freeLists[sizeClass];
+		if (list.count < maximumCachedBuffers)
+		{
+			nextFree(buffer) = list.front;
+			list.front = buffer;
+			list.count++;
+			return;
+		}
+	}
+
+	delete[] buffer;
+}
+
 // ----------------------------------------------------------------------------
-// must allocate at least five bytes, so getPointer() does return
-// a valid address
 xpcc::SmartPointer::SmartPointer() :
-	ptr(new uint8_t[5])
+	ptr(allocate(0))
 {
-	ptr[0] = 1;
-	ptr[2] = 0;
-	ptr[3] = 0;
 }
 
 xpcc::SmartPointer::SmartPointer(const SmartPointer& other) :
@@ -47,22 +168,28 @@ xpcc::SmartPointer::SmartPointer(const SmartPointer& other) :
 	ptr[0]++;
 }
 
-// must allocate at least five bytes, so getPointer() does return
-// a valid address
 xpcc::SmartPointer::SmartPointer(uint16_t size) :
-	ptr(new uint8_t[size ? size + 4 : 5])
+	ptr(allocate(size))
 {
-	ptr[0] = 1;
-	*reinterpret_cast<uint16_t*>(ptr + 2) = size;
 }
 
 xpcc::SmartPointer::~SmartPointer()
 {
 	if (--ptr[0] == 0) {
-		delete[] ptr;
+		release(ptr);
 	}
 }
 
+xpcc::SmartPointer
+xpcc::SmartPointer::adopt(uint8_t *buffer, uint16_t size)
+{
+	buffer[0] = 1;
+	buffer[1] = heapClass;
+	*reinterpret_cast<uint16_t*>(buffer + 2) = size;
+
+	return SmartPointer(buffer, Adopt());
+}
+
 // ----------------------------------------------------------------------------
 bool
 xpcc::SmartPointer::operator == (const SmartPointer& other)
@@ -73,12 +200,13 @@ xpcc::SmartPointer::operator == (const SmartPointer& other)
 xpcc::SmartPointer&
 xpcc::SmartPointer::operator = (const SmartPointer& other)
 {
+	// increment first, so assigning a pointer to itself is safe
+	other.ptr[0]++;
 	if (--ptr[0] == 0) {
-		delete[] ptr;
+		release(ptr);
 	}
 
 	ptr = other.ptr;
-	ptr[0]++;
 
 	return *this;
 }
@@ -33,6 +33,8 @@
 
 #include <cstring>		// for std::memcpy
 #include <stdint.h>
+#include <new>			// for placement new
+#include <utility>		// for std::forward
 #include <xpcc/architecture/utils.hpp>
 
 #include <xpcc/io/iostream.hpp>
@@ -50,6 +52,20 @@ namespace xpcc
 	 * records when it is copied - when the last copy is destroyed the
 	 * memory is released.
 	 *
+	 * Small buffers are taken from a pool with one free list per size class
+	 * (payloads up to 8, 16, 32 and 64 bytes, on hosted targets also up to
+	 * 128, 256 and 512 bytes). Released buffers are kept in the pool and
+	 * reused, so once the pool is warmed up no heap allocations are needed
+	 * to send messages. Larger buffers are allocated from and returned to
+	 * the heap directly.
+	 *
+	 * A payload which is built by the sender can be constructed directly
+	 * inside the buffer with create(), instead of being constructed on
+	 * the stack and copied by SmartPointer(const T*). A buffer which is
+	 * already filled can be handed over with adopt(). Received payloads
+	 * are still copied once from the frames of the driver into a new
+	 * buffer.
+	 *
 	 * \ingroup container
 	 */
 	class SmartPointer
@@ -70,10 +86,8 @@ namespace xpcc
 		// between constructor and copy constructor!
 		template<typename T>
 		explicit SmartPointer(const T *data)
-		: ptr(new uint8_t[sizeof(T) + 4])
+		: ptr(allocate(sizeof(T)))
 		{
-			ptr[0] = 1;
-			*reinterpret_cast<uint16_t*>(ptr + 2) = sizeof(T);
 			std::memcpy(ptr + 4, data, sizeof(T));
 		}
 
@@ -81,6 +95,42 @@ namespace xpcc
 
 		~SmartPointer();
 
+		/**
+		 * \brief	Construct an object of type \p T inside the payload
+		 *
+		 * The arguments are forwarded to the constructor of \p T. The
+		 * object is never destructed, so \p T should be trivially
+		 * destructible. The payload is only aligned to four bytes.
+		 */
+		template<typename T, typename... Args>
+		static SmartPointer
+		create(Args&&... args)
+		{
+			static_assert(alignof(T) <= 4,
+					"The payload is only aligned to four bytes!");
+			SmartPointer pointer(allocate(sizeof(T)), Adopt());
+			new (pointer.getPointer()) T(std::forward<Args>(args)...);
+			return pointer;
+		}
+
+		/**
+		 * \brief	Take over an existing buffer without copying it
+		 *
+		 * The buffer has to be allocated with
+		 * `new uint8_t[SmartPointer::headerSize + size]`, the payload starts
+		 * at `buffer + SmartPointer::headerSize`. The first
+		 * \c headerSize bytes are overwritten. The buffer is released with
+		 * `delete[]` when the last copy is destroyed.
+		 *
+		 * \param	buffer	buffer allocated with `new[]`
+		 * \param	size	size of the payload, has to be smaller than 65530
+		 */
+		static SmartPointer
+		adopt(uint8_t *buffer, uint16_t size);
+
+		/// Number of bytes in front of the payload used for bookkeeping
+		static constexpr uint16_t headerSize = 4;
+
 		inline const uint8_t *
 		getPointer() const
 		{
@@ -139,6 +189,24 @@ namespace xpcc
 		SmartPointer&
 		operator = (const SmartPointer& other);
 
+	protected:
+		struct Adopt
+		{
+		};
+
+		/// Use a buffer with an already initialized header
+		SmartPointer(uint8_t *buffer, Adopt) :
+			ptr(buffer)
+		{
+		}
+
+		/// Get a buffer with an initialized header for a payload of \p size bytes
+		static uint8_t *
+		allocate(uint16_t size);
+
+		static void
+		release(uint8_t *buffer);
+
 	protected:
 		uint8_t * ptr;
 
@@ -0,0 +1,190 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__SPSC_QUEUE_HPP
+#define	XPCC__SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <stdint.h>
+
+namespace xpcc
+{
+	/**
+	 * \brief	Bounded lock-free queue between exactly one producer thread
+	 * 			and one consumer thread
+	 *
+	 * Used e.g. by the hosted backends to hand received packets from their
+	 * receiver thread to the thread calling the Dispatcher. Neither side
+	 * takes a lock to push, inspect or pop elements. The head and tail
+	 * indices are kept on separate cache lines, so the two threads do not
+	 * invalidate each other's cache line on every access.
+	 *
+	 * If the queue is full, push() drops the new element and increments
+	 * the overflow counter.
+	 *
+	 * waitForElement() blocks the consumer on a condition variable. The
+	 * producer only takes the corresponding mutex when the consumer is
+	 * actually waiting.
+	 *
+	 * Consumers which wait on several sources at once (e.g. with epoll)
+	 * use getNotificationDescriptor() instead. The producer then writes
+	 * to a pipe whenever it pushes into an empty queue.
+	 *
+	 * \tparam	T	Type of the elements
+	 *
+	 * \ingroup	container
+	 */
+	template<typename T>
+	class SpscQueue
+	{
+	public:
+		/**
+		 * \param	capacity	Maximum number of stored elements, rounded
+		 * 						up to the next power of two
+		 */
+		explicit
+		SpscQueue(std::size_t capacity);
+
+		~SpscQueue();
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue& operator=(const SpscQueue&) = delete;
+
+		/**
+		 * \brief	Producer: append an element, \c false if the queue was full
+		 *
+		 * The element must not share state with the producer after it
+		 * was appended. Elements which the producer has to fill (e.g. an
+		 * xpcc::SmartPointer, whose reference count is not thread-safe)
+		 * are built with reserve() instead.
+		 */
+		template<typename... Args>
+		bool
+		push(Args&&... args);
+
+		/**
+		 * \brief	Producer: construct an element in the next free slot
+		 * 			without making it visible to the consumer
+		 *
+		 * Allows the producer to fill the element in place before it is
+		 * published with commit(), or destroyed again with cancel().
+		 * Nothing else may be pushed in between.
+		 *
+		 * \return	The new element, \c nullptr if the queue was full
+		 */
+		template<typename... Args>
+		T *
+		reserve(Args&&... args);
+
+		/// Producer: append the element constructed by reserve()
+		void
+		commit();
+
+		/// Producer: destroy the element constructed by reserve()
+		void
+		cancel();
+
+		/// Consumer
+		bool
+		isEmpty() const;
+
+		/// Consumer: oldest element, only valid if the queue is not empty
+		T&
+		getFront();
+
+		const T&
+		getFront() const;
+
+		/// Consumer: remove the oldest element
+		void
+		pop();
+
+		/**
+		 * \brief	Consumer: block until an element is available
+		 *
+		 * \param	timeout	Maximum time to wait in milliseconds
+		 * \return	\c true if an element is available
+		 */
+		bool
+		waitForElement(uint16_t timeout) const;
+
+		/**
+		 * \brief	Consumer: descriptor which becomes readable when an
+		 * 			element is pushed into the empty queue
+		 *
+		 * The pipe is created by the first call. Call clearNotification()
+		 * before taking all elements out of the queue, otherwise elements
+		 * pushed in between may not be signalled.
+		 *
+		 * \return	Read end of the pipe, -1 if it couldn't be created
+		 */
+		int
+		getNotificationDescriptor();
+
+		/// Consumer: reset the descriptor to not readable
+		void
+		clearNotification();
+
+		inline std::size_t
+		getCapacity() const
+		{
+			return this->mask + 1;
+		}
+
+		/// Number of elements dropped because the queue was full
+		inline uint32_t
+		getOverflows() const
+		{
+			return this->overflows.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr std::size_t cacheLineSize = 64;
+
+		typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+		T *
+		getSlot(std::size_t index) const
+		{
+			return reinterpret_cast<T *>(&this->buffer[index & this->mask]);
+		}
+
+		static std::size_t
+		roundUpToPowerOfTwo(std::size_t value);
+
+	private:
+		// written by the producer
+		alignas(cacheLineSize) std::atomic<std::size_t> head;
+		std::size_t cachedTail;
+
+		// written by the consumer
+		alignas(cacheLineSize) std::atomic<std::size_t> tail;
+		mutable std::size_t cachedHead;
+
+		alignas(cacheLineSize) const std::size_t mask;
+		const std::unique_ptr<Storage[]> buffer;
+		std::atomic<uint32_t> overflows;
+
+		int notificationRead;
+		std::atomic<int> notificationWrite;
+
+		mutable std::atomic<bool> consumerWaiting;
+		mutable std::mutex waitMutex;
+		mutable std::condition_variable waitCondition;
+	};
+}
+
+#include "spsc_queue_impl.hpp"
+
+#endif	// XPCC__SPSC_QUEUE_HPP
@@ -0,0 +1,215 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__SPSC_QUEUE_HPP
+#	error	"Don't include this file directly, use 'spsc_queue.hpp' instead!"
+#endif
+
+#include <chrono>
+#include <new>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// ----------------------------------------------------------------------------
+template<typename T>
+xpcc::SpscQueue<T>::SpscQueue(std::size_t capacity) :
+	head(0), cachedTail(0), tail(0), cachedHead(0),
+	mask(roundUpToPowerOfTwo(capacity) - 1),
+	buffer(new Storage[mask + 1]),
+	overflows(0), notificationRead(-1), notificationWrite(-1),
+	consumerWaiting(false)
+{
+}
+
+template<typename T>
+xpcc::SpscQueue<T>::~SpscQueue()
+{
+	while (!this->isEmpty()) {
+		this->pop();
+	}
+
+	if (this->notificationRead >= 0)
+	{
+		::close(this->notificationRead);
+		::close(this->notificationWrite.load(std::memory_order_relaxed));
+	}
+}
+
+// ----------------------------------------------------------------------------
+template<typename T>
+template<typename... Args>
+bool
+xpcc::SpscQueue<T>::push(Args&&... args)
+{
+	if (this->reserve(std::forward<Args>(args)...) == nullptr) {
+		return false;
+	}
+	this->commit();
+	return true;
+}
+
+template<typename T>
+template<typename... Args>
+T *
+xpcc::SpscQueue<T>::reserve(Args&&... args)
+{
+	const std::size_t currentHead = this->head.load(std::memory_order_relaxed);
+	if (currentHead - this->cachedTail > this->mask)
+	{
+		// only reload the index of the other thread if the queue looks full
+		this->cachedTail = this->tail.load(std::memory_order_acquire);
+		if (currentHead - this->cachedTail > this->mask)
+		{
+			this->overflows.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+	}
+
+	return new (this->getSlot(currentHead)) T(std::forward<Args>(args)...);
+}
+
+template<typename T>
+void
+xpcc::SpscQueue<T>::commit()
+{
+	const std::size_t currentHead = this->head.load(std::memory_order_relaxed);
+	this->head.store(currentHead + 1, std::memory_order_seq_cst);
+
+	if (this->consumerWaiting.load(std::memory_order_seq_cst))
+	{
+		std::lock_guard<std::mutex> lock(this->waitMutex);
+		this->waitCondition.notify_one();
+	}
+
+	const int descriptor = this->notificationWrite.load(std::memory_order_acquire);
+	if (descriptor >= 0 and
+		this->tail.load(std::memory_order_seq_cst) == currentHead)
+	{
+		// The queue was empty, the consumer either sees the new element
+		// while draining the queue or is woken up by the pipe.
+		const uint8_t byte = 0;
+		ssize_t result = ::write(descriptor, &byte, 1);
+		(void) result;
+	}
+}
+
+template<typename T>
+void
+xpcc::SpscQueue<T>::cancel()
+{
+	this->getSlot(this->head.load(std::memory_order_relaxed))->~T();
+}
+
+// ----------------------------------------------------------------------------
+template<typename T>
+bool
+xpcc::SpscQueue<T>::isEmpty() const
+{
+	// only reload the index of the other thread if the cached value does
+	// not promise any elements (pop() may have moved the tail beyond it)
+	const std::size_t currentTail = this->tail.load(std::memory_order_relaxed);
+	if (this->cachedHead - currentTail - 1 > this->mask)
+	{
+		// Orders the store of the tail in pop() before this load. Either
+		// commit() sees the consumer caught up and writes to the pipe, or
+		// the new head is visible here.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		this->cachedHead = this->head.load(std::memory_order_acquire);
+	}
+	return (currentTail == this->cachedHead);
+}
+
+template<typename T>
+T&
+xpcc::SpscQueue<T>::getFront()
+{
+	return *this->getSlot(this->tail.load(std::memory_order_relaxed));
+}
+
+template<typename T>
+const T&
+xpcc::SpscQueue<T>::getFront() const
+{
+	return *this->getSlot(this->tail.load(std::memory_order_relaxed));
+}
+
+template<typename T>
+void
+xpcc::SpscQueue<T>::pop()
+{
+	const std::size_t currentTail = this->tail.load(std::memory_order_relaxed);
+	this->getSlot(currentTail)->~T();
+	this->tail.store(currentTail + 1, std::memory_order_release);
+}
+
+// ----------------------------------------------------------------------------
+template<typename T>
+bool
+xpcc::SpscQueue<T>::waitForElement(uint16_t timeout) const
+{
+	std::unique_lock<std::mutex> lock(this->waitMutex);
+
+	// Either the producer sees the flag and notifies under the mutex, or
+	// the check of the predicate sees the new element.
+	this->consumerWaiting.store(true, std::memory_order_seq_cst);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	bool available = this->waitCondition.wait_for(lock,
+			std::chrono::milliseconds(timeout),
+			[this]() { return !this->isEmpty(); });
+	this->consumerWaiting.store(false, std::memory_order_relaxed);
+
+	return available;
+}
+
+// ----------------------------------------------------------------------------
+template<typename T>
+int
+xpcc::SpscQueue<T>::getNotificationDescriptor()
+{
+	if (this->notificationRead < 0)
+	{
+		int descriptors[2];
+		if (::pipe(descriptors) < 0) {
+			return -1;
+		}
+		// a full pipe is readable as well, so writes may fail silently
+		::fcntl(descriptors[0], F_SETFL, O_NONBLOCK);
+		::fcntl(descriptors[1], F_SETFL, O_NONBLOCK);
+
+		this->notificationRead = descriptors[0];
+		this->notificationWrite.store(descriptors[1], std::memory_order_release);
+	}
+	return this->notificationRead;
+}
+
+template<typename T>
+void
+xpcc::SpscQueue<T>::clearNotification()
+{
+	if (this->notificationRead >= 0)
+	{
+		uint8_t buffer[64];
+		while (::read(this->notificationRead, buffer, sizeof(buffer)) > 0) {
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+template<typename T>
+std::size_t
+xpcc::SpscQueue<T>::roundUpToPowerOfTwo(std::size_t value)
+{
+	std::size_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
@@ -383,3 +383,86 @@ BoundedDequeTest::testElementAccess()
 	TEST_ASSERT_EQUALS(deque.rget(2), 2);
 	
 }
+
+void
+BoundedDequeTest::testBulk()
+{
+	xpcc::BoundedDeque<int16_t, 5> deque;
+	const int16_t input[] = { 1, 2, 3, 4, 5, 6, 7 };
+	int16_t output[7] = { 0 };
+	
+	TEST_ASSERT_EQUALS(deque.append(input, 3), 3U);
+	TEST_ASSERT_EQUALS(deque.getSize(), 3U);
+	TEST_ASSERT_EQUALS(deque.getFront(), 1);
+	TEST_ASSERT_EQUALS(deque.getBack(), 3);
+	
+	TEST_ASSERT_EQUALS(deque.removeFront(output, 2), 2U);
+	TEST_ASSERT_EQUALS_ARRAY(output, input, 2);
+	
+	// only the free space is filled, wrapping around the end of the buffer
+	TEST_ASSERT_EQUALS(deque.append(input + 3, 4), 4U);
+	TEST_ASSERT_TRUE(deque.isFull());
+	TEST_ASSERT_EQUALS(deque.append(input, 1), 0U);
+	TEST_ASSERT_EQUALS(deque.getBack(), 7);
+	TEST_ASSERT_EQUALS(deque.rget(1), 6);
+	
+	TEST_ASSERT_EQUALS(deque.removeFront(output, 7), 5U);
+	TEST_ASSERT_EQUALS_ARRAY(output, input + 2, 5);
+	TEST_ASSERT_TRUE(deque.isEmpty());
+	TEST_ASSERT_EQUALS(deque.removeFront(output, 7), 0U);
+	
+	// single element operations still work afterwards
+	TEST_ASSERT_TRUE(deque.append(8));
+	TEST_ASSERT_TRUE(deque.prepend(9));
+	TEST_ASSERT_EQUALS(deque.getFront(), 9);
+	TEST_ASSERT_EQUALS(deque.getBack(), 8);
+}
+
+void
+BoundedDequeTest::testSpan()
+{
+	xpcc::BoundedDeque<int16_t, 4> deque;
+	std::size_t length;
+	
+	const int16_t *read = deque.getReadSpan(length);
+	TEST_ASSERT_EQUALS(length, 0U);
+	
+	// the buffer starts at index 1 after construction
+	int16_t *write = deque.getWriteSpan(length);
+	TEST_ASSERT_EQUALS(length, 3U);
+	write[0] = 1;
+	write[1] = 2;
+	deque.commitWrite(2);
+	TEST_ASSERT_EQUALS(deque.getSize(), 2U);
+	TEST_ASSERT_EQUALS(deque.getFront(), 1);
+	TEST_ASSERT_EQUALS(deque.getBack(), 2);
+	
+	write = deque.getWriteSpan(length);
+	TEST_ASSERT_EQUALS(length, 1U);
+	write[0] = 3;
+	deque.commitWrite(1);
+	
+	// the rest of the free space is at the start of the buffer
+	write = deque.getWriteSpan(length);
+	TEST_ASSERT_EQUALS(length, 1U);
+	write[0] = 4;
+	deque.commitWrite(1);
+	TEST_ASSERT_TRUE(deque.isFull());
+	deque.getWriteSpan(length);
+	TEST_ASSERT_EQUALS(length, 0U);
+	
+	read = deque.getReadSpan(length);
+	TEST_ASSERT_EQUALS(length, 3U);
+	TEST_ASSERT_EQUALS(read[0], 1);
+	TEST_ASSERT_EQUALS(read[2], 3);
+	deque.commitRead(3);
+	
+	read = deque.getReadSpan(length);
+	TEST_ASSERT_EQUALS(length, 1U);
+	TEST_ASSERT_EQUALS(read[0], 4);
+	deque.commitRead(1);
+	
+	TEST_ASSERT_TRUE(deque.isEmpty());
+	deque.getReadSpan(length);
+	TEST_ASSERT_EQUALS(length, 0U);
+}
@@ -61,4 +61,10 @@ public:
 	
 	void
 	testElementAccess();
+	
+	void
+	testBulk();
+	
+	void
+	testSpan();
 };
@@ -77,3 +77,26 @@ BoundedQueueTest::testQueue()
 	
 	TEST_ASSERT_TRUE(queue.isEmpty());
 }
+
+void
+BoundedQueueTest::testBulk()
+{
+	xpcc::BoundedQueue<uint8_t, 8> queue;
+	const uint8_t input[] = "abcdefghij";
+	uint8_t output[10];
+	
+	TEST_ASSERT_EQUALS(queue.push(input, 10), 8U);
+	TEST_ASSERT_TRUE(queue.isFull());
+	TEST_ASSERT_EQUALS(queue.get(), 'a');
+	
+	std::size_t length;
+	const uint8_t *span = queue.getReadSpan(length);
+	TEST_ASSERT_EQUALS(length, 7U);
+	TEST_ASSERT_EQUALS(span[0], 'a');
+	queue.commitRead(4);
+	
+	TEST_ASSERT_EQUALS(queue.push(input + 8, 2), 2U);
+	TEST_ASSERT_EQUALS(queue.pop(output, 10), 6U);
+	TEST_ASSERT_EQUALS_ARRAY(output, input + 4, 6);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+}
@@ -35,4 +35,7 @@ class BoundedQueueTest : public unittest::TestSuite
 public:
 	void
 	testQueue();
+	
+	void
+	testBulk();
 };
@@ -0,0 +1,183 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <utility>
+
+#include <xpcc/container/intrusive_doubly_linked_list.hpp>
+
+#include "intrusive_doubly_linked_list_test.hpp"
+
+namespace
+{
+	struct Item : public xpcc::IntrusiveDoublyLinkedListHook<>
+	{
+		Item(int16_t value = 0) :
+			value(value)
+		{
+		}
+		
+		int16_t value;
+	};
+	
+	typedef xpcc::IntrusiveDoublyLinkedList<Item> List;
+}
+
+void
+IntrusiveDoublyLinkedListTest::testAppendPrepend()
+{
+	List list;
+	Item a(1), b(2), c(3);
+	
+	TEST_ASSERT_TRUE(list.isEmpty());
+	
+	list.append(b);
+	list.prepend(a);
+	list.append(c);
+	
+	TEST_ASSERT_EQUALS(list.getSize(), 3U);
+	TEST_ASSERT_TRUE(list.getFront() == &a);
+	TEST_ASSERT_TRUE(list.getBack() == &c);
+	TEST_ASSERT_TRUE(List::getNext(&a) == &b);
+	TEST_ASSERT_TRUE(List::getNext(&b) == &c);
+	TEST_ASSERT_TRUE(List::getPrevious(&c) == &b);
+	TEST_ASSERT_TRUE(List::getPrevious(&b) == &a);
+	TEST_ASSERT_TRUE(List::getPrevious(&a) == nullptr);
+}
+
+void
+IntrusiveDoublyLinkedListTest::testRemove()
+{
+	List list;
+	Item a(1), b(2), c(3);
+	list.append(a);
+	list.append(b);
+	list.append(c);
+	
+	// middle
+	list.remove(b);
+	TEST_ASSERT_EQUALS(list.getSize(), 2U);
+	TEST_ASSERT_TRUE(List::getNext(&a) == &c);
+	TEST_ASSERT_TRUE(List::getPrevious(&c) == &a);
+	
+	// back
+	list.remove(c);
+	TEST_ASSERT_TRUE(list.getBack() == &a);
+	TEST_ASSERT_TRUE(List::getNext(&a) == nullptr);
+	
+	// last one
+	list.remove(a);
+	TEST_ASSERT_TRUE(list.isEmpty());
+	TEST_ASSERT_TRUE(list.getFront() == nullptr);
+	TEST_ASSERT_TRUE(list.getBack() == nullptr);
+	
+	list.append(c);
+	list.append(b);
+	
+	// front
+	list.remove(c);
+	TEST_ASSERT_TRUE(list.getFront() == &b);
+	TEST_ASSERT_TRUE(List::getPrevious(&b) == nullptr);
+	TEST_ASSERT_EQUALS(list.getSize(), 1U);
+}
+
+void
+IntrusiveDoublyLinkedListTest::testRemoveFrontBack()
+{
+	List list;
+	Item a(1), b(2), c(3);
+	
+	TEST_ASSERT_TRUE(list.removeFront() == nullptr);
+	TEST_ASSERT_TRUE(list.removeBack() == nullptr);
+	
+	list.append(a);
+	list.append(b);
+	list.append(c);
+	
+	TEST_ASSERT_TRUE(list.removeBack() == &c);
+	TEST_ASSERT_TRUE(list.removeFront() == &a);
+	TEST_ASSERT_TRUE(list.getFront() == &b);
+	TEST_ASSERT_TRUE(list.getBack() == &b);
+	TEST_ASSERT_TRUE(list.removeBack() == &b);
+	TEST_ASSERT_TRUE(list.isEmpty());
+}
+
+void
+IntrusiveDoublyLinkedListTest::testInsert()
+{
+	List list;
+	Item a(1), b(2), c(3), d(4);
+	
+	list.append(b);
+	list.insertBefore(b, a);
+	list.insertAfter(b, d);
+	list.insertBefore(d, c);
+	
+	TEST_ASSERT_EQUALS(list.getSize(), 4U);
+	TEST_ASSERT_TRUE(list.getFront() == &a);
+	TEST_ASSERT_TRUE(list.getBack() == &d);
+	
+	int16_t expected = 1;
+	for (Item *item = list.getFront(); item != nullptr; item = List::getNext(item)) {
+		TEST_ASSERT_EQUALS(item->value, expected);
+		expected++;
+	}
+	
+	expected = 4;
+	for (Item *item = list.getBack(); item != nullptr; item = List::getPrevious(item)) {
+		TEST_ASSERT_EQUALS(item->value, expected);
+		expected--;
+	}
+}
+
+void
+IntrusiveDoublyLinkedListTest::testIterator()
+{
+	List list;
+	Item items[3] = { 1, 2, 3 };
+	for (Item& item : items) {
+		list.append(item);
+	}
+	
+	int16_t sum = 0;
+	for (const Item& item : list) {
+		sum += item.value;
+	}
+	TEST_ASSERT_EQUALS(sum, 6);
+	
+	List::iterator it = list.begin();
+	++it;
+	++it;
+	TEST_ASSERT_EQUALS(it->value, 3);
+	--it;
+	TEST_ASSERT_EQUALS((*it).value, 2);
+	++it;
+	++it;
+	TEST_ASSERT_TRUE(it == list.end());
+}
+
+void
+IntrusiveDoublyLinkedListTest::testMove()
+{
+	List list;
+	Item a(1), b(2);
+	list.append(a);
+	list.append(b);
+	
+	List other(std::move(list));
+	TEST_ASSERT_TRUE(list.isEmpty());
+	TEST_ASSERT_EQUALS(other.getSize(), 2U);
+	
+	other.remove(a);
+	TEST_ASSERT_TRUE(other.getFront() == &b);
+	
+	list = std::move(other);
+	TEST_ASSERT_TRUE(other.isEmpty());
+	TEST_ASSERT_TRUE(list.getFront() == &b);
+	TEST_ASSERT_EQUALS(list.getSize(), 1U);
+}
@@ -0,0 +1,174 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <utility>
+
+#include <xpcc/container/intrusive_linked_list.hpp>
+
+#include "intrusive_linked_list_test.hpp"
+
+namespace
+{
+	struct Item : public xpcc::IntrusiveLinkedListHook<>
+	{
+		Item(int16_t value = 0) :
+			value(value)
+		{
+		}
+		
+		int16_t value;
+	};
+	
+	struct Other;
+	
+	struct TaggedItem :
+		public xpcc::IntrusiveLinkedListHook<>,
+		public xpcc::IntrusiveLinkedListHook<Other>
+	{
+		int16_t value;
+	};
+}
+
+void
+IntrusiveLinkedListTest::testAppendPrepend()
+{
+	xpcc::IntrusiveLinkedList<Item> list;
+	Item a(1), b(2), c(3);
+	
+	TEST_ASSERT_TRUE(list.isEmpty());
+	TEST_ASSERT_EQUALS(list.getSize(), 0U);
+	TEST_ASSERT_TRUE(list.getFront() == nullptr);
+	TEST_ASSERT_TRUE(list.getBack() == nullptr);
+	
+	list.append(b);
+	list.append(c);
+	list.prepend(a);
+	
+	TEST_ASSERT_FALSE(list.isEmpty());
+	TEST_ASSERT_EQUALS(list.getSize(), 3U);
+	TEST_ASSERT_TRUE(list.getFront() == &a);
+	TEST_ASSERT_TRUE(list.getBack() == &c);
+	TEST_ASSERT_TRUE(list.getNext(&a) == &b);
+	TEST_ASSERT_TRUE(list.getNext(&b) == &c);
+	TEST_ASSERT_TRUE(list.getNext(&c) == nullptr);
+}
+
+void
+IntrusiveLinkedListTest::testRemoveFront()
+{
+	xpcc::IntrusiveLinkedList<Item> list;
+	Item a(1), b(2);
+	
+	TEST_ASSERT_TRUE(list.removeFront() == nullptr);
+	
+	list.append(a);
+	list.append(b);
+	
+	TEST_ASSERT_TRUE(list.removeFront() == &a);
+	TEST_ASSERT_EQUALS(list.getSize(), 1U);
+	TEST_ASSERT_TRUE(list.getFront() == &b);
+	TEST_ASSERT_TRUE(list.getBack() == &b);
+	
+	TEST_ASSERT_TRUE(list.removeFront() == &b);
+	TEST_ASSERT_TRUE(list.isEmpty());
+	TEST_ASSERT_TRUE(list.getBack() == nullptr);
+	
+	// removed objects can be added again
+	list.append(a);
+	TEST_ASSERT_TRUE(list.getFront() == &a);
+	TEST_ASSERT_TRUE(list.getBack() == &a);
+}
+
+void
+IntrusiveLinkedListTest::testInsertAfter()
+{
+	xpcc::IntrusiveLinkedList<Item> list;
+	Item a(1), b(2), c(3);
+	
+	list.append(a);
+	list.insertAfter(a, c);
+	TEST_ASSERT_TRUE(list.getBack() == &c);
+	
+	list.insertAfter(a, b);
+	TEST_ASSERT_EQUALS(list.getSize(), 3U);
+	TEST_ASSERT_TRUE(list.getNext(&a) == &b);
+	TEST_ASSERT_TRUE(list.getNext(&b) == &c);
+	TEST_ASSERT_TRUE(list.getBack() == &c);
+}
+
+void
+IntrusiveLinkedListTest::testIterator()
+{
+	xpcc::IntrusiveLinkedList<Item> list;
+	Item items[4] = { 1, 2, 3, 4 };
+	for (Item& item : items) {
+		list.append(item);
+	}
+	
+	int16_t expected = 1;
+	for (Item& item : list) {
+		TEST_ASSERT_EQUALS(item.value, expected);
+		expected++;
+	}
+	TEST_ASSERT_EQUALS(expected, 5);
+	
+	xpcc::IntrusiveLinkedList<Item>::iterator it = list.begin();
+	++it;
+	TEST_ASSERT_EQUALS(it->value, 2);
+	it->value = 20;
+	TEST_ASSERT_EQUALS(items[1].value, 20);
+}
+
+void
+IntrusiveLinkedListTest::testMove()
+{
+	xpcc::IntrusiveLinkedList<Item> list;
+	Item a(1), b(2);
+	list.append(a);
+	list.append(b);
+	
+	xpcc::IntrusiveLinkedList<Item> other(std::move(list));
+	TEST_ASSERT_TRUE(list.isEmpty());
+	TEST_ASSERT_EQUALS(list.getSize(), 0U);
+	TEST_ASSERT_EQUALS(other.getSize(), 2U);
+	TEST_ASSERT_TRUE(other.getFront() == &a);
+	TEST_ASSERT_TRUE(other.getBack() == &b);
+	
+	list = std::move(other);
+	TEST_ASSERT_TRUE(other.isEmpty());
+	TEST_ASSERT_TRUE(list.getFront() == &a);
+	
+	// a copy of an object is not linked
+	Item copy(a);
+	TEST_ASSERT_TRUE(list.getNext(&copy) == nullptr);
+	TEST_ASSERT_TRUE(list.getNext(&a) == &b);
+}
+
+void
+IntrusiveLinkedListTest::testTwoLists()
+{
+	xpcc::IntrusiveLinkedList<TaggedItem> first;
+	xpcc::IntrusiveLinkedList<TaggedItem, Other> second;
+	TaggedItem a, b;
+	a.value = 1;
+	b.value = 2;
+	
+	first.append(a);
+	first.append(b);
+	second.append(b);
+	second.append(a);
+	
+	TEST_ASSERT_TRUE(first.getFront() == &a);
+	TEST_ASSERT_TRUE(first.getNext(&a) == &b);
+	TEST_ASSERT_TRUE(second.getFront() == &b);
+	TEST_ASSERT_TRUE(second.getNext(&b) == &a);
+	
+	TEST_ASSERT_TRUE(second.removeFront() == &b);
+	TEST_ASSERT_TRUE(first.getNext(&a) == &b);
+}
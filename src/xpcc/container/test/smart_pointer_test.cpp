@@ -0,0 +1,121 @@
+// coding: utf-8
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/container/smart_pointer.hpp>
+
+#include "smart_pointer_test.hpp"
+
+namespace
+{
+	struct Data
+	{
+		Data(uint16_t a, uint32_t b) :
+			a(a), b(b)
+		{
+		}
+
+		uint16_t a;
+		uint32_t b;
+	};
+}
+
+void
+SmartPointerTest::testCopy()
+{
+	uint32_t value = 0x12345678;
+	xpcc::SmartPointer pointer(&value);
+	
+	TEST_ASSERT_EQUALS(pointer.getSize(), 4U);
+	TEST_ASSERT_EQUALS(pointer.get<uint32_t>(), 0x12345678U);
+	
+	xpcc::SmartPointer copy(pointer);
+	TEST_ASSERT_TRUE(copy == pointer);
+	TEST_ASSERT_TRUE(copy.getPointer() == pointer.getPointer());
+	
+	xpcc::SmartPointer empty;
+	TEST_ASSERT_EQUALS(empty.getSize(), 0U);
+}
+
+void
+SmartPointerTest::testAssignment()
+{
+	uint16_t value = 0xabcd;
+	xpcc::SmartPointer pointer(&value);
+	xpcc::SmartPointer other;
+	
+	other = pointer;
+	TEST_ASSERT_TRUE(other == pointer);
+	TEST_ASSERT_EQUALS(other.get<uint16_t>(), 0xabcdU);
+	
+	// assigning the last reference to itself must keep the buffer
+	xpcc::SmartPointer single(&value);
+	xpcc::SmartPointer& reference = single;
+	single = reference;
+	TEST_ASSERT_EQUALS(single.getSize(), 2U);
+	TEST_ASSERT_EQUALS(single.get<uint16_t>(), 0xabcdU);
+}
+
+void
+SmartPointerTest::testBufferReuse()
+{
+	const uint8_t *buffer;
+	{
+		xpcc::SmartPointer pointer(uint16_t(10));
+		buffer = pointer.getPointer();
+	}
+	
+	// a released buffer is reused for a payload of the same size class
+	xpcc::SmartPointer pointer(uint16_t(12));
+	TEST_ASSERT_TRUE(pointer.getPointer() == buffer);
+	TEST_ASSERT_EQUALS(pointer.getSize(), 12U);
+	
+	// but not for a payload of a different size class
+	xpcc::SmartPointer other(uint16_t(4));
+	TEST_ASSERT_FALSE(other.getPointer() == buffer);
+}
+
+void
+SmartPointerTest::testLargePayload()
+{
+	xpcc::SmartPointer pointer(uint16_t(2000));
+	TEST_ASSERT_EQUALS(pointer.getSize(), 2000U);
+	
+	for (uint16_t i = 0; i < 2000; ++i) {
+		pointer.getPointer()[i] = i;
+	}
+	
+	xpcc::SmartPointer copy = pointer;
+	TEST_ASSERT_EQUALS(copy.getPointer()[1999], uint8_t(1999));
+}
+
+void
+SmartPointerTest::testCreate()
+{
+	xpcc::SmartPointer pointer = xpcc::SmartPointer::create<Data>(0x1234, 0x56789abc);
+	
+	TEST_ASSERT_EQUALS(pointer.getSize(), sizeof(Data));
+	TEST_ASSERT_EQUALS(pointer.get<Data>().a, 0x1234U);
+	TEST_ASSERT_EQUALS(pointer.get<Data>().b, 0x56789abcU);
+}
+
+void
+SmartPointerTest::testAdopt()
+{
+	uint8_t *buffer = new uint8_t[xpcc::SmartPointer::headerSize + 3];
+	buffer[xpcc::SmartPointer::headerSize + 0] = 'a';
+	buffer[xpcc::SmartPointer::headerSize + 1] = 'b';
+	buffer[xpcc::SmartPointer::headerSize + 2] = 'c';
+	
+	xpcc::SmartPointer pointer = xpcc::SmartPointer::adopt(buffer, 3);
+	
+	// the payload is not copied
+	TEST_ASSERT_TRUE(pointer.getPointer() == buffer + xpcc::SmartPointer::headerSize);
+	TEST_ASSERT_EQUALS(pointer.getSize(), 3U);
+	TEST_ASSERT_EQUALS(pointer.getPointer()[2], 'c');
+}
@@ -0,0 +1,273 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/architecture/detect.hpp>
+
+#include "spsc_queue_test.hpp"
+
+// The queue is only available on hosted targets
+#ifdef XPCC__OS_HOSTED
+
+#include <xpcc/container/spsc_queue.hpp>
+#include <xpcc/container/smart_pointer.hpp>
+
+#include <thread>
+
+#include <poll.h>
+
+#endif
+
+void
+SpscQueueTest::testCapacity()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::SpscQueue<int> queue1(1);
+	TEST_ASSERT_EQUALS(queue1.getCapacity(), 1U);
+	
+	xpcc::SpscQueue<int> queue2(100);
+	TEST_ASSERT_EQUALS(queue2.getCapacity(), 128U);
+	
+	xpcc::SpscQueue<int> queue3(128);
+	TEST_ASSERT_EQUALS(queue3.getCapacity(), 128U);
+#endif
+}
+
+void
+SpscQueueTest::testPushPop()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::SpscQueue<int> queue(4);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+	
+	// wraps around several times
+	for (int i = 0; i < 20; ++i)
+	{
+		TEST_ASSERT_TRUE(queue.push(i));
+		TEST_ASSERT_TRUE(queue.push(i + 100));
+		TEST_ASSERT_FALSE(queue.isEmpty());
+		
+		TEST_ASSERT_EQUALS(queue.getFront(), i);
+		queue.pop();
+		TEST_ASSERT_EQUALS(queue.getFront(), i + 100);
+		queue.pop();
+		TEST_ASSERT_TRUE(queue.isEmpty());
+	}
+	TEST_ASSERT_EQUALS(queue.getOverflows(), 0U);
+#endif
+}
+
+void
+SpscQueueTest::testOverflow()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::SpscQueue<int> queue(4);
+	for (int i = 0; i < 4; ++i) {
+		TEST_ASSERT_TRUE(queue.push(i));
+	}
+	
+	// new elements are dropped
+	TEST_ASSERT_FALSE(queue.push(4));
+	TEST_ASSERT_FALSE(queue.push(5));
+	TEST_ASSERT_EQUALS(queue.getOverflows(), 2U);
+	
+	TEST_ASSERT_EQUALS(queue.getFront(), 0);
+	queue.pop();
+	TEST_ASSERT_TRUE(queue.push(6));
+	
+	for (int i : {1, 2, 3, 6})
+	{
+		TEST_ASSERT_EQUALS(queue.getFront(), i);
+		queue.pop();
+	}
+	TEST_ASSERT_TRUE(queue.isEmpty());
+#endif
+}
+
+void
+SpscQueueTest::testDestruction()
+{
+#ifdef XPCC__OS_HOSTED
+	uint32_t value = 0x12345678;
+	xpcc::SmartPointer payload(&value);
+	{
+		xpcc::SpscQueue<xpcc::SmartPointer> queue(8);
+		queue.push(payload);
+		queue.push(payload);
+		queue.pop();
+		
+		xpcc::SmartPointer copy = payload;
+		TEST_ASSERT_EQUALS(copy.get<uint32_t>(), 0x12345678U);
+	}
+	
+	// all references held by the queue were released
+	TEST_ASSERT_EQUALS(payload.get<uint32_t>(), 0x12345678U);
+#endif
+}
+
+void
+SpscQueueTest::testReserve()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::SpscQueue<xpcc::SmartPointer> queue(2);
+	
+	// the element is only visible after it was committed
+	xpcc::SmartPointer *payload = queue.reserve(uint16_t(4));
+	TEST_ASSERT_TRUE(payload != nullptr);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+	*reinterpret_cast<uint32_t *>(payload->getPointer()) = 0x12345678;
+	queue.commit();
+	
+	TEST_ASSERT_FALSE(queue.isEmpty());
+	TEST_ASSERT_EQUALS(queue.getFront().get<uint32_t>(), 0x12345678U);
+	
+	// a cancelled element takes no slot
+	TEST_ASSERT_TRUE(queue.reserve(uint16_t(4)) != nullptr);
+	queue.cancel();
+	TEST_ASSERT_TRUE(queue.reserve(uint16_t(4)) != nullptr);
+	queue.commit();
+	
+	TEST_ASSERT_TRUE(queue.reserve(uint16_t(4)) == nullptr);
+	TEST_ASSERT_EQUALS(queue.getOverflows(), 1U);
+	
+	queue.pop();
+	queue.pop();
+	TEST_ASSERT_TRUE(queue.isEmpty());
+#endif
+}
+
+void
+SpscQueueTest::testTwoThreads()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::SpscQueue<uint32_t> queue(64);
+	const uint32_t count = 200000;
+	
+	std::thread producer([&queue, count]() {
+		for (uint32_t i = 0; i < count; ++i) {
+			while (!queue.push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	
+	bool inOrder = true;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		while (queue.isEmpty()) {
+			std::this_thread::yield();
+		}
+		if (queue.getFront() != i) {
+			inOrder = false;
+		}
+		queue.pop();
+	}
+	producer.join();
+	
+	TEST_ASSERT_TRUE(inOrder);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+#endif
+}
+
+void
+SpscQueueTest::testWaitForElement()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::SpscQueue<int> queue(4);
+	TEST_ASSERT_FALSE(queue.waitForElement(1));
+	
+	std::thread producer([&queue]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		queue.push(42);
+	});
+	
+	TEST_ASSERT_TRUE(queue.waitForElement(5000));
+	TEST_ASSERT_EQUALS(queue.getFront(), 42);
+	producer.join();
+#endif
+}
+
+void
+SpscQueueTest::testNotification()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::SpscQueue<int> queue(4);
+	
+	struct pollfd descriptor;
+	descriptor.fd = queue.getNotificationDescriptor();
+	descriptor.events = POLLIN;
+	TEST_ASSERT_TRUE(descriptor.fd >= 0);
+	TEST_ASSERT_EQUALS(poll(&descriptor, 1, 0), 0);
+	
+	// only the push into the empty queue is signalled
+	queue.push(1);
+	queue.push(2);
+	TEST_ASSERT_EQUALS(poll(&descriptor, 1, 0), 1);
+	
+	queue.clearNotification();
+	TEST_ASSERT_EQUALS(poll(&descriptor, 1, 0), 0);
+	
+	queue.pop();
+	queue.pop();
+	TEST_ASSERT_TRUE(queue.isEmpty());
+	
+	std::thread producer([&queue]() { queue.push(3); });
+	TEST_ASSERT_EQUALS(poll(&descriptor, 1, 1000), 1);
+	producer.join();
+	TEST_ASSERT_FALSE(queue.isEmpty());
+	TEST_ASSERT_EQUALS(queue.getFront(), 3);
+#endif
+}
+
+void
+SpscQueueTest::testNotificationStress()
+{
+#ifdef XPCC__OS_HOSTED
+	xpcc::SpscQueue<uint32_t> queue(64);
+	const uint32_t count = 200000;
+	
+	struct pollfd descriptor;
+	descriptor.fd = queue.getNotificationDescriptor();
+	descriptor.events = POLLIN;
+	
+	std::thread producer([&queue, count]() {
+		for (uint32_t i = 0; i < count; ++i) {
+			while (!queue.push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	
+	// drain the queue like an event loop, every wakeup must arrive
+	uint32_t received = 0;
+	bool inOrder = true;
+	bool lostWakeup = false;
+	while (received < count)
+	{
+		queue.clearNotification();
+		while (!queue.isEmpty())
+		{
+			if (queue.getFront() != received) {
+				inOrder = false;
+			}
+			queue.pop();
+			received++;
+		}
+		if (received < count and poll(&descriptor, 1, 1000) == 0)
+		{
+			lostWakeup = true;
+			break;
+		}
+	}
+	producer.join();
+	
+	TEST_ASSERT_FALSE(lostWakeup);
+	TEST_ASSERT_TRUE(inOrder);
+	TEST_ASSERT_EQUALS(received, count);
+#endif
+}
@@ -0,0 +1,46 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef SPSC_QUEUE_TEST_HPP
+#define SPSC_QUEUE_TEST_HPP
+
+#include <unittest/testsuite.hpp>
+
+class SpscQueueTest : public unittest::TestSuite
+{
+public:
+	void
+	testCapacity();
+	
+	void
+	testPushPop();
+	
+	void
+	testOverflow();
+	
+	void
+	testDestruction();
+	
+	void
+	testReserve();
+	
+	void
+	testTwoThreads();
+	
+	void
+	testWaitForElement();
+	
+	void
+	testNotification();
+	
+	void
+	testNotificationStress();
+};
+
+#endif // SPSC_QUEUE_TEST_HPP
@@ -0,0 +1,100 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "can_lawicel_parser.hpp"
+#include "can_lawicel_formatter.hpp"
+
+constexpr uint8_t xpcc::CanLawicelParser::maxLineLength;
+
+xpcc::CanLawicelParser::CanLawicelParser() :
+	length(0), overflow(false), invalidLines(0)
+{
+}
+
+void
+xpcc::CanLawicelParser::reset()
+{
+	this->length = 0;
+	this->overflow = false;
+}
+
+xpcc::CanLawicelParser::Result
+xpcc::CanLawicelParser::process(char c)
+{
+	if (c == '\a')
+	{
+		// BEL has no line end
+		this->reset();
+		return Result::Error;
+	}
+
+	if (c == '\r')
+	{
+		Result result = Result::None;
+		if (this->overflow) {
+			this->invalidLines++;
+		}
+		else {
+			result = this->parseLine();
+		}
+		this->reset();
+		return result;
+	}
+
+	if (c == '\n') {
+		// some adapters terminate lines with "\r\n"
+		return Result::None;
+	}
+
+	if (this->length < maxLineLength) {
+		this->line[this->length++] = c;
+	}
+	else {
+		this->overflow = true;
+	}
+	return Result::None;
+}
+
+xpcc::CanLawicelParser::Result
+xpcc::CanLawicelParser::parseLine()
+{
+	if (this->length == 0) {
+		return Result::CommandAck;
+	}
+
+	this->line[this->length] = '\0';
+	switch (this->line[0])
+	{
+		case 'z':
+		case 'Z':
+			return (this->length == 1) ? Result::TransmitAck : Result::None;
+
+		case 't':
+		case 'T':
+		case 'r':
+		case 'R':
+			if (CanLawicelFormatter::convertToCanMessage(this->line, this->message)) {
+				return Result::Message;
+			}
+			// retry without the timestamp
+			if (this->length > 4)
+			{
+				this->line[this->length - 4] = '\0';
+				if (CanLawicelFormatter::convertToCanMessage(this->line, this->message)) {
+					return Result::Message;
+				}
+			}
+			this->invalidLines++;
+			return Result::None;
+
+		default:
+			// replies to status or version requests
+			return Result::None;
+	}
+}
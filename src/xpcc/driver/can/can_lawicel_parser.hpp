@@ -0,0 +1,101 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_CAN_LAWICEL_PARSER_HPP
+#define XPCC_CAN_LAWICEL_PARSER_HPP
+
+#include <stdint.h>
+
+#include <xpcc/architecture/interface/can_message.hpp>
+
+namespace xpcc
+{
+
+/**
+ * Incremental parser for the replies of a Lawicel CAN adapter.
+ *
+ * Characters are fed one at a time as they arrive from the serial port,
+ * no matter how the stream was split up by the reads. Complete lines are
+ * converted with CanLawicelFormatter into a fixed buffer, so the parser
+ * never allocates memory.
+ *
+ * Besides received frames the parser recognizes the replies to the
+ * transmit commands (`z` and `Z`), the reply to other commands (an empty
+ * line) and the error reply (BEL). Received frames may carry the optional
+ * 16-bit timestamp, which is discarded.
+ *
+ * @code
+ * xpcc::CanLawicelParser parser;
+ * char c;
+ * while (port.read(c))
+ * {
+ *     if (parser.process(c) == xpcc::CanLawicelParser::Result::Message) {
+ *         handle(parser.getMessage());
+ *     }
+ * }
+ * @endcode
+ *
+ * @ingroup driver_can
+ * @see http://www.lawicel.com/
+ */
+class CanLawicelParser
+{
+public:
+	enum class
+	Result : uint8_t
+	{
+		None,			///< Line not complete yet or not understood
+		Message,		///< Frame received, see getMessage()
+		TransmitAck,	///< Frame was accepted for transmission
+		CommandAck,		///< Any other command succeeded
+		Error,			///< Last command failed
+	};
+
+	/// `T` + identifier + length + data + timestamp
+	static constexpr uint8_t maxLineLength = 1 + 8 + 1 + 2 * 8 + 4;
+
+public:
+	CanLawicelParser();
+
+	/// Discard the partially received line
+	void
+	reset();
+
+	Result
+	process(char c);
+
+	/// Last received frame, valid after process() returned Result::Message
+	inline const can::Message&
+	getMessage() const
+	{
+		return this->message;
+	}
+
+	/// Number of lines which were too long or couldn't be parsed
+	inline uint32_t
+	getInvalidLines() const
+	{
+		return this->invalidLines;
+	}
+
+private:
+	Result
+	parseLine();
+
+	char line[maxLineLength + 1];
+	uint8_t length;
+	bool overflow;
+
+	uint32_t invalidLines;
+	can::Message message;
+};
+
+}	// namespace xpcc
+
+#endif // XPCC_CAN_LAWICEL_PARSER_HPP
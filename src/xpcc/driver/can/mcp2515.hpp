@@ -142,6 +142,21 @@ namespace xpcc
 		static void
 		setFilter(accessor::Flash<uint8_t> filter);
 
+		/// Six filters in two groups which share one mask each
+		static constexpr uint8_t FilterCount = 6;
+
+		/**
+		 * Set the acceptance filters for extended frames at runtime.
+		 *
+		 * Filters 0 and 1 and filters 2 to 5 share one mask, which is
+		 * the intersection of the masks of the filters in the group.
+		 * The controller may therefore accept more messages than
+		 * requested. An empty list (or one with more than
+		 * \c FilterCount entries) disables the filters.
+		 */
+		static void
+		setFilters(const Filter *filters, uint8_t count);
+
 		static void
 		setMode(Can::Mode mode);
 
@@ -179,6 +194,18 @@ namespace xpcc
             return BusState::Connected;
         }
 
+	private:
+		/// Write 6 filters and 2 masks in the layout used by setFilter()
+		template <typename Iterator>
+		static void
+		writeFilters(Iterator filter, uint8_t rxb0ctrl, uint8_t rxb1ctrl);
+
+		static void
+		encodeExtended(uint8_t *buffer, uint32_t identifier);
+
+		static uint32_t
+		getGroupMask(const Filter *filters, uint8_t count);
+
 	protected:
 		enum SpiCommand
 		{
@@ -16,6 +16,8 @@
 #include "mcp2515_bit_timings.hpp"
 #include "mcp2515_definitions.hpp"
 
+#include <xpcc/math/utils/bit_operation.hpp>
+
 
 #undef	XPCC_LOG_LEVEL
 #define	XPCC_LOG_LEVEL xpcc::log::DISABLED
@@ -129,13 +131,89 @@ xpcc::Mcp2515<SPI, CS, INT>::setFilter(accessor::Flash<uint8_t> filter)
 {
 	using namespace mcp2515;
 
+	writeFilters(filter, BUKT, 0);
+}
+
+template <typename SPI, typename CS, typename INT>
+void
+xpcc::Mcp2515<SPI, CS, INT>::setFilters(const Filter *filters, uint8_t count)
+{
+	using namespace mcp2515;
+
+	uint8_t buffer[4 * (FilterCount + 2)];
+	if (count == 0 or count > FilterCount)
+	{
+		// turn masks and filters off, receive all messages
+		for (uint8_t& byte : buffer) {
+			byte = 0;
+		}
+		writeFilters(static_cast<const uint8_t *>(buffer),
+				RXM1 | RXM0 | BUKT, RXM1 | RXM0);
+		return;
+	}
+
+	// Split the filters into the two groups such that as many mask bits
+	// as possible remain set. Group 0 has room for 2 filters, group 1
+	// for 4.
+	uint8_t group0 = 1;
+	uint8_t best = 0;
+	for (uint8_t n = 1; n <= 2 and n <= count; ++n)
+	{
+		if (count - n > 4) {
+			continue;
+		}
+		uint8_t bits = xpcc::bitCount(getGroupMask(filters, n));
+		if (count > n) {
+			bits += xpcc::bitCount(getGroupMask(filters + n, count - n));
+		}
+		if (bits >= best)
+		{
+			group0 = n;
+			best = bits;
+		}
+	}
+
+	const uint32_t mask0 = getGroupMask(filters, group0);
+	const uint32_t mask1 = (count > group0) ?
+			getGroupMask(filters + group0, count - group0) : mask0;
+
+	// unused slots repeat the first filter of their group
+	for (uint8_t i = 0; i < FilterCount; ++i)
+	{
+		uint32_t identifier;
+		if (i < 2) {
+			identifier = filters[(i < group0) ? i : 0].identifier & mask0;
+		}
+		else if (count > group0) {
+			const uint8_t index = (i - 2 < count - group0) ? i - 2 : 0;
+			identifier = filters[group0 + index].identifier & mask1;
+		}
+		else {
+			identifier = filters[0].identifier & mask1;
+		}
+		encodeExtended(&buffer[4 * i], identifier);
+	}
+	encodeExtended(&buffer[4 * FilterCount], mask0);
+	encodeExtended(&buffer[4 * FilterCount + 4], mask1);
+
+	writeFilters(static_cast<const uint8_t *>(buffer), BUKT, 0);
+}
+
+template <typename SPI, typename CS, typename INT>
+template <typename Iterator>
+void
+xpcc::Mcp2515<SPI, CS, INT>::writeFilters(Iterator filter,
+		uint8_t rxb0ctrl, uint8_t rxb1ctrl)
+{
+	using namespace mcp2515;
+
 	// change to configuration mode
 	bitModify(CANCTRL, 0xe0, REQOP2);
 	while ((readRegister(CANSTAT) & 0xe0) != REQOP2)
 		;
 
-	writeRegister(RXB0CTRL, BUKT);
-	writeRegister(RXB1CTRL, 0);
+	writeRegister(RXB0CTRL, rxb0ctrl);
+	writeRegister(RXB1CTRL, rxb1ctrl);
 
 	uint8_t i, j;
 	for (i = 0; i < 0x30; i += 0x10)
@@ -157,6 +235,29 @@ xpcc::Mcp2515<SPI, CS, INT>::setFilter(accessor::Flash<uint8_t> filter)
 	bitModify(CANCTRL, 0xe0, 0);
 }
 
+template <typename SPI, typename CS, typename INT>
+void
+xpcc::Mcp2515<SPI, CS, INT>::encodeExtended(uint8_t *buffer, uint32_t identifier)
+{
+	// same layout as MCP2515_FILTER_EXTENDED()
+	buffer[0] = identifier >> 21;
+	buffer[1] = ((identifier >> 13) & 0xe0) | (1 << 3) | ((identifier >> 16) & 0x3);
+	buffer[2] = identifier >> 8;
+	buffer[3] = identifier;
+}
+
+template <typename SPI, typename CS, typename INT>
+uint32_t
+xpcc::Mcp2515<SPI, CS, INT>::getGroupMask(const Filter *filters, uint8_t count)
+{
+	// every filter has its own identifier, only the mask is shared
+	uint32_t mask = filters[0].mask;
+	for (uint8_t i = 1; i < count; ++i) {
+		mask &= filters[i].mask;
+	}
+	return mask;
+}
+
 // ----------------------------------------------------------------------------
 template <typename SPI, typename CS, typename INT>
 void
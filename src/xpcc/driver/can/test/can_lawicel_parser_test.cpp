@@ -0,0 +1,149 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../can_lawicel_parser.hpp"
+#include "can_lawicel_parser_test.hpp"
+
+using Result = xpcc::CanLawicelParser::Result;
+
+namespace
+{
+	// Feed a string, returns the result of the last character
+	Result
+	feed(xpcc::CanLawicelParser& parser, const char* str)
+	{
+		Result result = Result::None;
+		while (*str) {
+			result = parser.process(*str++);
+		}
+		return result;
+	}
+}
+
+void
+CanLawicelParserTest::testMessages()
+{
+	xpcc::CanLawicelParser parser;
+
+	TEST_ASSERT_TRUE(feed(parser, "t1232ABCD\r") == Result::Message);
+	TEST_ASSERT_EQUALS(parser.getMessage().getIdentifier(), 0x123U);
+	TEST_ASSERT_FALSE(parser.getMessage().isExtended());
+	TEST_ASSERT_FALSE(parser.getMessage().isRemoteTransmitRequest());
+	TEST_ASSERT_EQUALS(parser.getMessage().getLength(), 2U);
+	TEST_ASSERT_EQUALS(parser.getMessage().data[0], 0xAB);
+	TEST_ASSERT_EQUALS(parser.getMessage().data[1], 0xCD);
+
+	TEST_ASSERT_TRUE(feed(parser, "T1234567880011223344556677\r") == Result::Message);
+	TEST_ASSERT_EQUALS(parser.getMessage().getIdentifier(), 0x12345678U);
+	TEST_ASSERT_TRUE(parser.getMessage().isExtended());
+	TEST_ASSERT_EQUALS(parser.getMessage().getLength(), 8U);
+	TEST_ASSERT_EQUALS(parser.getMessage().data[7], 0x77);
+
+	TEST_ASSERT_TRUE(feed(parser, "R000000015\r") == Result::Message);
+	TEST_ASSERT_EQUALS(parser.getMessage().getIdentifier(), 0x1U);
+	TEST_ASSERT_TRUE(parser.getMessage().isRemoteTransmitRequest());
+	TEST_ASSERT_EQUALS(parser.getMessage().getLength(), 5U);
+
+	TEST_ASSERT_EQUALS(parser.getInvalidLines(), 0U);
+}
+
+void
+CanLawicelParserTest::testStream()
+{
+	xpcc::CanLawicelParser parser;
+
+	const char stream[] = "t1001AA\rt2002BBCC\r\nz\rT000003000\r";
+
+	uint8_t messages = 0;
+	uint8_t acks = 0;
+	for (const char *c = stream; *c; ++c)
+	{
+		Result result = parser.process(*c);
+		if (result == Result::Message)
+		{
+			messages++;
+			TEST_ASSERT_EQUALS(parser.getMessage().getIdentifier(), messages * 0x100U);
+		}
+		else if (result == Result::TransmitAck) {
+			acks++;
+		}
+	}
+	TEST_ASSERT_EQUALS(messages, 3);
+	TEST_ASSERT_EQUALS(acks, 1);
+
+	// the partial line is kept between two reads
+	TEST_ASSERT_TRUE(feed(parser, "t7FF2") == Result::None);
+	TEST_ASSERT_TRUE(feed(parser, "0102\r") == Result::Message);
+	TEST_ASSERT_EQUALS(parser.getMessage().getIdentifier(), 0x7FFU);
+	TEST_ASSERT_EQUALS(parser.getMessage().data[1], 0x02);
+
+	TEST_ASSERT_EQUALS(parser.getInvalidLines(), 0U);
+}
+
+void
+CanLawicelParserTest::testAcknowledgements()
+{
+	xpcc::CanLawicelParser parser;
+
+	TEST_ASSERT_TRUE(parser.process('z') == Result::None);
+	TEST_ASSERT_TRUE(parser.process('\r') == Result::TransmitAck);
+	TEST_ASSERT_TRUE(feed(parser, "Z\r") == Result::TransmitAck);
+	TEST_ASSERT_TRUE(feed(parser, "\r") == Result::CommandAck);
+
+	// BEL has no line end and discards the partial line
+	TEST_ASSERT_TRUE(feed(parser, "t12") == Result::None);
+	TEST_ASSERT_TRUE(parser.process('\a') == Result::Error);
+	TEST_ASSERT_TRUE(feed(parser, "t1000\r") == Result::Message);
+
+	// replies to status and version requests are ignored
+	TEST_ASSERT_TRUE(feed(parser, "F00\r") == Result::None);
+	TEST_ASSERT_TRUE(feed(parser, "V1013\r") == Result::None);
+	TEST_ASSERT_TRUE(feed(parser, "zz\r") == Result::None);
+}
+
+void
+CanLawicelParserTest::testTimestamp()
+{
+	xpcc::CanLawicelParser parser;
+
+	TEST_ASSERT_TRUE(feed(parser, "t1232ABCD1F2E\r") == Result::Message);
+	TEST_ASSERT_EQUALS(parser.getMessage().getIdentifier(), 0x123U);
+	TEST_ASSERT_EQUALS(parser.getMessage().getLength(), 2U);
+	TEST_ASSERT_EQUALS(parser.getMessage().data[1], 0xCD);
+
+	TEST_ASSERT_TRUE(feed(parser, "T12345678800112233445566771F2E\r") == Result::Message);
+	TEST_ASSERT_EQUALS(parser.getMessage().getLength(), 8U);
+	TEST_ASSERT_EQUALS(parser.getMessage().data[7], 0x77);
+
+	TEST_ASSERT_TRUE(feed(parser, "r12341F2E\r") == Result::Message);
+	TEST_ASSERT_TRUE(parser.getMessage().isRemoteTransmitRequest());
+	TEST_ASSERT_EQUALS(parser.getMessage().getLength(), 4U);
+}
+
+void
+CanLawicelParserTest::testInvalidInput()
+{
+	xpcc::CanLawicelParser parser;
+
+	// wrong length
+	TEST_ASSERT_TRUE(feed(parser, "t1232AB\r") == Result::None);
+	// invalid characters
+	TEST_ASSERT_TRUE(feed(parser, "t1232ABXY\r") == Result::None);
+	// identifier too large
+	TEST_ASSERT_TRUE(feed(parser, "t8001AA\r") == Result::None);
+	TEST_ASSERT_EQUALS(parser.getInvalidLines(), 3U);
+
+	// too long lines are dropped completely
+	TEST_ASSERT_TRUE(feed(parser, "T00000001800000000000000000000000000000\r") == Result::None);
+	TEST_ASSERT_EQUALS(parser.getInvalidLines(), 4U);
+
+	// and the parser recovers afterwards
+	TEST_ASSERT_TRUE(feed(parser, "t0011FF\r") == Result::Message);
+	TEST_ASSERT_EQUALS(parser.getMessage().data[0], 0xFF);
+}
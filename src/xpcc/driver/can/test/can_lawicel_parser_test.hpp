@@ -0,0 +1,30 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unittest/testsuite.hpp>
+
+class CanLawicelParserTest : public unittest::TestSuite
+{
+public:
+	void
+	testMessages();
+
+	/// Lines split arbitrarily across several reads
+	void
+	testStream();
+
+	void
+	testAcknowledgements();
+
+	void
+	testTimestamp();
+
+	void
+	testInvalidInput();
+};
@@ -31,6 +31,10 @@
 #ifndef XPCC_ALLOCATOR__BLOCK_HPP
 #define XPCC_ALLOCATOR__BLOCK_HPP
 
+#include <stdint.h>
+#include <xpcc/architecture/interface/assert.hpp>
+#include <xpcc/architecture/interface/memory.hpp>
+
 #include "allocator_base.hpp"
 
 namespace xpcc
@@ -40,12 +44,22 @@ namespace xpcc
 		/**
 		 * \brief	Block allocator
 		 * 
-		 * Allocates a big block of memory and then distribute small pieces of
-		 * it. The memory is not released until the destruction of the
-		 * allocator.
-		 * If more memory is needed a new block is allocated.
+		 * Allocates a big block of memory for \p BLOCKSIZE objects and then
+		 * distribute small pieces of it. Freed pieces are kept in a
+		 * free-list and reused, so allocate() and deallocate() take
+		 * constant time and only every \p BLOCKSIZE-th allocation touches
+		 * the heap. The memory is not released until the destruction of
+		 * the allocator.
+		 * If more memory is needed a new block is allocated, optionally
+		 * from a memory with specific traits:
+		 * \code
+		 * xpcc::allocator::Block<Message, 32> allocator(xpcc::MemoryFastData);
+		 * xpcc::LinkedList<Message, xpcc::allocator::Block<Message, 32> > list(allocator);
+		 * \endcode
 		 * 
-		 * This technique is known as "memory pool".
+		 * This technique is known as "memory pool". Like allocator::Static
+		 * only single objects can be allocated, every copy and every
+		 * rebound allocator has its own pool.
 		 * 
 		 * \ingroup	allocator
 		 * \author	Fabian Greif
@@ -54,6 +68,9 @@ namespace xpcc
 				  std::size_t BLOCKSIZE>
 		class Block : public AllocatorBase<T>
 		{
+			template <typename U, std::size_t S>
+			friend class Block;
+			
 		public:
 			template <typename U>
 			struct rebind
@@ -62,28 +79,98 @@ namespace xpcc
 			};
 		
 		public:
-			Block() :
-				AllocatorBase<T>()
+			Block(MemoryTraits traits = MemoryDefault) :
+				AllocatorBase<T>(), blocks(nullptr), freeList(nullptr),
+				used(BLOCKSIZE), traits(traits)
 			{
 			}
 			
 			Block(const Block& other) :
-				AllocatorBase<T>(other)
+				Block(other.traits)
 			{
 			}
 			
 			template <typename U>
-			Block(const Block<U, BLOCKSIZE>&) :
-				AllocatorBase<T>()
+			Block(const Block<U, BLOCKSIZE>& other) :
+				Block(other.traits)
+			{
+			}
+			
+			~Block()
 			{
+				while (this->blocks != nullptr)
+				{
+					Storage *next = this->blocks->next;
+					::operator delete(this->blocks);
+					this->blocks = next;
+				}
 			}
 			
-			// TODO
+			/// Allocate storage for one object, \p n must be one
 			T*
-			allocate();
+			allocate(std::size_t n = 1)
+			{
+				if (n != 1) {
+					xpcc_assert(false, "allocator", "block", "size", n);
+					return nullptr;
+				}
+				
+				if (this->freeList != nullptr)
+				{
+					Slot *slot = this->freeList;
+					this->freeList = slot->next;
+					return reinterpret_cast<T*>(slot);
+				}
+				
+				if (this->used == BLOCKSIZE)
+				{
+					// operator new reports an exhausted heap itself
+					void *memory = ::operator new(sizeof(Storage), this->traits);
+					if (memory == nullptr) {
+						return nullptr;
+					}
+					Storage *block = static_cast<Storage *>(memory);
+					block->next = this->blocks;
+					this->blocks = block;
+					this->used = 0;
+				}
+				return reinterpret_cast<T*>(&this->blocks->slots[this->used++]);
+			}
 			
 			void
-			deallocate(T*);
+			deallocate(T* p)
+			{
+				if (p != nullptr)
+				{
+					Slot *slot = reinterpret_cast<Slot *>(p);
+					slot->next = this->freeList;
+					this->freeList = slot;
+				}
+			}
+			
+		private:
+			Block&
+			operator = (const Block& other);
+			
+			union Slot
+			{
+				Slot *next;
+				alignas(T) uint8_t storage[sizeof(T)];
+			};
+			
+			struct Storage
+			{
+				Slot slots[BLOCKSIZE];
+				Storage *next;
+			};
+			
+			Storage *blocks;
+			Slot *freeList;
+			
+			/// Slots of the newest block which were never allocated start at this index
+			std::size_t used;
+			
+			MemoryTraits traits;
 		};
 	}
 }
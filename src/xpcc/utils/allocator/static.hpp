@@ -31,6 +31,9 @@
 #ifndef XPCC_ALLOCATOR__STATIC_HPP
 #define XPCC_ALLOCATOR__STATIC_HPP
 
+#include <stdint.h>
+#include <xpcc/architecture/interface/assert.hpp>
+
 #include "allocator_base.hpp"
 
 namespace xpcc
@@ -40,8 +43,24 @@ namespace xpcc
 		/**
 		 * \brief	Static memory allocator
 		 * 
-		 * Allocates a big static block and distributes pieces of it during
-		 * run-time. No reallocation is done when no more pieces are available.
+		 * Holds the storage for \p N objects inside the allocator itself
+		 * and distributes them during run-time. Freed objects are kept in
+		 * a free-list, so allocate() and deallocate() take constant time
+		 * and never touch the heap. No reallocation is done when no more
+		 * pieces are available.
+		 * 
+		 * Only single objects can be allocated, which is enough for the
+		 * node based containers:
+		 * \code
+		 * xpcc::LinkedList<Message, xpcc::allocator::Static<Message, 16> > list;
+		 * \endcode
+		 * 
+		 * Every copy and every rebound allocator has its own storage.
+		 * 
+		 * When all pieces are used the assertion
+		 * `"allocator", "static", "exhausted"` with \p N as context fails.
+		 * If the assertion is ignored, allocate() returns \c nullptr and
+		 * the containers refuse to add the element.
 		 * 
 		 * \ingroup	allocator
 		 * \author	Fabian Greif
@@ -59,30 +78,89 @@ namespace xpcc
 			
 		public:
 			Static() :
-				AllocatorBase<T>()
+				AllocatorBase<T>(), freeList(nullptr), used(0), allocated(0)
 			{
 			}
 			
-			Static(const Static& other) :
-				AllocatorBase<T>(other)
+			Static(const Static&) :
+				Static()
 			{
 			}
 			
 			template <typename U>
 			Static(const Static<U, N>&) :
-				AllocatorBase<T>()
+				Static()
 			{
 			}
 			
-			// TODO
+			/// Allocate storage for one object, \p n must be one
 			T*
-			allocate(std::size_t other);
+			allocate(std::size_t n = 1)
+			{
+				Slot *slot = nullptr;
+				if (n == 1)
+				{
+					if (this->freeList != nullptr)
+					{
+						slot = this->freeList;
+						this->freeList = slot->next;
+					}
+					else if (this->used < N) {
+						slot = &this->slots[this->used++];
+					}
+				}
+				
+				if (slot == nullptr) {
+					xpcc_assert(false, "allocator", "static", "exhausted", N);
+					return nullptr;
+				}
+				this->allocated++;
+				return reinterpret_cast<T*>(slot);
+			}
 			
 			void
-			deallocate(T*);
+			deallocate(T* p)
+			{
+				if (p != nullptr)
+				{
+					Slot *slot = reinterpret_cast<Slot *>(p);
+					slot->next = this->freeList;
+					this->freeList = slot;
+					this->allocated--;
+				}
+			}
+			
+			/// Number of objects which can be allocated
+			static constexpr std::size_t
+			getCapacity()
+			{
+				return N;
+			}
+			
+			/// Number of objects currently allocated
+			inline std::size_t
+			getSize() const
+			{
+				return this->allocated;
+			}
 			
 		private:
-			T memory[N];
+			Static&
+			operator = (const Static& other);
+			
+			union Slot
+			{
+				Slot *next;
+				alignas(T) uint8_t storage[sizeof(T)];
+			};
+			
+			Slot *freeList;
+			
+			/// Slots which were never allocated start at this index
+			std::size_t used;
+			std::size_t allocated;
+			
+			Slot slots[N];
 		};
 	}
 }
@@ -0,0 +1,197 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/utils/allocator.hpp>
+#include <xpcc/container/linked_list.hpp>
+#include <xpcc/container/doubly_linked_list.hpp>
+
+#include "allocator_test.hpp"
+
+static bool expecting_exhaustion(false);
+static uint8_t exhaustion_count(0);
+
+static xpcc::Abandonment
+allocator_test_handler(const char * module,
+					   const char * location,
+					   const char * failure,
+					   uintptr_t)
+{
+	if (expecting_exhaustion) {
+		TEST_ASSERT_EQUALS_STRING(module, "allocator");
+		TEST_ASSERT_EQUALS_STRING(location, "static");
+		TEST_ASSERT_EQUALS_STRING(failure, "exhausted");
+		exhaustion_count++;
+		return xpcc::Abandonment::Ignore;
+	}
+	return xpcc::Abandonment::DontCare;
+}
+XPCC_ASSERTION_HANDLER(allocator_test_handler);
+
+namespace
+{
+	struct Object
+	{
+		uint32_t a;
+		uint8_t b;
+	};
+}
+
+void
+AllocatorTest::testStaticAllocate()
+{
+	xpcc::allocator::Static<Object, 3> allocator;
+	TEST_ASSERT_EQUALS(allocator.getCapacity(), 3U);
+	TEST_ASSERT_EQUALS(allocator.getSize(), 0U);
+	
+	Object *a = allocator.allocate(1);
+	Object *b = allocator.allocate(1);
+	Object *c = allocator.allocate(1);
+	TEST_ASSERT_TRUE(a != b and b != c and a != c);
+	TEST_ASSERT_EQUALS(allocator.getSize(), 3U);
+	
+	// the storage is part of the allocator
+	const uint8_t *begin = reinterpret_cast<const uint8_t *>(&allocator);
+	const uint8_t *end = begin + sizeof(allocator);
+	Object *objects[] = { a, b, c };
+	for (Object *object : objects)
+	{
+		const uint8_t *p = reinterpret_cast<const uint8_t *>(object);
+		TEST_ASSERT_TRUE(p >= begin and p + sizeof(Object) <= end);
+		TEST_ASSERT_EQUALS(reinterpret_cast<uintptr_t>(object) % alignof(Object), 0U);
+	}
+	
+	// freed objects are reused first
+	allocator.deallocate(b);
+	allocator.deallocate(a);
+	TEST_ASSERT_EQUALS(allocator.getSize(), 1U);
+	TEST_ASSERT_TRUE(allocator.allocate(1) == a);
+	TEST_ASSERT_TRUE(allocator.allocate(1) == b);
+	
+	allocator.deallocate(nullptr);
+	TEST_ASSERT_EQUALS(allocator.getSize(), 3U);
+}
+
+void
+AllocatorTest::testStaticExhausted()
+{
+	xpcc::allocator::Static<Object, 2> allocator;
+	allocator.allocate(1);
+	Object *b = allocator.allocate(1);
+	
+	expecting_exhaustion = true;
+	exhaustion_count = 0;
+	TEST_ASSERT_TRUE(allocator.allocate(1) == nullptr);
+	TEST_ASSERT_EQUALS(exhaustion_count, 1U);
+	
+	allocator.deallocate(b);
+	TEST_ASSERT_TRUE(allocator.allocate(2) == nullptr);
+	TEST_ASSERT_EQUALS(exhaustion_count, 2U);
+	expecting_exhaustion = false;
+	
+	TEST_ASSERT_TRUE(allocator.allocate(1) == b);
+}
+
+void
+AllocatorTest::testStaticLinkedList()
+{
+	xpcc::LinkedList<int16_t, xpcc::allocator::Static<int16_t, 3> > list;
+	
+	TEST_ASSERT_TRUE(list.append(1));
+	TEST_ASSERT_TRUE(list.append(2));
+	TEST_ASSERT_TRUE(list.prepend(3));
+	
+	expecting_exhaustion = true;
+	exhaustion_count = 0;
+	TEST_ASSERT_FALSE(list.append(4));
+	TEST_ASSERT_FALSE(list.prepend(5));
+	TEST_ASSERT_EQUALS(exhaustion_count, 2U);
+	expecting_exhaustion = false;
+	
+	TEST_ASSERT_EQUALS(list.getSize(), 3U);
+	TEST_ASSERT_EQUALS(list.getFront(), 3);
+	TEST_ASSERT_EQUALS(list.getBack(), 2);
+	
+	list.removeFront();
+	TEST_ASSERT_TRUE(list.append(6));
+	TEST_ASSERT_EQUALS(list.getSize(), 3U);
+	TEST_ASSERT_EQUALS(list.getFront(), 1);
+	TEST_ASSERT_EQUALS(list.getBack(), 6);
+}
+
+void
+AllocatorTest::testStaticDoublyLinkedList()
+{
+	xpcc::DoublyLinkedList<int16_t, xpcc::allocator::Static<int16_t, 2> > list;
+	
+	TEST_ASSERT_TRUE(list.append(1));
+	TEST_ASSERT_TRUE(list.prepend(2));
+	
+	expecting_exhaustion = true;
+	exhaustion_count = 0;
+	TEST_ASSERT_FALSE(list.append(3));
+	TEST_ASSERT_FALSE(list.prepend(4));
+	TEST_ASSERT_EQUALS(exhaustion_count, 2U);
+	expecting_exhaustion = false;
+	
+	TEST_ASSERT_EQUALS(list.getSize(), 2U);
+	TEST_ASSERT_EQUALS(list.getFront(), 2);
+	TEST_ASSERT_EQUALS(list.getBack(), 1);
+}
+
+void
+AllocatorTest::testBlockAllocate()
+{
+	xpcc::allocator::Block<Object, 4> allocator;
+	
+	Object *objects[9];
+	for (Object *& object : objects) {
+		object = allocator.allocate(1);
+		TEST_ASSERT_TRUE(object != nullptr);
+		object->a = 0x12345678;
+	}
+	for (uint8_t i = 0; i < 9; ++i) {
+		for (uint8_t k = i + 1; k < 9; ++k) {
+			TEST_ASSERT_TRUE(objects[i] != objects[k]);
+		}
+	}
+	
+	// pieces are reused instead of allocating a new block
+	allocator.deallocate(objects[2]);
+	allocator.deallocate(objects[7]);
+	TEST_ASSERT_TRUE(allocator.allocate(1) == objects[7]);
+	TEST_ASSERT_TRUE(allocator.allocate(1) == objects[2]);
+	
+	// rebound copies have their own pool
+	xpcc::allocator::Block<uint64_t, 4> other(allocator);
+	uint64_t *value = other.allocate(1);
+	*value = 1;
+	other.deallocate(value);
+}
+
+void
+AllocatorTest::testBlockDoublyLinkedList()
+{
+	xpcc::DoublyLinkedList<int16_t, xpcc::allocator::Block<int16_t, 2> > list;
+	
+	for (int16_t i = 0; i < 10; ++i) {
+		list.append(i);
+	}
+	TEST_ASSERT_EQUALS(list.getSize(), 10U);
+	
+	for (int16_t i = 0; i < 5; ++i) {
+		TEST_ASSERT_EQUALS(list.getFront(), i);
+		list.removeFront();
+	}
+	for (int16_t i = 0; i < 5; ++i) {
+		list.prepend(-i);
+	}
+	TEST_ASSERT_EQUALS(list.getSize(), 10U);
+	TEST_ASSERT_EQUALS(list.getFront(), -4);
+	TEST_ASSERT_EQUALS(list.getBack(), 9);
+}
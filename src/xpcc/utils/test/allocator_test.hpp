@@ -0,0 +1,32 @@
+// coding: utf-8
+/* Copyright (c) 2017, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unittest/testsuite.hpp>
+
+class AllocatorTest : public unittest::TestSuite
+{
+public:
+	void
+	testStaticAllocate();
+	
+	void
+	testStaticExhausted();
+	
+	void
+	testStaticLinkedList();
+	
+	void
+	testStaticDoublyLinkedList();
+	
+	void
+	testBlockAllocate();
+	
+	void
+	testBlockDoublyLinkedList();
+};
@@ -133,6 +133,27 @@ Postman::isComponentAvailable(uint8_t component) const
 	}
 }
 
+bool
+Postman::isEventSubscribed(uint8_t event) const
+{
+{%- if container.events.subscribe %}
+	switch (event)
+	{
+	{%- for event in container.events.subscribe %}
+		case {{ namespace }}::event::{{ event.name | CAMELCASE }}:
+	{%- endfor %}
+			return true;
+			break;
+
+		default:
+			return false;
+	}
+{%- else %}
+	(void) event;
+	return false;
+{%- endif %}
+}
+
 void
 Postman::update()
 {
@@ -21,6 +21,9 @@ public:
 	bool
 	isComponentAvailable(uint8_t component) const;
 
+	bool
+	isEventSubscribed(uint8_t event) const;
+
 	void
 	update();
 